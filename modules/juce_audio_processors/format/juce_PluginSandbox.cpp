@@ -0,0 +1,1800 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+// Requests such as loading a plugin are sent as messages through a
+// ChildProcessCoordinator. Each request starts with an ID, and the worker sends back
+// a reply that starts with the same ID. Requests are handled on the worker's message
+// thread, which is where most plugins expect to be called. A request for an instance
+// also carries any parameter changes that haven't been sent yet, as blocks of audio
+// may not be arriving to take them.
+//
+// Audio goes through a separate SharedMemoryPipe, as batches of blocks. The host sends
+// a batch containing a block for each of one or more instances, and the worker's audio
+// thread processes them in turn and sends back a batch of the results, in the same
+// order and with the same batch number. In a batch, each block is preceded by its size,
+// and a block is a BlockHeader, followed by the audio channels, then any parameter
+// changes, then the MIDI events.
+namespace PluginSandboxHelpers
+{
+    static const char* const commandLineUniqueID = "jucePluginSandbox";
+
+    enum class Request
+    {
+        openAudioPipe,
+        createInstance,
+        deleteInstance,
+        prepareToPlay,
+        releaseResources,
+        reset,
+        setNonRealtime,
+        getState,
+        setState,
+        setCurrentProgram,
+        changeProgramName,
+        getParameterText,
+        getParameterValueForText,
+        findAllTypesForFile
+    };
+
+    //==============================================================================
+    static void writeValue (MemoryOutputStream& out, int v)                  { out.writeInt (v); }
+    static void writeValue (MemoryOutputStream& out, uint32 v)               { out.writeInt ((int) v); }
+    static void writeValue (MemoryOutputStream& out, bool v)                 { out.writeBool (v); }
+    static void writeValue (MemoryOutputStream& out, float v)                { out.writeFloat (v); }
+    static void writeValue (MemoryOutputStream& out, double v)               { out.writeDouble (v); }
+    static void writeValue (MemoryOutputStream& out, const String& v)        { out.writeString (v); }
+
+    static void writeValue (MemoryOutputStream& out, const MemoryBlock& v)
+    {
+        out.writeInt ((int) v.getSize());
+        out << v;
+    }
+
+    static MemoryBlock readMemoryBlock (InputStream& in)
+    {
+        MemoryBlock result;
+        const auto size = in.readInt();
+
+        if (size > 0 && size <= in.getNumBytesRemaining())
+            in.readIntoMemoryBlock (result, size);
+
+        return result;
+    }
+
+    static void writeChannelSet (MemoryOutputStream& out, const AudioChannelSet& set)
+    {
+        const auto types = set.getChannelTypes();
+        out.writeInt (types.size());
+
+        for (auto type : types)
+            out.writeInt ((int) type);
+    }
+
+    static AudioChannelSet readChannelSet (InputStream& in)
+    {
+        Array<AudioChannelSet::ChannelType> types;
+
+        for (auto i = jmin (in.readInt(), 256); --i >= 0;)
+            types.add ((AudioChannelSet::ChannelType) in.readInt());
+
+        return AudioChannelSet::channelSetWithChannels (types);
+    }
+
+    //==============================================================================
+    struct BlockHeader
+    {
+        uint32 instanceID, batchNumber;
+        int32 numChannels, numSamples, numParameterChanges, numMidiEvents, midiDataSize, latencySamples;
+    };
+
+    struct ParameterChange
+    {
+        int32 index;
+        float value;
+    };
+
+    struct MidiEventHeader
+    {
+        int32 samplePosition, numBytes;
+    };
+
+    static void writeValue (MemoryOutputStream& out, const std::vector<ParameterChange>& v)
+    {
+        out.writeInt ((int) v.size());
+
+        for (const auto& change : v)
+        {
+            out.writeInt (change.index);
+            out.writeFloat (change.value);
+        }
+    }
+
+    static std::vector<ParameterChange> readParameterChanges (InputStream& in)
+    {
+        std::vector<ParameterChange> result;
+
+        for (auto i = in.readInt(); --i >= 0 && ! in.isExhausted();)
+        {
+            const auto index = in.readInt();
+            result.push_back ({ index, in.readFloat() });
+        }
+
+        return result;
+    }
+
+    static size_t getBlockSize (const BlockHeader& h) noexcept
+    {
+        return sizeof (BlockHeader)
+                + (size_t) h.numChannels * (size_t) h.numSamples * sizeof (float)
+                + (size_t) h.numParameterChanges * sizeof (ParameterChange)
+                + (size_t) h.numMidiEvents * sizeof (MidiEventHeader)
+                + (size_t) h.midiDataSize;
+    }
+
+    // Adds a block to the end of a batch that's being written into the given memory, which
+    // is only resized if it's too small, and returns the new size of the batch.
+    static size_t appendBlock (MemoryBlock& dest, size_t batchSize, BlockHeader header, const AudioBuffer<float>& audio,
+                               const std::vector<ParameterChange>& parameterChanges, const MidiBuffer& midi)
+    {
+        header.numParameterChanges = (int32) parameterChanges.size();
+        header.numMidiEvents = 0;
+        header.midiDataSize = 0;
+
+        for (const auto metadata : midi)
+        {
+            ++header.numMidiEvents;
+            header.midiDataSize += metadata.numBytes;
+        }
+
+        const auto blockSize = getBlockSize (header);
+        const auto newBatchSize = batchSize + sizeof (uint32) + blockSize;
+
+        if (dest.getSize() < newBatchSize)
+            dest.setSize (newBatchSize);
+
+        auto* d = static_cast<char*> (dest.getData()) + batchSize;
+        writeUnaligned (d, (uint32) blockSize);
+        d += sizeof (uint32);
+
+        memcpy (d, &header, sizeof (header));
+        d += sizeof (header);
+
+        for (int i = 0; i < header.numChannels; ++i)
+        {
+            memcpy (d, audio.getReadPointer (i), (size_t) header.numSamples * sizeof (float));
+            d += (size_t) header.numSamples * sizeof (float);
+        }
+
+        if (! parameterChanges.empty())
+            memcpy (d, parameterChanges.data(), parameterChanges.size() * sizeof (ParameterChange));
+
+        d += parameterChanges.size() * sizeof (ParameterChange);
+
+        for (const auto metadata : midi)
+        {
+            const MidiEventHeader event { metadata.samplePosition, metadata.numBytes };
+            memcpy (d, &event, sizeof (event));
+            memcpy (d + sizeof (event), metadata.data, (size_t) metadata.numBytes);
+            d += sizeof (event) + (size_t) metadata.numBytes;
+        }
+
+        return newBatchSize;
+    }
+
+    // Gives access to a block that's been received, without copying it.
+    struct BlockView
+    {
+        static std::optional<BlockView> parse (Span<const std::byte> data)
+        {
+            BlockView view;
+
+            if (data.size() < sizeof (BlockHeader))
+                return {};
+
+            memcpy (&view.header, data.data(), sizeof (BlockHeader));
+            const auto& h = view.header;
+
+            if (h.numChannels < 0 || h.numChannels > 1024 || h.numSamples < 0 || h.numParameterChanges < 0
+                 || h.numMidiEvents < 0 || h.midiDataSize < 0 || getBlockSize (h) != data.size())
+                return {};
+
+            view.audio = reinterpret_cast<const char*> (data.data()) + sizeof (BlockHeader);
+            view.parameterChanges = view.audio + (size_t) h.numChannels * (size_t) h.numSamples * sizeof (float);
+            view.midi = view.parameterChanges + (size_t) h.numParameterChanges * sizeof (ParameterChange);
+            view.end = reinterpret_cast<const char*> (data.data()) + data.size();
+            return view;
+        }
+
+        void copyAudioTo (AudioBuffer<float>& buffer) const
+        {
+            const auto numChannels = jmin ((int) header.numChannels, buffer.getNumChannels());
+            const auto numSamples = jmin ((int) header.numSamples, buffer.getNumSamples());
+
+            for (int i = 0; i < numChannels; ++i)
+                memcpy (buffer.getWritePointer (i), audio + (size_t) i * (size_t) header.numSamples * sizeof (float),
+                        (size_t) numSamples * sizeof (float));
+
+            for (int i = numChannels; i < buffer.getNumChannels(); ++i)
+                buffer.clear (i, 0, numSamples);
+        }
+
+        template <typename Callback>
+        void forEachParameterChange (Callback&& callback) const
+        {
+            for (int i = 0; i < header.numParameterChanges; ++i)
+                callback (readUnaligned<ParameterChange> (parameterChanges + (size_t) i * sizeof (ParameterChange)));
+        }
+
+        void copyMidiTo (MidiBuffer& dest) const
+        {
+            dest.clear();
+
+            for (auto* d = midi; d + sizeof (MidiEventHeader) <= end;)
+            {
+                const auto event = readUnaligned<MidiEventHeader> (d);
+                d += sizeof (MidiEventHeader);
+
+                if (event.numBytes < 0 || event.numBytes > end - d)
+                    break;
+
+                dest.addEvent (d, event.numBytes, event.samplePosition);
+                d += event.numBytes;
+            }
+        }
+
+        BlockHeader header;
+        const char* audio = nullptr;
+        const char* parameterChanges = nullptr;
+        const char* midi = nullptr;
+        const char* end = nullptr;
+    };
+
+    // Passes each block in a batch to the callback, and returns false if the batch
+    // turns out to be corrupt.
+    template <typename Callback>
+    static bool forEachBlockInBatch (Span<const std::byte> batch, Callback&& callback)
+    {
+        for (size_t pos = 0; pos < batch.size();)
+        {
+            if (batch.size() - pos < sizeof (uint32))
+                return false;
+
+            const auto blockSize = (size_t) readUnaligned<uint32> (batch.data() + pos);
+            pos += sizeof (uint32);
+
+            if (blockSize > batch.size() - pos)
+                return false;
+
+            const auto block = BlockView::parse ({ batch.data() + pos, blockSize });
+
+            if (! block.has_value())
+                return false;
+
+            callback (*block);
+            pos += blockSize;
+        }
+
+        return true;
+    }
+}
+
+//==============================================================================
+class PluginSandbox::Pimpl final : private ChildProcessCoordinator
+{
+public:
+    using Request = PluginSandboxHelpers::Request;
+
+    Pimpl() = default;
+
+    ~Pimpl() override
+    {
+        kill();
+    }
+
+    bool launch (const File& executable, int audioBufferSizeBytes)
+    {
+        kill();
+
+        setSharedMemoryBufferSize (1 << 16);
+
+        const auto pipeName = "a" + String::toHexString (Random().nextInt64());
+
+        // The audio pipe is created first, so that a worker isn't started for nothing on
+        // systems where shared memory isn't available
+        {
+            const ScopedLock sl (audioLock);
+            outstandingBatchNumber = 0;
+
+            if (! audioPipe.createNewPipe (pipeName, audioBufferSizeBytes, true))
+            {
+                DBG ("PluginSandbox couldn't create the shared memory for passing audio to its worker");
+                return false;
+            }
+        }
+
+        if (! launchWorkerProcess (executable, PluginSandboxHelpers::commandLineUniqueID, 0, 0))
+        {
+            kill();
+            return false;
+        }
+
+        workerRunning = true;
+
+        if (auto reply = call (Request::openAudioPipe, pipeName))
+            if (MemoryInputStream (*reply, false).readBool())
+                return true;
+
+        kill();
+        return false;
+    }
+
+    void kill()
+    {
+        workerRunning = false;
+        audioPipe.close();
+        killWorkerProcess();
+        cancelPendingRequests();
+    }
+
+    bool isWorkerRunning() const
+    {
+        return workerRunning && audioPipe.isOpen();
+    }
+
+    void setWorkerLostCallback (std::function<void()> callback)
+    {
+        const ScopedLock sl (callbackLock);
+        onWorkerLost = std::move (callback);
+    }
+
+    uint32 createInstanceID() noexcept          { return (uint32) ++lastInstanceID; }
+    void setProcessTimeout (int ms) noexcept    { processTimeoutMs = ms; }
+    void setRequestTimeout (int ms) noexcept    { requestTimeoutMs = ms; }
+
+    //==============================================================================
+    // Sends a request to the worker and waits for its reply, returning nothing if
+    // the worker isn't running or doesn't reply in time.
+    template <typename... Args>
+    std::optional<MemoryBlock> call (Request request, const Args&... args)
+    {
+        if (! workerRunning)
+            return {};
+
+        PendingRequest pending;
+        const auto requestID = ++lastRequestID;
+
+        {
+            const ScopedLock sl (pendingLock);
+            pendingRequests[requestID] = &pending;
+        }
+
+        MemoryOutputStream out;
+        out.writeInt (requestID);
+        out.writeInt ((int) request);
+        (PluginSandboxHelpers::writeValue (out, args), ...);
+
+        if (sendMessageToWorker (out.getMemoryBlock()))
+            pending.finished.wait (requestTimeoutMs);
+
+        const ScopedLock sl (pendingLock);
+        pendingRequests.erase (requestID);
+
+        if (! pending.replied)
+            return {};
+
+        return std::move (pending.reply);
+    }
+
+    //==============================================================================
+    // Sends a batch of blocks to the worker, and waits for it to come back. The first
+    // callback appends the blocks to the batch (using the batch number it's given) and
+    // returns its new size, and if the batch comes back in time, the second callback is
+    // given each processed block along with its position in the batch.
+    template <typename WriteBlocks, typename HandleBlock>
+    bool processBatch (int timeoutMs, WriteBlocks&& writeBlocks, HandleBlock&& handleProcessedBlock)
+    {
+        using namespace PluginSandboxHelpers;
+
+        const ScopedLock sl (audioLock);
+
+        // If an earlier batch timed out, the worker's probably still busy with it, so
+        // rather than making the audio thread wait again, only check whether it's finished.
+        while (outstandingBatchNumber != 0)
+            if (audioPipe.read ([this] (Span<const std::byte> data) { checkForOutstandingBatch (data); }, 0)
+                  != SharedMemoryPipe::ReadResult::messageRead)
+                return false;
+
+        const auto batchNumber = ++lastBatchNumber;
+        const auto size = writeBlocks (batchScratch, batchNumber);
+
+        if (! audioPipe.write (batchScratch.getData(), size, timeoutMs))
+            return false;
+
+        const auto startTime = Time::getMillisecondCounter();
+        bool processed = false;
+
+        while (! processed)
+        {
+            const auto remainingMs = timeoutMs - (int) (Time::getMillisecondCounter() - startTime);
+
+            const auto result = audioPipe.read ([&processed, &handleProcessedBlock, batchNumber] (Span<const std::byte> data)
+            {
+                int index = 0;
+
+                forEachBlockInBatch (data, [&] (const BlockView& block)
+                {
+                    if (block.header.batchNumber == batchNumber)
+                    {
+                        handleProcessedBlock (index++, block);
+                        processed = true;
+                    }
+                });
+            }, jmax (0, remainingMs));
+
+            if (result != SharedMemoryPipe::ReadResult::messageRead)
+            {
+                outstandingBatchNumber = batchNumber;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Unless a timeout has been set, the audio thread waits for at most half the length of
+    // a block, so that a stalled worker leaves enough time to output silence instead.
+    int getProcessTimeout (int numSamples, double sampleRate, bool isNonRealtime) const noexcept
+    {
+        if (isNonRealtime)
+            return requestTimeoutMs;
+
+        if (const auto timeoutMs = processTimeoutMs.load(); timeoutMs >= 0)
+            return timeoutMs;
+
+        return sampleRate > 0 ? jmax (1, roundToInt (numSamples * 500.0 / sampleRate)) : 100;
+    }
+
+    // The memory that batches are written into is allocated when the instances are
+    // prepared, so that it doesn't need to be resized on the audio thread.
+    void setMaximumBlockSize (uint32 instanceID, size_t numBytes)
+    {
+        const ScopedLock sl (audioLock);
+
+        if (numBytes > 0)
+            maximumBlockSizes[instanceID] = numBytes;
+        else
+            maximumBlockSizes.erase (instanceID);
+
+        size_t total = 0;
+
+        for (const auto& size : maximumBlockSizes)
+            total += sizeof (uint32) + size.second;
+
+        batchScratch.ensureSize (total);
+    }
+
+private:
+    //==============================================================================
+    struct PendingRequest
+    {
+        WaitableEvent finished;
+        MemoryBlock reply;
+        bool replied = false;
+    };
+
+    SharedMemoryPipe audioPipe;
+    MemoryBlock batchScratch;
+    std::map<uint32, size_t> maximumBlockSizes;
+    CriticalSection audioLock, pendingLock, callbackLock;
+    std::map<int, PendingRequest*> pendingRequests;
+    std::function<void()> onWorkerLost;
+    std::atomic<bool> workerRunning { false };
+    std::atomic<int> lastRequestID { 0 }, lastInstanceID { 0 }, processTimeoutMs { -1 }, requestTimeoutMs { 10000 };
+    uint32 lastBatchNumber = 0, outstandingBatchNumber = 0;
+
+    void checkForOutstandingBatch (Span<const std::byte> data)
+    {
+        PluginSandboxHelpers::forEachBlockInBatch (data, [this] (const PluginSandboxHelpers::BlockView& block)
+        {
+            if (block.header.batchNumber == outstandingBatchNumber)
+                outstandingBatchNumber = 0;
+        });
+    }
+
+    void cancelPendingRequests()
+    {
+        const ScopedLock sl (pendingLock);
+
+        for (auto& pending : pendingRequests)
+            pending.second->finished.signal();
+    }
+
+    void handleMessageFromWorker (const MemoryBlock& message) override
+    {
+        MemoryInputStream in (message, false);
+        const auto requestID = in.readInt();
+
+        const ScopedLock sl (pendingLock);
+        const auto iter = pendingRequests.find (requestID);
+
+        if (iter != pendingRequests.end())
+        {
+            auto& pending = *iter->second;
+            pending.reply.replaceAll (addBytesToPointer (message.getData(), sizeof (int)), message.getSize() - sizeof (int));
+            pending.replied = true;
+            pending.finished.signal();
+        }
+    }
+
+    void handleConnectionLost() override
+    {
+        if (! workerRunning.exchange (false))
+            return;
+
+        audioPipe.close();
+        cancelPendingRequests();
+
+        const ScopedLock sl (callbackLock);
+
+        if (onWorkerLost != nullptr)
+            onWorkerLost();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+//==============================================================================
+// The host's stand-in for a plugin that's running in the worker process.
+class PluginSandbox::Instance final : public AudioPluginInstance
+{
+public:
+    using Request = PluginSandboxHelpers::Request;
+
+    static std::unique_ptr<AudioPluginInstance> create (std::shared_ptr<Pimpl> sandbox, const PluginDescription& description,
+                                                        double sampleRate, int blockSize, String& errorMessage)
+    {
+        const auto instanceID = sandbox->createInstanceID();
+        const auto reply = sandbox->call (Request::createInstance, instanceID, description.createXml()->toString(),
+                                          sampleRate, blockSize);
+
+        if (! reply.has_value())
+        {
+            errorMessage = NEEDS_TRANS ("The plug-in sandbox isn't responding");
+            return {};
+        }
+
+        MemoryInputStream in (*reply, false);
+
+        if (! in.readBool())
+        {
+            errorMessage = in.readString();
+            return {};
+        }
+
+        PluginDescription actualDescription;
+
+        if (auto xml = parseXML (in.readString()))
+            actualDescription.loadFromXml (*xml);
+
+        BusesProperties buses;
+
+        for (const auto isInput : { true, false })
+        {
+            for (auto i = in.readInt(); --i >= 0;)
+            {
+                const auto name = in.readString();
+                const auto layout = PluginSandboxHelpers::readChannelSet (in);
+                buses.addBus (isInput, name, layout, in.readBool());
+            }
+        }
+
+        return std::unique_ptr<AudioPluginInstance> (new Instance (std::move (sandbox), instanceID,
+                                                                   actualDescription, buses, in));
+    }
+
+    ~Instance() override
+    {
+        sandbox->setMaximumBlockSize (instanceID, 0);
+        call (Request::deleteInstance);
+    }
+
+    //==============================================================================
+    // Processes a block for each of the given instances in a single round trip to the
+    // worker. If an instance's block can't be processed, it's replaced with silence.
+    static void processBlocks (Pimpl& sandbox, Span<const BlockToProcess> blocks)
+    {
+        if (blocks.empty())
+            return;
+
+        const auto& first = blocks.front();
+        auto& firstInstance = static_cast<Instance&> (first.instance);
+        const auto timeoutMs = sandbox.getProcessTimeout (first.buffer.getNumSamples(), firstInstance.getSampleRate(),
+                                                          firstInstance.isNonRealtime());
+
+        sandbox.processBatch (timeoutMs,
+                              [blocks] (MemoryBlock& dest, uint32 batchNumber)
+                              {
+                                  size_t batchSize = 0;
+
+                                  for (const auto& b : blocks)
+                                      batchSize = static_cast<Instance&> (b.instance).appendBlock (dest, batchSize, batchNumber,
+                                                                                                   b.buffer, b.midi);
+
+                                  return batchSize;
+                              },
+                              [blocks] (int index, const PluginSandboxHelpers::BlockView& block)
+                              {
+                                  if (isPositiveAndBelow (index, (int) blocks.size()))
+                                  {
+                                      const auto& b = blocks[(size_t) index];
+                                      static_cast<Instance&> (b.instance).readProcessedBlock (block, b.buffer, b.midi);
+                                  }
+                              });
+
+        for (const auto& b : blocks)
+            static_cast<Instance&> (b.instance).finishBlock (b.buffer, b.midi);
+    }
+
+    bool belongsTo (const Pimpl& s) const noexcept    { return sandbox.get() == &s; }
+
+    //==============================================================================
+    void fillInPluginDescription (PluginDescription& d) const override  { d = description; }
+    const String getName() const override                               { return description.name; }
+    bool acceptsMidi() const override                                   { return midiInput; }
+    bool producesMidi() const override                                  { return midiOutput; }
+    bool isMidiEffect() const override                                  { return midiEffect; }
+    double getTailLengthSeconds() const override                        { return tailLengthSeconds; }
+    bool hasEditor() const override                                     { return false; }
+    AudioProcessorEditor* createEditor() override                       { return nullptr; }
+
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override
+    {
+        return layouts == initialLayout;
+    }
+
+    //==============================================================================
+    void prepareToPlay (double newSampleRate, int estimatedSamplesPerBlock) override
+    {
+        setRateAndBufferSizeDetails (newSampleRate, estimatedSamplesPerBlock);
+
+        const auto maxChannels = (size_t) jmax (getTotalNumInputChannels(), getTotalNumOutputChannels());
+        sandbox->setMaximumBlockSize (instanceID, sizeof (PluginSandboxHelpers::BlockHeader)
+                                                    + maxChannels * (size_t) estimatedSamplesPerBlock * sizeof (float)
+                                                    + (size_t) parameters.size() * sizeof (PluginSandboxHelpers::ParameterChange)
+                                                    + 4096);
+        parameterChanges.reserve ((size_t) parameters.size());
+
+        if (auto reply = call (Request::prepareToPlay, newSampleRate, estimatedSamplesPerBlock))
+            setLatencySamples (MemoryInputStream (*reply, false).readInt());
+    }
+
+    void releaseResources() override        { call (Request::releaseResources); }
+    void reset() override                   { call (Request::reset); }
+
+    void setNonRealtime (bool isNonRealtime) noexcept override
+    {
+        AudioPluginInstance::setNonRealtime (isNonRealtime);
+        call (Request::setNonRealtime, isNonRealtime);
+    }
+
+    void processBlock (AudioBuffer<float>& buffer, MidiBuffer& midi) override
+    {
+        const BlockToProcess block { *this, buffer, midi };
+        processBlocks (*sandbox, { &block, 1 });
+    }
+
+    using AudioPluginInstance::processBlock;
+
+    //==============================================================================
+    int getNumPrograms() override                       { return programNames.size(); }
+    int getCurrentProgram() override                    { return currentProgram; }
+    const String getProgramName (int index) override    { return programNames[index]; }
+
+    void setCurrentProgram (int index) override
+    {
+        if (auto reply = call (Request::setCurrentProgram, index))
+            readProgramsAndParameterValues (*reply);
+    }
+
+    void changeProgramName (int index, const String& newName) override
+    {
+        if (isPositiveAndBelow (index, programNames.size()))
+        {
+            programNames.set (index, newName);
+            call (Request::changeProgramName, index, newName);
+        }
+    }
+
+    //==============================================================================
+    void getStateInformation (MemoryBlock& destData) override
+    {
+        if (auto reply = call (Request::getState))
+        {
+            MemoryInputStream in (*reply, false);
+            destData = PluginSandboxHelpers::readMemoryBlock (in);
+        }
+    }
+
+    void setStateInformation (const void* data, int sizeInBytes) override
+    {
+        if (auto reply = call (Request::setState, MemoryBlock (data, (size_t) sizeInBytes)))
+            readProgramsAndParameterValues (*reply);
+    }
+
+private:
+    //==============================================================================
+    struct Parameter final : public HostedAudioProcessorParameter
+    {
+        Parameter (Instance& o, InputStream& in)
+            : owner (o),
+              parameterID (in.readString()),
+              name (in.readString()),
+              label (in.readString()),
+              defaultValue (in.readFloat()),
+              value (in.readFloat()),
+              numSteps (in.readInt()),
+              discrete (in.readBool()),
+              boolean (in.readBool()),
+              automatable (in.readBool()),
+              metaParameter (in.readBool()),
+              orientationInverted (in.readBool()),
+              category ((Category) in.readInt())
+        {
+        }
+
+        float getValue() const override                         { return value; }
+        float getDefaultValue() const override                  { return defaultValue; }
+        String getName (int maximumLength) const override       { return name.substring (0, maximumLength); }
+        String getLabel() const override                        { return label; }
+        String getParameterID() const override                  { return parameterID; }
+        int getNumSteps() const override                        { return numSteps; }
+        bool isDiscrete() const override                        { return discrete; }
+        bool isBoolean() const override                         { return boolean; }
+        bool isAutomatable() const override                     { return automatable; }
+        bool isMetaParameter() const override                   { return metaParameter; }
+        bool isOrientationInverted() const override             { return orientationInverted; }
+        Category getCategory() const override                   { return category; }
+
+        void setValue (float newValue) override
+        {
+            value = newValue;
+            markAsChanged();
+        }
+
+        void markAsChanged()
+        {
+            changed = true;
+            owner.parametersChanged = true;
+        }
+
+        void setValueFromWorker (float newValue)
+        {
+            value = newValue;
+            sendValueChangedMessageToListeners (newValue);
+        }
+
+        String getText (float v, int maximumLength) const override
+        {
+            if (auto reply = owner.call (Request::getParameterText, getParameterIndex(), v, maximumLength))
+                return MemoryInputStream (*reply, false).readString();
+
+            return String (v, 2).substring (0, maximumLength);
+        }
+
+        float getValueForText (const String& text) const override
+        {
+            if (auto reply = owner.call (Request::getParameterValueForText, getParameterIndex(), text))
+                return MemoryInputStream (*reply, false).readFloat();
+
+            return text.getFloatValue();
+        }
+
+        Instance& owner;
+        const String parameterID, name, label;
+        const float defaultValue;
+        std::atomic<float> value;
+        std::atomic<bool> changed { false };
+        const int numSteps;
+        const bool discrete, boolean, automatable, metaParameter, orientationInverted;
+        const Category category;
+    };
+
+    //==============================================================================
+    Instance (std::shared_ptr<Pimpl> s, uint32 id, const PluginDescription& d, const BusesProperties& buses, InputStream& in)
+        : AudioPluginInstance (buses),
+          sandbox (std::move (s)),
+          instanceID (id),
+          description (d),
+          initialLayout (getBusesLayout())
+    {
+        midiInput = in.readBool();
+        midiOutput = in.readBool();
+        midiEffect = in.readBool();
+        tailLengthSeconds = in.readDouble();
+        setLatencySamples (in.readInt());
+
+        for (auto i = in.readInt(); --i >= 0 && ! in.isExhausted();)
+        {
+            auto parameter = std::make_unique<Parameter> (*this, in);
+            parameters.add (parameter.get());
+            addHostedParameter (std::move (parameter));
+        }
+
+        readProgramsAndParameterValues (in);
+    }
+
+    // Sends a request for this instance to the worker, along with any parameter
+    // changes that haven't been sent to it yet.
+    template <typename... Args>
+    std::optional<MemoryBlock> call (Request request, const Args&... args)
+    {
+        std::vector<PluginSandboxHelpers::ParameterChange> changes;
+        takeParameterChanges (changes);
+
+        auto reply = sandbox->call (request, instanceID, changes, args...);
+
+        if (! reply.has_value())
+            resendParameterChanges (changes);
+
+        return reply;
+    }
+
+    void takeParameterChanges (std::vector<PluginSandboxHelpers::ParameterChange>& changes)
+    {
+        changes.clear();
+
+        if (parametersChanged.exchange (false))
+            for (auto* p : parameters)
+                if (p->changed.exchange (false))
+                    changes.push_back ({ p->getParameterIndex(), p->getValue() });
+    }
+
+    // (so that changes which didn't reach the worker are sent again next time)
+    void resendParameterChanges (const std::vector<PluginSandboxHelpers::ParameterChange>& changes)
+    {
+        for (const auto& change : changes)
+            if (auto* p = parameters[change.index])
+                p->markAsChanged();
+    }
+
+    void readProgramsAndParameterValues (const MemoryBlock& reply)
+    {
+        MemoryInputStream in (reply, false);
+        readProgramsAndParameterValues (in);
+    }
+
+    // After loading a program or some state, the worker sends back the new list of
+    // programs and all the parameters' values.
+    void readProgramsAndParameterValues (InputStream& in)
+    {
+        StringArray names;
+
+        for (auto i = in.readInt(); --i >= 0 && ! in.isExhausted();)
+            names.add (in.readString());
+
+        programNames = names;
+        currentProgram = in.readInt();
+
+        for (auto i = in.readInt(); --i >= 0 && ! in.isExhausted();)
+        {
+            const auto index = in.readInt();
+            const auto newValue = in.readFloat();
+
+            if (auto* p = parameters[index])
+                if (p->getValue() != newValue)
+                    p->setValueFromWorker (newValue);
+        }
+    }
+
+    std::shared_ptr<Pimpl> sandbox;
+    const uint32 instanceID;
+    const PluginDescription description;
+    const BusesLayout initialLayout;
+    bool midiInput = false, midiOutput = false, midiEffect = false;
+    double tailLengthSeconds = 0;
+    StringArray programNames;
+    int currentProgram = 0;
+
+    Array<Parameter*> parameters;
+    std::atomic<bool> parametersChanged { false };
+    std::vector<PluginSandboxHelpers::ParameterChange> parameterChanges;
+    bool blockWasProcessed = false;
+
+    size_t appendBlock (MemoryBlock& dest, size_t batchSize, uint32 batchNumber,
+                        const AudioBuffer<float>& buffer, const MidiBuffer& midi)
+    {
+        takeParameterChanges (parameterChanges);
+        blockWasProcessed = false;
+
+        const PluginSandboxHelpers::BlockHeader header { instanceID, batchNumber, getTotalNumInputChannels(),
+                                                         buffer.getNumSamples(), 0, 0, 0, 0 };
+        return PluginSandboxHelpers::appendBlock (dest, batchSize, header, buffer, parameterChanges, midi);
+    }
+
+    void readProcessedBlock (const PluginSandboxHelpers::BlockView& block, AudioBuffer<float>& buffer, MidiBuffer& midi)
+    {
+        // (the worker sends back an empty block if it couldn't process it)
+        if (block.header.instanceID != instanceID || block.header.numSamples != buffer.getNumSamples())
+            return;
+
+        block.copyAudioTo (buffer);
+        block.copyMidiTo (midi);
+        block.forEachParameterChange ([this] (PluginSandboxHelpers::ParameterChange change)
+        {
+            if (auto* p = parameters[change.index])
+                p->setValueFromWorker (change.value);
+        });
+
+        if (block.header.latencySamples != getLatencySamples())
+            setLatencySamples (block.header.latencySamples);
+
+        blockWasProcessed = true;
+    }
+
+    void finishBlock (AudioBuffer<float>& buffer, MidiBuffer& midi)
+    {
+        if (! blockWasProcessed)
+        {
+            buffer.clear();
+            midi.clear();
+            resendParameterChanges (parameterChanges);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Instance)
+};
+
+//==============================================================================
+PluginSandbox::PluginSandbox()  : pimpl (std::make_shared<Pimpl>()) {}
+
+PluginSandbox::~PluginSandbox()
+{
+    // (the worker may outlive this object, if some of its instances are still in use)
+    pimpl->setWorkerLostCallback (nullptr);
+}
+
+bool PluginSandbox::launch (const File& workerExecutable, int audioBufferSizeBytes)
+{
+    pimpl->setWorkerLostCallback ([this] { NullCheckedInvocation::invoke (onWorkerLost); });
+    return pimpl->launch (workerExecutable, audioBufferSizeBytes);
+}
+
+bool PluginSandbox::isWorkerRunning() const                     { return pimpl->isWorkerRunning(); }
+void PluginSandbox::killWorkerProcess()                         { pimpl->kill(); }
+void PluginSandbox::setProcessTimeout (int timeoutMilliseconds) { pimpl->setProcessTimeout (timeoutMilliseconds); }
+void PluginSandbox::setRequestTimeout (int timeoutMilliseconds) { pimpl->setRequestTimeout (timeoutMilliseconds); }
+
+void PluginSandbox::processBlocks (Span<const BlockToProcess> blocks)
+{
+    const auto allInThisSandbox = std::all_of (blocks.begin(), blocks.end(), [this] (const BlockToProcess& block)
+    {
+        auto* instance = dynamic_cast<Instance*> (&block.instance);
+        return instance != nullptr && instance->belongsTo (*pimpl);
+    });
+
+    if (allInThisSandbox)
+        return Instance::processBlocks (*pimpl, blocks);
+
+    // All the instances must have been created by this sandbox!
+    jassertfalse;
+
+    for (const auto& block : blocks)
+        block.instance.processBlock (block.buffer, block.midi);
+}
+
+std::unique_ptr<AudioPluginInstance> PluginSandbox::createPluginInstance (const PluginDescription& description,
+                                                                          double initialSampleRate, int initialBufferSize,
+                                                                          String& errorMessage)
+{
+    errorMessage = {};
+    return Instance::create (pimpl, description, initialSampleRate, initialBufferSize, errorMessage);
+}
+
+bool PluginSandbox::findAllTypesForFile (OwnedArray<PluginDescription>& results,
+                                         const String& formatName,
+                                         const String& fileOrIdentifier)
+{
+    const auto reply = pimpl->call (Pimpl::Request::findAllTypesForFile, formatName, fileOrIdentifier);
+
+    if (! reply.has_value())
+        return false;
+
+    MemoryInputStream in (*reply, false);
+
+    for (auto i = in.readInt(); --i >= 0 && ! in.isExhausted();)
+    {
+        if (auto xml = parseXML (in.readString()))
+        {
+            auto desc = std::make_unique<PluginDescription>();
+
+            if (desc->loadFromXml (*xml))
+                results.add (std::move (desc));
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+class PluginSandboxWorker::Pimpl final : private ChildProcessWorker,
+                                         private Thread
+{
+public:
+    using Request = PluginSandboxHelpers::Request;
+
+    explicit Pimpl (PluginSandboxWorker& o)
+        : Thread (SystemStats::getJUCEVersion() + ": Plugin sandbox"),
+          owner (o)
+    {
+        formatManager.addDefaultFormats();
+    }
+
+    ~Pimpl() override
+    {
+        audioPipe.close();
+        stopThread (10000);
+
+        const ScopedLock sl (instancesLock);
+        instances.clear();
+    }
+
+    bool initialise (const String& commandLine)
+    {
+        return initialiseFromCommandLine (commandLine, PluginSandboxHelpers::commandLineUniqueID);
+    }
+
+    AudioPluginFormatManager formatManager;
+
+private:
+    //==============================================================================
+    struct WorkerInstance final : private AudioProcessorListener
+    {
+        explicit WorkerInstance (std::unique_ptr<AudioPluginInstance> p)
+            : plugin (std::move (p)),
+              parameters (plugin->getParameters()),
+              changedFlags ((size_t) parameters.size())
+        {
+            plugin->addListener (this);
+            parameterChanges.reserve ((size_t) parameters.size());
+        }
+
+        ~WorkerInstance() override
+        {
+            plugin->removeListener (this);
+        }
+
+        // Gathers the changes that the plugin has made to its own parameters since the
+        // last block, so that they can be sent back to the host.
+        const std::vector<PluginSandboxHelpers::ParameterChange>& getParameterChanges()
+        {
+            parameterChanges.clear();
+
+            if (anyParameterChanged.exchange (false))
+                for (size_t i = 0; i < changedFlags.size(); ++i)
+                    if (changedFlags[i].exchange (false))
+                        parameterChanges.push_back ({ (int32) i, parameters.getUnchecked ((int) i)->getValue() });
+
+            return parameterChanges;
+        }
+
+        void writeProgramsAndParameterValues (MemoryOutputStream& out) const
+        {
+            const auto numPrograms = plugin->getNumPrograms();
+            out.writeInt (numPrograms);
+
+            for (int i = 0; i < numPrograms; ++i)
+                out.writeString (plugin->getProgramName (i));
+
+            out.writeInt (plugin->getCurrentProgram());
+            out.writeInt (parameters.size());
+
+            for (auto* p : parameters)
+            {
+                out.writeInt (p->getParameterIndex());
+                out.writeFloat (p->getValue());
+            }
+        }
+
+        std::unique_ptr<AudioPluginInstance> plugin;
+        const Array<AudioProcessorParameter*> parameters;
+        AudioBuffer<float> buffer;
+        MidiBuffer midi;
+
+    private:
+        std::vector<std::atomic<bool>> changedFlags;
+        std::atomic<bool> anyParameterChanged { false };
+        std::vector<PluginSandboxHelpers::ParameterChange> parameterChanges;
+
+        void audioProcessorParameterChanged (AudioProcessor*, int index, float) override
+        {
+            if (isPositiveAndBelow (index, (int) changedFlags.size()))
+            {
+                changedFlags[(size_t) index] = true;
+                anyParameterChanged = true;
+            }
+        }
+
+        void audioProcessorChanged (AudioProcessor*, const ChangeDetails&) override {}
+
+        JUCE_DECLARE_NON_COPYABLE (WorkerInstance)
+    };
+
+    //==============================================================================
+    PluginSandboxWorker& owner;
+    SharedMemoryPipe audioPipe;
+    CriticalSection instancesLock;
+    std::map<uint32, std::unique_ptr<WorkerInstance>> instances;
+    MemoryBlock reply;
+
+    WorkerInstance* findInstance (uint32 instanceID) const
+    {
+        const auto iter = instances.find (instanceID);
+        return iter != instances.end() ? iter->second.get() : nullptr;
+    }
+
+    //==============================================================================
+    void handleMessageFromCoordinator (const MemoryBlock& message) override
+    {
+        MessageManager::callAsync ([weakThis = WeakReference<Pimpl> (this), message]
+        {
+            if (weakThis != nullptr)
+                weakThis->handleRequest (message);
+        });
+    }
+
+    void handleConnectionLost() override
+    {
+        audioPipe.close();
+
+        MessageManager::callAsync ([weakThis = WeakReference<Pimpl> (this)]
+        {
+            if (weakThis != nullptr && weakThis->owner.onConnectionLost != nullptr)
+                weakThis->owner.onConnectionLost();
+            else
+                JUCEApplicationBase::quit();
+        });
+    }
+
+    void sendReply (int requestID, const std::function<void (MemoryOutputStream&)>& writeReply = {})
+    {
+        MemoryOutputStream out;
+        out.writeInt (requestID);
+
+        if (writeReply != nullptr)
+            writeReply (out);
+
+        sendMessageToCoordinator (out.getMemoryBlock());
+    }
+
+    void handleRequest (const MemoryBlock& message)
+    {
+        MemoryInputStream in (message, false);
+        const auto requestID = in.readInt();
+        const auto request = (Request) in.readInt();
+
+        if (request == Request::openAudioPipe)
+        {
+            stopThread (10000);
+            const auto opened = audioPipe.openExisting (in.readString(), 5000);
+
+            if (opened)
+                startThread (Priority::highest);
+
+            return sendReply (requestID, [opened] (MemoryOutputStream& out) { out.writeBool (opened); });
+        }
+
+        if (request == Request::findAllTypesForFile)
+            return findAllTypesForFile (requestID, in);
+
+        const auto instanceID = (uint32) in.readInt();
+
+        if (request == Request::createInstance)
+            return createInstance (requestID, instanceID, in);
+
+        const auto parameterChanges = PluginSandboxHelpers::readParameterChanges (in);
+
+        if (request == Request::deleteInstance)
+        {
+            std::unique_ptr<WorkerInstance> instance;
+
+            {
+                const ScopedLock sl (instancesLock);
+                const auto iter = instances.find (instanceID);
+
+                if (iter != instances.end())
+                {
+                    instance = std::move (iter->second);
+                    instances.erase (iter);
+                }
+            }
+
+            instance.reset();
+            return sendReply (requestID);
+        }
+
+        auto* instance = findInstance (instanceID);
+
+        if (instance == nullptr)
+            return sendReply (requestID);
+
+        auto& plugin = *instance->plugin;
+
+        if (! parameterChanges.empty())
+        {
+            const ScopedLock sl (plugin.getCallbackLock());
+
+            for (const auto& change : parameterChanges)
+                if (auto* p = instance->parameters[change.index])
+                    p->setValue (change.value);
+        }
+
+        switch (request)
+        {
+            case Request::prepareToPlay:
+            {
+                const auto sampleRate = in.readDouble();
+                const auto blockSize = in.readInt();
+
+                {
+                    const ScopedLock sl (plugin.getCallbackLock());
+                    plugin.setRateAndBufferSizeDetails (sampleRate, blockSize);
+                    plugin.prepareToPlay (sampleRate, blockSize);
+                    instance->buffer.setSize (jmax (plugin.getTotalNumInputChannels(), plugin.getTotalNumOutputChannels()), blockSize);
+                    instance->midi.ensureSize (4096);
+                }
+
+                return sendReply (requestID, [&] (MemoryOutputStream& out) { out.writeInt (plugin.getLatencySamples()); });
+            }
+
+            case Request::releaseResources:
+            {
+                const ScopedLock sl (plugin.getCallbackLock());
+                plugin.releaseResources();
+                break;
+            }
+
+            case Request::reset:
+            {
+                const ScopedLock sl (plugin.getCallbackLock());
+                plugin.reset();
+                break;
+            }
+
+            case Request::setNonRealtime:
+                plugin.setNonRealtime (in.readBool());
+                break;
+
+            case Request::getState:
+            {
+                MemoryBlock state;
+                plugin.getStateInformation (state);
+                return sendReply (requestID, [&] (MemoryOutputStream& out) { PluginSandboxHelpers::writeValue (out, state); });
+            }
+
+            case Request::setState:
+            {
+                const auto state = PluginSandboxHelpers::readMemoryBlock (in);
+                plugin.setStateInformation (state.getData(), (int) state.getSize());
+                return sendReply (requestID, [&] (MemoryOutputStream& out) { instance->writeProgramsAndParameterValues (out); });
+            }
+
+            case Request::setCurrentProgram:
+                plugin.setCurrentProgram (in.readInt());
+                return sendReply (requestID, [&] (MemoryOutputStream& out) { instance->writeProgramsAndParameterValues (out); });
+
+            case Request::changeProgramName:
+            {
+                const auto index = in.readInt();
+                plugin.changeProgramName (index, in.readString());
+                break;
+            }
+
+            case Request::getParameterText:
+            {
+                const auto index = in.readInt();
+                const auto value = in.readFloat();
+                const auto maximumLength = in.readInt();
+                String text;
+
+                if (auto* p = instance->parameters[index])
+                    text = p->getText (value, maximumLength);
+
+                return sendReply (requestID, [&] (MemoryOutputStream& out) { out.writeString (text); });
+            }
+
+            case Request::getParameterValueForText:
+            {
+                const auto index = in.readInt();
+                const auto text = in.readString();
+                float value = 0;
+
+                if (auto* p = instance->parameters[index])
+                    value = p->getValueForText (text);
+
+                return sendReply (requestID, [&] (MemoryOutputStream& out) { out.writeFloat (value); });
+            }
+
+            case Request::openAudioPipe:
+            case Request::createInstance:
+            case Request::deleteInstance:
+            case Request::findAllTypesForFile:
+                break;
+        }
+
+        sendReply (requestID);
+    }
+
+    void createInstance (int requestID, uint32 instanceID, InputStream& in)
+    {
+        PluginDescription description;
+
+        if (auto xml = parseXML (in.readString()))
+            description.loadFromXml (*xml);
+
+        const auto sampleRate = in.readDouble();
+        const auto blockSize = in.readInt();
+
+        formatManager.createPluginInstanceAsync (description, sampleRate, blockSize,
+                                                 [weakThis = WeakReference<Pimpl> (this), requestID, instanceID]
+                                                 (std::unique_ptr<AudioPluginInstance> plugin, const String& error)
+        {
+            if (weakThis == nullptr)
+                return;
+
+            if (plugin == nullptr)
+                return weakThis->sendReply (requestID, [&] (MemoryOutputStream& out)
+                                            {
+                                                out.writeBool (false);
+                                                out.writeString (error);
+                                            });
+
+            auto instance = std::make_unique<WorkerInstance> (std::move (plugin));
+
+            weakThis->sendReply (requestID, [&] (MemoryOutputStream& out) { writeInstanceDetails (out, *instance); });
+
+            const ScopedLock sl (weakThis->instancesLock);
+            weakThis->instances[instanceID] = std::move (instance);
+        });
+    }
+
+    void findAllTypesForFile (int requestID, InputStream& in)
+    {
+        const auto formatName = in.readString();
+        const auto fileOrIdentifier = in.readString();
+        OwnedArray<PluginDescription> found;
+
+        for (auto* format : formatManager.getFormats())
+        {
+            if (format->getName() == formatName)
+            {
+                format->findAllTypesForFile (found, fileOrIdentifier);
+                break;
+            }
+        }
+
+        sendReply (requestID, [&] (MemoryOutputStream& out)
+        {
+            out.writeInt (found.size());
+
+            for (auto* desc : found)
+                out.writeString (desc->createXml()->toString());
+        });
+    }
+
+    static void writeInstanceDetails (MemoryOutputStream& out, const WorkerInstance& instance)
+    {
+        auto& plugin = *instance.plugin;
+
+        out.writeBool (true);
+        out.writeString (plugin.getPluginDescription().createXml()->toString());
+
+        for (const auto isInput : { true, false })
+        {
+            const auto numBuses = plugin.getBusCount (isInput);
+            out.writeInt (numBuses);
+
+            for (int i = 0; i < numBuses; ++i)
+            {
+                auto* bus = plugin.getBus (isInput, i);
+                out.writeString (bus->getName());
+                PluginSandboxHelpers::writeChannelSet (out, bus->isEnabled() ? bus->getCurrentLayout() : bus->getDefaultLayout());
+                out.writeBool (bus->isEnabled());
+            }
+        }
+
+        out.writeBool (plugin.acceptsMidi());
+        out.writeBool (plugin.producesMidi());
+        out.writeBool (plugin.isMidiEffect());
+        out.writeDouble (plugin.getTailLengthSeconds());
+        out.writeInt (plugin.getLatencySamples());
+        out.writeInt (instance.parameters.size());
+
+        for (auto* p : instance.parameters)
+        {
+            out.writeString (getParameterID (*p));
+            out.writeString (p->getName (1024));
+            out.writeString (p->getLabel());
+            out.writeFloat (p->getDefaultValue());
+            out.writeFloat (p->getValue());
+            out.writeInt (p->getNumSteps());
+            out.writeBool (p->isDiscrete());
+            out.writeBool (p->isBoolean());
+            out.writeBool (p->isAutomatable());
+            out.writeBool (p->isMetaParameter());
+            out.writeBool (p->isOrientationInverted());
+            out.writeInt ((int) p->getCategory());
+        }
+
+        instance.writeProgramsAndParameterValues (out);
+    }
+
+    static String getParameterID (const AudioProcessorParameter& p)
+    {
+        if (auto* hosted = dynamic_cast<const HostedAudioProcessorParameter*> (&p))
+            return hosted->getParameterID();
+
+        return String (p.getParameterIndex());
+    }
+
+    //==============================================================================
+    // The audio thread processes each batch of blocks that arrives, and sends it back.
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            size_t replySize = 0;
+
+            const auto result = audioPipe.read ([this, &replySize] (Span<const std::byte> data)
+            {
+                replySize = processBatch (data);
+            }, 100);
+
+            if (result == SharedMemoryPipe::ReadResult::closed)
+                break;
+
+            if (replySize > 0 && ! audioPipe.write (reply.getData(), replySize, 1000))
+                break;
+        }
+    }
+
+    // Returns the size of the batch of processed blocks that's been written into the reply
+    size_t processBatch (Span<const std::byte> data)
+    {
+        size_t replySize = 0;
+
+        const ScopedLock sl (instancesLock);
+
+        if (! PluginSandboxHelpers::forEachBlockInBatch (data, [this, &replySize] (const PluginSandboxHelpers::BlockView& block)
+                                                         {
+                                                             replySize = processBlock (block, replySize);
+                                                         }))
+        {
+            jassertfalse;
+            return 0;
+        }
+
+        return replySize;
+    }
+
+    size_t processBlock (const PluginSandboxHelpers::BlockView& block, size_t replySize)
+    {
+        using namespace PluginSandboxHelpers;
+
+        BlockHeader header { block.header.instanceID, block.header.batchNumber, 0, 0, 0, 0, 0, 0 };
+        static const AudioBuffer<float> emptyBuffer;
+        static const std::vector<ParameterChange> noParameterChanges;
+
+        auto* instance = findInstance (header.instanceID);
+
+        // (an empty block tells the host that this one couldn't be processed)
+        if (instance == nullptr)
+            return appendBlock (reply, replySize, header, emptyBuffer, noParameterChanges, {});
+
+        auto& plugin = *instance->plugin;
+        auto& buffer = instance->buffer;
+        const ScopedLock callbackLock (plugin.getCallbackLock());
+
+        block.forEachParameterChange ([instance] (ParameterChange change)
+        {
+            if (auto* p = instance->parameters[change.index])
+                p->setValue (change.value);
+        });
+
+        buffer.setSize (jmax (plugin.getTotalNumInputChannels(), plugin.getTotalNumOutputChannels()),
+                        block.header.numSamples, false, false, true);
+        block.copyAudioTo (buffer);
+        block.copyMidiTo (instance->midi);
+
+        if (plugin.isSuspended())
+        {
+            buffer.clear();
+            instance->midi.clear();
+        }
+        else
+        {
+            plugin.processBlock (buffer, instance->midi);
+        }
+
+        header.numChannels = jmin (plugin.getTotalNumOutputChannels(), buffer.getNumChannels());
+        header.numSamples = block.header.numSamples;
+        header.latencySamples = plugin.getLatencySamples();
+
+        return appendBlock (reply, replySize, header, buffer, instance->getParameterChanges(), instance->midi);
+    }
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE (Pimpl)
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+//==============================================================================
+PluginSandboxWorker::PluginSandboxWorker()  : pimpl (std::make_unique<Pimpl> (*this)) {}
+PluginSandboxWorker::~PluginSandboxWorker() = default;
+
+bool PluginSandboxWorker::initialiseFromCommandLine (const String& commandLine)
+{
+    return pimpl->initialise (commandLine);
+}
+
+AudioPluginFormatManager& PluginSandboxWorker::getFormatManager() noexcept
+{
+    return pimpl->formatManager;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PluginSandboxTests final : public UnitTest
+{
+public:
+    PluginSandboxTests()
+        : UnitTest ("PluginSandbox", UnitTestCategories::audioProcessors)
+    {}
+
+    void runTest() override
+    {
+        using namespace PluginSandboxHelpers;
+
+        auto r = getRandom();
+
+        beginTest ("Blocks can be read back after they've been written");
+        {
+            AudioBuffer<float> audio (3, 64);
+
+            for (int channel = 0; channel < audio.getNumChannels(); ++channel)
+                for (int i = 0; i < audio.getNumSamples(); ++i)
+                    audio.setSample (channel, i, r.nextFloat());
+
+            const std::vector<ParameterChange> parameterChanges { { 0, 0.25f }, { 7, 1.0f }, { 3, 0.0f } };
+
+            MidiBuffer midi;
+            midi.addEvent (MidiMessage::noteOn (1, 60, (uint8) 100), 0);
+            midi.addEvent (MidiMessage::controllerEvent (2, 7, 64), 10);
+            midi.addEvent (MidiMessage::createSysExMessage ("abcdefg", 7), 63);
+
+            // (only the first two channels are inputs)
+            const BlockHeader header { 5, 42, 2, audio.getNumSamples(), 0, 0, 0, 128 };
+            MemoryBlock data;
+            const auto size = appendBlock (data, 0, header, audio, parameterChanges, midi);
+
+            const auto blocks = readBatch (data, size);
+            expectEquals ((int) blocks.size(), 1);
+            const auto* block = blocks.data();
+
+            expectEquals ((int) block->header.instanceID, 5);
+            expectEquals ((int) block->header.batchNumber, 42);
+            expectEquals ((int) block->header.numChannels, 2);
+            expectEquals ((int) block->header.numSamples, 64);
+            expectEquals ((int) block->header.latencySamples, 128);
+
+            AudioBuffer<float> audioOut (3, 64);
+            audioOut.clear();
+            audioOut.setSample (2, 0, 1.0f);
+            block->copyAudioTo (audioOut);
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < audio.getNumSamples(); ++i)
+                    expectEquals (audioOut.getSample (channel, i), audio.getSample (channel, i));
+
+            expectEquals (audioOut.getMagnitude (2, 0, audioOut.getNumSamples()), 0.0f);
+
+            std::vector<ParameterChange> parameterChangesOut;
+            block->forEachParameterChange ([&] (ParameterChange change) { parameterChangesOut.push_back (change); });
+            expect (areEqual (parameterChangesOut, parameterChanges));
+
+            MidiBuffer midiOut;
+            midiOut.addEvent (MidiMessage::allNotesOff (1), 5);
+            block->copyMidiTo (midiOut);
+            expect (areEqual (midiOut, midi));
+        }
+
+        beginTest ("Blocks with nothing in them can be written");
+        {
+            const BlockHeader header { 1, 2, 0, 0, 0, 0, 0, 0 };
+            MemoryBlock data;
+            const auto size = appendBlock (data, 0, header, {}, {}, {});
+            expectEquals (size, sizeof (uint32) + sizeof (BlockHeader));
+
+            const auto blocks = readBatch (data, size);
+            expectEquals ((int) blocks.size(), 1);
+            expectEquals ((int) blocks.front().header.numSamples, 0);
+
+            MidiBuffer midiOut;
+            blocks.front().copyMidiTo (midiOut);
+            expect (midiOut.isEmpty());
+        }
+
+        beginTest ("Batches can contain blocks for several instances");
+        {
+            MemoryBlock data;
+            size_t size = 0;
+
+            for (uint32 i = 1; i <= 4; ++i)
+            {
+                AudioBuffer<float> audio (2, (int) i * 10);
+                audio.clear();
+                audio.setSample (1, 0, (float) i);
+
+                MidiBuffer midi;
+
+                for (uint32 j = 0; j < i; ++j)
+                    midi.addEvent (MidiMessage::noteOn (1, (int) j, (uint8) 100), (int) j);
+
+                size = appendBlock (data, size, { i, 99, 2, audio.getNumSamples(), 0, 0, 0, 0 }, audio, { { (int32) i, 0.5f } }, midi);
+            }
+
+            const auto blocks = readBatch (data, size);
+            expectEquals ((int) blocks.size(), 4);
+
+            for (uint32 i = 1; i <= blocks.size(); ++i)
+            {
+                const auto& block = blocks[i - 1];
+                expectEquals ((int) block.header.instanceID, (int) i);
+                expectEquals ((int) block.header.batchNumber, 99);
+                expectEquals ((int) block.header.numSamples, (int) i * 10);
+
+                AudioBuffer<float> audioOut (2, block.header.numSamples);
+                block.copyAudioTo (audioOut);
+                expectEquals (audioOut.getSample (1, 0), (float) i);
+
+                MidiBuffer midiOut;
+                block.copyMidiTo (midiOut);
+                expectEquals (midiOut.getNumEvents(), (int) i);
+
+                std::vector<ParameterChange> parameterChangesOut;
+                block.forEachParameterChange ([&] (ParameterChange change) { parameterChangesOut.push_back (change); });
+                expect (areEqual (parameterChangesOut, { { (int32) i, 0.5f } }));
+            }
+
+            expect (! forEachBlockInBatch ({ static_cast<const std::byte*> (data.getData()), size - 1 }, [] (const BlockView&) {}));
+            expect (forEachBlockInBatch ({}, [] (const BlockView&) { jassertfalse; }));
+        }
+
+        beginTest ("Blocks of the wrong size are rejected");
+        {
+            AudioBuffer<float> audio (2, 16);
+            audio.clear();
+            MidiBuffer midi;
+            midi.addEvent (MidiMessage::noteOff (1, 60), 3);
+
+            const BlockHeader header { 1, 2, 2, 16, 0, 0, 0, 0 };
+            MemoryBlock data;
+            const auto size = appendBlock (data, 0, header, audio, { { 1, 0.5f } }, midi) - sizeof (uint32);
+            const auto* bytes = static_cast<const std::byte*> (data.getData()) + sizeof (uint32);
+
+            expect (BlockView::parse ({ bytes, size }).has_value());
+            expect (! BlockView::parse ({ bytes, size - 1 }).has_value());
+            expect (! BlockView::parse ({ bytes, sizeof (BlockHeader) - 1 }).has_value());
+
+            data.ensureSize (sizeof (uint32) + size + 1);
+            expect (! BlockView::parse ({ static_cast<const std::byte*> (data.getData()) + sizeof (uint32), size + 1 }).has_value());
+        }
+
+        beginTest ("Writing a block reuses the memory it's given");
+        {
+            AudioBuffer<float> audio (1, 32);
+            audio.clear();
+            const BlockHeader header { 1, 2, 1, 32, 0, 0, 0, 0 };
+
+            MemoryBlock data (4096);
+            const auto* original = data.getData();
+            const auto size = appendBlock (data, 0, header, audio, {}, {});
+
+            expect (data.getData() == original);
+            expectEquals (data.getSize(), (size_t) 4096);
+            expectEquals (size, sizeof (uint32) + sizeof (BlockHeader) + 32 * sizeof (float));
+            expectEquals (appendBlock (data, size, header, audio, {}, {}), 2 * size);
+            expect (data.getData() == original);
+        }
+
+        beginTest ("Parameter changes sent with requests can be read back");
+        {
+            const std::vector<ParameterChange> parameterChanges { { 2, 0.5f }, { 0, 0.125f } };
+
+            MemoryOutputStream out;
+            writeValue (out, parameterChanges);
+            writeValue (out, String ("after"));
+
+            MemoryInputStream in (out.getData(), out.getDataSize(), false);
+            expect (areEqual (readParameterChanges (in), parameterChanges));
+            expectEquals (in.readString(), String ("after"));
+
+            MemoryOutputStream empty;
+            writeValue (empty, std::vector<ParameterChange>());
+            MemoryInputStream emptyIn (empty.getData(), empty.getDataSize(), false);
+            expect (readParameterChanges (emptyIn).empty());
+            expect (emptyIn.isExhausted());
+        }
+    }
+
+private:
+    static std::vector<PluginSandboxHelpers::BlockView> readBatch (const MemoryBlock& data, size_t size)
+    {
+        std::vector<PluginSandboxHelpers::BlockView> blocks;
+
+        PluginSandboxHelpers::forEachBlockInBatch ({ static_cast<const std::byte*> (data.getData()), size },
+                                                   [&] (const PluginSandboxHelpers::BlockView& block) { blocks.push_back (block); });
+        return blocks;
+    }
+
+    static bool areEqual (const std::vector<PluginSandboxHelpers::ParameterChange>& a,
+                          const std::vector<PluginSandboxHelpers::ParameterChange>& b)
+    {
+        return std::equal (a.begin(), a.end(), b.begin(), b.end(), [] (const auto& x, const auto& y)
+        {
+            return x.index == y.index && x.value == y.value;
+        });
+    }
+
+    static bool areEqual (const MidiBuffer& a, const MidiBuffer& b)
+    {
+        if (a.getNumEvents() != b.getNumEvents())
+            return false;
+
+        return std::equal (a.begin(), a.end(), b.begin(), [] (const auto& x, const auto& y)
+        {
+            return x.samplePosition == y.samplePosition
+                    && x.numBytes == y.numBytes
+                    && memcmp (x.data, y.data, (size_t) x.numBytes) == 0;
+        });
+    }
+};
+
+static PluginSandboxTests pluginSandboxTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,233 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Runs plugins in a separate worker process, so that a plugin which crashes or
+    hangs can't take the rest of the host down with it.
+
+    Call launch() to start the worker, then use createPluginInstance() to load
+    plugins into it. Each plugin is represented in the host by an AudioPluginInstance
+    which forwards everything to the real plugin in the worker.
+
+    Audio, MIDI and parameter changes are passed to and from the worker through a
+    SharedMemoryPipe, so each call to processBlock() costs one round trip through
+    shared memory. Other calls, such as prepareToPlay() and getStateInformation(), are
+    sent as messages through a ChildProcessCoordinator.
+
+    Any number of plugins can be loaded into the same sandbox. They'll share one
+    worker process, one connection, and one thread that processes their audio, which
+    is much cheaper than giving each plugin its own sandbox. The trade-off is that if
+    one of them crashes, all the plugins in that sandbox will stop working. When the
+    host has blocks for several of them ready at the same time, it can pass them all
+    to processBlocks(), so that they only cost a single round trip between them.
+
+    If the worker process dies, the instances will just output silence, and the
+    onWorkerLost callback will be called. If a plugin takes longer than the process
+    timeout to process a block, that block and any more that arrive before the plugin
+    has caught up are replaced with silence, so the audio thread isn't held up.
+
+    The executable that's launched as the worker (which can be the host's own
+    executable) must create a PluginSandboxWorker in its startup code, and call its
+    initialiseFromCommandLine() method.
+
+    Note that the sandboxed instances don't support editors, and don't allow their
+    bus layouts to be changed: they'll always have the layout the plugin had when
+    it was created.
+
+    @see PluginSandboxWorker, AudioPluginFormatManager
+
+    @tags{Audio}
+*/
+class JUCE_API  PluginSandbox
+{
+public:
+    //==============================================================================
+    /** Creates a sandbox. Call launch() to start its worker process. */
+    PluginSandbox();
+
+    /** Destructor.
+
+        The worker process keeps running until any instances that were created by this
+        sandbox have also been deleted.
+    */
+    ~PluginSandbox();
+
+    //==============================================================================
+    /** Starts the worker process.
+
+        The executable must call PluginSandboxWorker::initialiseFromCommandLine() when
+        it starts up. audioBufferSizeBytes sets the size of the shared memory that
+        audio is passed through, which must be at least four times the size of the
+        largest block of audio that will be processed. Returns true if the worker
+        was started and connected to. This always fails on Android, which doesn't
+        support the named shared memory that the audio is passed through.
+
+        If a worker is already running, this will stop it, and any instances that
+        were created in it will stop working.
+    */
+    bool launch (const File& workerExecutable = File::getSpecialLocation (File::currentExecutableFile),
+                 int audioBufferSizeBytes = 1 << 22);
+
+    /** Returns true if the worker process is running and connected. */
+    bool isWorkerRunning() const;
+
+    /** Stops the worker process. Any instances that were created in it will stop working. */
+    void killWorkerProcess();
+
+    //==============================================================================
+    /** Loads a plugin in the worker process, returning an instance that controls it.
+
+        This blocks until the plugin has been created, and can be called on any thread,
+        including the message thread. If it fails, it returns nullptr and leaves a
+        message in the errorMessage string.
+    */
+    std::unique_ptr<AudioPluginInstance> createPluginInstance (const PluginDescription& description,
+                                                               double initialSampleRate, int initialBufferSize,
+                                                               String& errorMessage);
+
+    /** Asks the worker process to search a file for plugins, using the format with the
+        given name, in the same way as AudioPluginFormat::findAllTypesForFile().
+
+        Returns false if the worker crashed or didn't reply before the request timeout.
+        In that case, you'll probably want to kill the worker, in case it's still stuck.
+    */
+    bool findAllTypesForFile (OwnedArray<PluginDescription>& results,
+                              const String& formatName,
+                              const String& fileOrIdentifier);
+
+    /** Describes one of the blocks that's passed to processBlocks(). */
+    struct BlockToProcess
+    {
+        AudioPluginInstance& instance;
+        AudioBuffer<float>& buffer;
+        MidiBuffer& midi;
+    };
+
+    /** Processes a block for each of several instances, in a single round trip to the
+        worker.
+
+        This has the same effect as calling processBlock() on each instance in turn,
+        but the blocks are sent to the worker together, and it sends them all back
+        together once it has processed them, so the cost of waking up the worker and
+        waiting for it is only paid once. The instances must all have been created by
+        this sandbox, and none of their blocks may depend on another's output. If the
+        blocks aren't processed before the process timeout, they're all replaced with
+        silence.
+    */
+    void processBlocks (Span<const BlockToProcess> blocks);
+
+    /** Sets the longest time that processBlock() will wait for a block to be
+        processed, after which it'll give up and output silence instead.
+
+        By default, the timeout is half the length of the block that's being processed,
+        so that there's still time to output the silence before the audio device needs
+        it. Passing a negative value restores the default. Instances that have been set
+        to non-realtime mode wait for as long as the request timeout instead.
+    */
+    void setProcessTimeout (int timeoutMilliseconds);
+
+    /** Sets the longest time that any other call will wait for the worker to reply.
+        The default is 10 seconds.
+    */
+    void setRequestTimeout (int timeoutMilliseconds);
+
+    /** Called if the worker process dies or stops responding.
+        This may be called on any thread.
+    */
+    std::function<void()> onWorkerLost;
+
+private:
+    //==============================================================================
+    class Pimpl;
+    class Instance;
+    std::shared_ptr<Pimpl> pimpl;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginSandbox)
+};
+
+//==============================================================================
+/**
+    The part of a PluginSandbox that runs in the worker process.
+
+    Your worker executable must create one of these in its main() or
+    JUCEApplication::initialise() function, and call initialiseFromCommandLine().
+    If that returns true, the process has been launched by a PluginSandbox, and
+    should keep running (with its message loop going) until the sandbox is closed.
+
+    By default the worker process quits when the connection to the host is lost,
+    but you can change this with the onConnectionLost callback.
+
+    @see PluginSandbox
+
+    @tags{Audio}
+*/
+class JUCE_API  PluginSandboxWorker
+{
+public:
+    //==============================================================================
+    /** Creates a worker. Its format manager is given the default formats. */
+    PluginSandboxWorker();
+
+    /** Destructor. */
+    ~PluginSandboxWorker();
+
+    //==============================================================================
+    /** Checks the command-line parameters to see whether this process was launched
+        by a PluginSandbox, and if so, connects to it.
+    */
+    bool initialiseFromCommandLine (const String& commandLine);
+
+    /** Returns the format manager that's used to load plugins.
+        You can add your own formats to this before calling initialiseFromCommandLine().
+    */
+    AudioPluginFormatManager& getFormatManager() noexcept;
+
+    /** Called when the connection to the host is lost.
+        If this isn't set, JUCEApplicationBase::quit() is called instead.
+    */
+    std::function<void()> onConnectionLost;
+
+private:
+    //==============================================================================
+    class Pimpl;
+    std::unique_ptr<Pimpl> pimpl;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginSandboxWorker)
+};
+
+} // namespace juce
@@ -259,6 +259,11 @@ void KnownPluginList::scanFinished()
         scanner->scanFinished();
 }
 
+bool KnownPluginList::canScanConcurrently() const
+{
+    return scanner != nullptr && scanner->canScanConcurrently();
+}
+
 const StringArray& KnownPluginList::getBlacklistedFiles() const
 {
     return blacklist;
@@ -622,6 +627,7 @@ KnownPluginList::CustomScanner::CustomScanner() {}
 KnownPluginList::CustomScanner::~CustomScanner() {}
 
 void KnownPluginList::CustomScanner::scanFinished() {}
+bool KnownPluginList::CustomScanner::canScanConcurrently() const { return false; }
 
 bool KnownPluginList::CustomScanner::shouldExit() const noexcept
 {
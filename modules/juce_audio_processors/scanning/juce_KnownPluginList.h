@@ -105,6 +105,12 @@ public:
     /** Tells a custom scanner that a scan has finished, and it can release any resources. */
     void scanFinished();
 
+    /** Returns true if scanAndAddFile() can be called by several threads at once, which
+        is only the case if a custom scanner that allows it has been supplied.
+        @see CustomScanner::canScanConcurrently
+    */
+    bool canScanConcurrently() const;
+
     /** Returns true if the specified file is already known about and if it
         hasn't been modified since our entry was created.
     */
@@ -205,6 +211,12 @@ public:
         /** Called when a scan has finished, to allow clean-up of resources. */
         virtual void scanFinished();
 
+        /** Should return true if findPluginTypesFor() can be called by several threads
+            at once. Most plugin formats can't load more than one plugin at a time in the
+            same process, so this returns false by default.
+        */
+        virtual bool canScanConcurrently() const;
+
         /** Returns true if the current scan should be abandoned.
             Any blocking methods should check this value repeatedly and return if
             if becomes true.
@@ -0,0 +1,601 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct OutOfProcessPluginScanner::Worker
+{
+    PluginSandbox sandbox;
+    bool busy = false;
+};
+
+//==============================================================================
+// Remembers the plugins that were found in each file, along with enough details
+// about the file to tell whether it has changed since.
+class OutOfProcessPluginScanner::Cache
+{
+public:
+    explicit Cache (const File& f)  : file (f)
+    {
+        load();
+    }
+
+    bool find (const String& formatName, const String& fileOrIdentifier, OwnedArray<PluginDescription>& results)
+    {
+        const auto fingerprint = getFingerprint (fileOrIdentifier);
+
+        if (! fingerprint.has_value())
+            return false;
+
+        const ScopedLock sl (lock);
+        const auto iter = entries.find (getKey (formatName, fileOrIdentifier));
+
+        // (any change to the file, even one that leaves its size the same, means it's scanned again)
+        if (iter == entries.end()
+             || iter->second.fingerprint.size != fingerprint->size
+             || iter->second.fingerprint.modificationTime != fingerprint->modificationTime)
+            return false;
+
+        for (auto& desc : iter->second.types)
+            results.add (new PluginDescription (desc));
+
+        return true;
+    }
+
+    void add (const String& formatName, const String& fileOrIdentifier, const OwnedArray<PluginDescription>& types)
+    {
+        const auto fingerprint = getFingerprint (fileOrIdentifier);
+
+        if (! fingerprint.has_value())
+            return;
+
+        Entry entry { *fingerprint, {} };
+
+        for (auto* desc : types)
+            entry.types.add (*desc);
+
+        const ScopedLock sl (lock);
+        entries[getKey (formatName, fileOrIdentifier)] = std::move (entry);
+        needsSaving = true;
+    }
+
+    void clear()
+    {
+        const ScopedLock sl (lock);
+        entries.clear();
+        needsSaving = true;
+    }
+
+    void save()
+    {
+        const ScopedLock sl (lock);
+
+        if (! needsSaving || file == File())
+            return;
+
+        XmlElement xml ("PLUGINSCANCACHE");
+
+        for (auto& [key, entry] : entries)
+        {
+            auto* e = xml.createNewChildElement ("FILE");
+            e->setAttribute ("format", key.upToFirstOccurrenceOf (":", false, false));
+            e->setAttribute ("file", key.fromFirstOccurrenceOf (":", false, false));
+            e->setAttribute ("size", String (entry.fingerprint.size));
+            e->setAttribute ("modTime", String::toHexString (entry.fingerprint.modificationTime));
+
+            for (auto& desc : entry.types)
+                e->addChildElement (desc.createXml().release());
+        }
+
+        if (xml.writeTo (file))
+            needsSaving = false;
+    }
+
+private:
+    struct Fingerprint
+    {
+        int64 size = 0, modificationTime = 0;
+    };
+
+    struct Entry
+    {
+        Fingerprint fingerprint;
+        Array<PluginDescription> types;
+    };
+
+    const File file;
+    CriticalSection lock;
+    std::map<String, Entry> entries;
+    bool needsSaving = false;
+
+    static String getKey (const String& formatName, const String& fileOrIdentifier)
+    {
+        return formatName + ":" + fileOrIdentifier;
+    }
+
+    // Some plugins are bundles, so this returns all the files inside them, in a consistent order
+    static Array<File> getFilesIn (const File& f)
+    {
+        if (! f.isDirectory())
+            return { f };
+
+        auto files = f.findChildFiles (File::findFiles, true);
+        files.sort();
+        return files;
+    }
+
+    // Returns nothing for identifiers that aren't files, e.g. AudioUnit IDs
+    static std::optional<Fingerprint> getFingerprint (const String& fileOrIdentifier)
+    {
+        if (! File::isAbsolutePath (fileOrIdentifier))
+            return {};
+
+        const File f (fileOrIdentifier);
+
+        if (! f.exists())
+            return {};
+
+        Fingerprint fingerprint;
+
+        for (auto& child : getFilesIn (f))
+        {
+            fingerprint.size += child.getSize();
+            fingerprint.modificationTime = jmax (fingerprint.modificationTime, child.getLastModificationTime().toMilliseconds());
+        }
+
+        return fingerprint;
+    }
+
+    void load()
+    {
+        if (! file.existsAsFile())
+            return;
+
+        if (auto xml = parseXMLIfTagMatches (file, "PLUGINSCANCACHE"))
+        {
+            for (auto* e : xml->getChildWithTagNameIterator ("FILE"))
+            {
+                Entry entry;
+                entry.fingerprint.size = e->getStringAttribute ("size").getLargeIntValue();
+                entry.fingerprint.modificationTime = e->getStringAttribute ("modTime").getHexValue64();
+
+                for (auto* p : e->getChildIterator())
+                {
+                    PluginDescription desc;
+
+                    if (desc.loadFromXml (*p))
+                        entry.types.add (desc);
+                }
+
+                entries[getKey (e->getStringAttribute ("format"), e->getStringAttribute ("file"))] = std::move (entry);
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Cache)
+};
+
+//==============================================================================
+OutOfProcessPluginScanner::OutOfProcessPluginScanner (const File& workerExecutable, int numWorkers, const File& cacheFile)
+    : executable (workerExecutable),
+      maxNumWorkers (jmax (1, numWorkers)),
+      cache (std::make_unique<Cache> (cacheFile))
+{
+}
+
+OutOfProcessPluginScanner::~OutOfProcessPluginScanner()
+{
+    cache->save();
+}
+
+void OutOfProcessPluginScanner::setTimeoutPerFile (int timeoutMilliseconds)
+{
+    timeoutMs = timeoutMilliseconds;
+}
+
+void OutOfProcessPluginScanner::setScanInProcessIfWorkerCantBeLaunched (bool shouldScanInProcess)
+{
+    scanInProcessIfWorkerCantBeLaunched = shouldScanInProcess;
+}
+
+void OutOfProcessPluginScanner::clearCache()
+{
+    cache->clear();
+}
+
+std::pair<int, int> OutOfProcessPluginScanner::getNumFilesScannedAndCached() const noexcept
+{
+    return { numFilesScanned.load(), numFilesCached.load() };
+}
+
+bool OutOfProcessPluginScanner::findPluginTypesFor (AudioPluginFormat& format,
+                                                    OwnedArray<PluginDescription>& result,
+                                                    const String& fileOrIdentifier)
+{
+    if (cache->find (format.getName(), fileOrIdentifier, result))
+    {
+        ++numFilesCached;
+        return true;
+    }
+
+    auto* worker = acquireWorker();
+
+    // (the scan has been cancelled)
+    if (worker == nullptr)
+        return true;
+
+    OwnedArray<PluginDescription> found;
+    const auto scanResult = scanInWorker (*worker, format, found, fileOrIdentifier);
+    releaseWorker (*worker);
+
+    if (scanResult == ScanResult::crashed)
+        return false;
+
+    if (scanResult == ScanResult::workerNotLaunched)
+    {
+        // The worker process couldn't be started - make sure that the executable calls
+        // PluginSandboxWorker::initialiseFromCommandLine() when it starts up! Unless the
+        // host has asked to scan in-process, nothing is found, so the file is reported as
+        // having failed to load, but isn't blacklisted or cached.
+        DBG ("Couldn't launch a plugin scanner worker process: " << executable.getFullPathName());
+
+        if (! scanInProcessIfWorkerCantBeLaunched)
+            return true;
+
+        // (plugins can't be loaded by several threads at once in the same process)
+        const ScopedLock sl (inProcessScanLock);
+        format.findAllTypesForFile (found, fileOrIdentifier);
+    }
+
+    ++numFilesScanned;
+    cache->add (format.getName(), fileOrIdentifier, found);
+
+    for (auto* desc : found)
+        result.add (new PluginDescription (*desc));
+
+    return true;
+}
+
+void OutOfProcessPluginScanner::scanFinished()
+{
+    cache->save();
+
+    // The worker processes are stopped, as there may not be another scan for a while
+    const ScopedLock sl (workersLock);
+
+    for (int i = workers.size(); --i >= 0;)
+        if (! workers.getUnchecked (i)->busy)
+            workers.remove (i);
+}
+
+bool OutOfProcessPluginScanner::canScanConcurrently() const
+{
+    return true;
+}
+
+//==============================================================================
+OutOfProcessPluginScanner::Worker* OutOfProcessPluginScanner::acquireWorker()
+{
+    for (;;)
+    {
+        {
+            const ScopedLock sl (workersLock);
+
+            for (auto* worker : workers)
+            {
+                if (! worker->busy)
+                {
+                    worker->busy = true;
+                    return worker;
+                }
+            }
+
+            if (workers.size() < maxNumWorkers)
+            {
+                auto* worker = workers.add (new Worker());
+                worker->busy = true;
+                return worker;
+            }
+        }
+
+        if (shouldExit())
+            return nullptr;
+
+        workerReleased.wait (100);
+    }
+}
+
+void OutOfProcessPluginScanner::releaseWorker (Worker& worker)
+{
+    {
+        const ScopedLock sl (workersLock);
+        worker.busy = false;
+    }
+
+    workerReleased.signal();
+}
+
+OutOfProcessPluginScanner::ScanResult OutOfProcessPluginScanner::scanInWorker (Worker& worker, AudioPluginFormat& format,
+                                                                              OwnedArray<PluginDescription>& found,
+                                                                              const String& fileOrIdentifier)
+{
+    auto& sandbox = worker.sandbox;
+    sandbox.setRequestTimeout (timeoutMs);
+
+    if (! sandbox.isWorkerRunning()
+         && (! executable.existsAsFile() || ! sandbox.launch (executable, 1 << 16)))
+        return ScanResult::workerNotLaunched;
+
+    if (sandbox.findAllTypesForFile (found, format.getName(), fileOrIdentifier))
+        return ScanResult::succeeded;
+
+    // The worker has crashed or hung, so it's replaced before the next scan
+    sandbox.killWorkerProcess();
+    return ScanResult::crashed;
+}
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class OutOfProcessPluginScannerTests final : public UnitTest
+{
+public:
+    OutOfProcessPluginScannerTests()
+        : UnitTest ("OutOfProcessPluginScanner", UnitTestCategories::audioProcessors)
+    {}
+
+    void runTest() override
+    {
+        TemporaryFile cacheFile (".xml");
+        TemporaryFile pluginFile (".plugin");
+        const auto plugin = pluginFile.getFile();
+        const auto noWorker = File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("noWorker", {});
+
+        MemoryBlock contents (200000);
+        getRandom().fillBitsRandomly (contents.getData(), contents.getSize());
+
+        // (as there's no worker executable, these scan in-process, through the format)
+        CountingFormat format;
+        auto scanner = createScanner (noWorker, cacheFile.getFile());
+
+        beginTest ("A file that hasn't been scanned before is scanned");
+        {
+            expect (plugin.replaceWithData (contents.getData(), contents.getSize()));
+            expectEquals (scan (*scanner, format, plugin), 1);
+            expectEquals (format.numScans, 1);
+            expect (scanner->getNumFilesScannedAndCached() == std::pair (1, 0));
+        }
+
+        beginTest ("A file that hasn't changed is found in the cache");
+        {
+            expectEquals (scan (*scanner, format, plugin), 1);
+            expectEquals (format.numScans, 1);
+            expect (scanner->getNumFilesScannedAndCached() == std::pair (1, 1));
+        }
+
+        beginTest ("A file that's only been touched is scanned again");
+        {
+            setModificationTime (plugin, 1);
+            expectEquals (scan (*scanner, format, plugin), 1);
+            expectEquals (format.numScans, 2);
+
+            expectEquals (scan (*scanner, format, plugin), 1);
+            expectEquals (format.numScans, 2);
+        }
+
+        beginTest ("A file that's been modified without changing its size is scanned again");
+        {
+            // (a rebuilt binary can easily be the same size, with the same header and trailer)
+            for (const auto index : { (size_t) 10, contents.getSize() / 2, contents.getSize() - 10 })
+            {
+                const auto numScans = format.numScans;
+
+                static_cast<char*> (contents.getData())[index] ^= 1;
+                expect (plugin.replaceWithData (contents.getData(), contents.getSize()));
+                setModificationTime (plugin, numScans + 2);
+
+                expectEquals (scan (*scanner, format, plugin), 1);
+                expectEquals (format.numScans, numScans + 1);
+            }
+        }
+
+        beginTest ("A file whose size has changed is scanned again");
+        {
+            const auto numScans = format.numScans;
+            expect (plugin.replaceWithData (contents.getData(), contents.getSize() - 1));
+            expectEquals (scan (*scanner, format, plugin), 1);
+            expectEquals (format.numScans, numScans + 1);
+        }
+
+        beginTest ("The cache is read back by a new scanner");
+        {
+            const auto numScans = format.numScans;
+
+            // (the cache is saved when the old scanner is deleted)
+            scanner.reset();
+            scanner = createScanner (noWorker, cacheFile.getFile());
+
+            expectEquals (scan (*scanner, format, plugin), 1);
+            expectEquals (format.numScans, numScans);
+            expect (scanner->getNumFilesScannedAndCached() == std::pair (0, 1));
+        }
+
+        beginTest ("Clearing the cache makes files get scanned again");
+        {
+            const auto numScans = format.numScans;
+            scanner->clearCache();
+
+            expectEquals (scan (*scanner, format, plugin), 1);
+            expectEquals (format.numScans, numScans + 1);
+        }
+
+        beginTest ("Files aren't scanned in-process by default if there's no worker");
+        {
+            const auto numScans = format.numScans;
+            OutOfProcessPluginScanner defaultScanner (noWorker, 1);
+
+            OwnedArray<PluginDescription> found;
+            expect (defaultScanner.findPluginTypesFor (format, found, plugin.getFullPathName()));
+            expect (found.isEmpty());
+            expectEquals (format.numScans, numScans);
+
+            // (and the failure isn't cached)
+            defaultScanner.setScanInProcessIfWorkerCantBeLaunched (true);
+            expectEquals (scan (defaultScanner, format, plugin), 1);
+            expectEquals (format.numScans, numScans + 1);
+        }
+
+        beginTest ("Plugins are only scanned on several threads by a scanner that allows it");
+        {
+            StringArray identifiers;
+
+            for (int i = 0; i < 16; ++i)
+                identifiers.add ("plugin" + String (i));
+
+            for (const auto scannerType : { 0, 1, 2 })
+            {
+                KnownPluginList list;
+                CountingFormat slowFormat;
+                slowFormat.scanTimeMs = 10;
+
+                // (no custom scanner, one that scans in this process, and one that can scan concurrently)
+                if (scannerType == 1)
+                    list.setCustomScanner (createScanner (noWorker, {}));
+                else if (scannerType == 2)
+                    list.setCustomScanner (std::make_unique<ConcurrentScanner>());
+
+                {
+                    PluginDirectoryScanner directoryScanner (list, slowFormat, {}, false, {});
+                    directoryScanner.setFilesOrIdentifiersToScan (identifiers);
+                    directoryScanner.scanRemainingFiles (false, 4);
+                }
+
+                expectEquals (slowFormat.numScans, identifiers.size());
+                expectEquals (list.getNumTypes(), identifiers.size());
+
+                if (scannerType == 2)
+                    expectGreaterThan (slowFormat.maxNumScansAtOnce, 1);
+                else
+                    expectEquals (slowFormat.maxNumScansAtOnce, 1);
+            }
+        }
+    }
+
+private:
+    struct CountingFormat final : public AudioPluginFormat
+    {
+        String getName() const override                                         { return "Counting"; }
+        bool fileMightContainThisPluginType (const String&) override            { return true; }
+        String getNameOfPluginFromIdentifier (const String& id) override        { return id; }
+        bool pluginNeedsRescanning (const PluginDescription&) override          { return false; }
+        bool doesPluginStillExist (const PluginDescription&) override           { return true; }
+        bool canScanForPlugins() const override                                 { return true; }
+        bool isTrivialToScan() const override                                   { return false; }
+        StringArray searchPathsForPlugins (const FileSearchPath&, bool, bool) override  { return {}; }
+        FileSearchPath getDefaultLocationsToSearch() override                   { return {}; }
+
+        void findAllTypesForFile (OwnedArray<PluginDescription>& results, const String& fileOrIdentifier) override
+        {
+            {
+                const ScopedLock sl (lock);
+                ++numScans;
+                maxNumScansAtOnce = jmax (maxNumScansAtOnce, ++numScansInProgress);
+            }
+
+            Thread::sleep (scanTimeMs);
+
+            {
+                const ScopedLock sl (lock);
+                --numScansInProgress;
+            }
+
+            auto desc = std::make_unique<PluginDescription>();
+            desc->name = "Plugin";
+            desc->pluginFormatName = getName();
+            desc->fileOrIdentifier = fileOrIdentifier;
+            results.add (std::move (desc));
+        }
+
+        bool requiresUnblockedMessageThreadDuringCreation (const PluginDescription&) const override  { return false; }
+        void createPluginInstance (const PluginDescription&, double, int, PluginCreationCallback callback) override
+        {
+            callback (nullptr, "Not supported");
+        }
+
+        CriticalSection lock;
+        int numScans = 0, numScansInProgress = 0, maxNumScansAtOnce = 0, scanTimeMs = 0;
+    };
+
+    struct ConcurrentScanner final : public KnownPluginList::CustomScanner
+    {
+        bool findPluginTypesFor (AudioPluginFormat& format, OwnedArray<PluginDescription>& result,
+                                 const String& fileOrIdentifier) override
+        {
+            format.findAllTypesForFile (result, fileOrIdentifier);
+            return true;
+        }
+
+        bool canScanConcurrently() const override   { return true; }
+    };
+
+    static std::unique_ptr<OutOfProcessPluginScanner> createScanner (const File& executable, const File& cacheFile)
+    {
+        auto scanner = std::make_unique<OutOfProcessPluginScanner> (executable, 1, cacheFile);
+        scanner->setScanInProcessIfWorkerCantBeLaunched (true);
+        return scanner;
+    }
+
+    static int scan (OutOfProcessPluginScanner& scanner, AudioPluginFormat& format, const File& file)
+    {
+        OwnedArray<PluginDescription> found;
+
+        if (! scanner.findPluginTypesFor (format, found, file.getFullPathName()))
+            return -1;
+
+        return found.size();
+    }
+
+    // (each step gets a different time, which is far enough apart for any filesystem to notice)
+    void setModificationTime (const File& file, int step)
+    {
+        expect (file.setLastModificationTime (Time (2020, 0, 1, 0, 0) + RelativeTime::hours (step)));
+    }
+};
+
+static OutOfProcessPluginScannerTests outOfProcessPluginScannerTests;
+
+#endif
+
+} // namespace juce
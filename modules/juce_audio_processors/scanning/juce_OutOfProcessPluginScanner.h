@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A KnownPluginList::CustomScanner that loads plugins in worker processes, so that
+    a plugin that crashes or hangs while it's being scanned can't bring down the host.
+
+    Each plugin is scanned by one of a pool of PluginSandbox worker processes, which
+    are started when they're first needed. Several plugins can be scanned at the same
+    time, by calling PluginDirectoryScanner::scanNextFile() from several threads, or by
+    using PluginDirectoryScanner::scanRemainingFiles(). If a worker crashes, or takes
+    longer than the timeout to scan a plugin, the worker is killed and the plugin is
+    added to the KnownPluginList's blacklist.
+
+    If you give it a cache file, the scanner remembers what it found in each file,
+    along with the file's size and modification time. When a file is scanned again,
+    the cached results are only used if both of these are unchanged, so a rescan only
+    needs to load the plugins that have changed.
+
+    The worker executable must create a PluginSandboxWorker and call its
+    PluginSandboxWorker::initialiseFromCommandLine() method when it starts up, and its
+    format manager must contain the formats that are going to be scanned. If a worker
+    can't be launched, the files it should have scanned are treated as having failed
+    to load: they're not blacklisted, and a PluginDirectoryScanner will list them in
+    PluginDirectoryScanner::getFailedFiles().
+
+    @code
+    knownPluginList.setCustomScanner (std::make_unique<OutOfProcessPluginScanner> (workerExe, 8, cacheFile));
+
+    PluginDirectoryScanner scanner (knownPluginList, format, path, true, {});
+    scanner.scanRemainingFiles (true, 8);
+    @endcode
+
+    @see PluginSandbox, PluginDirectoryScanner, KnownPluginList::setCustomScanner
+
+    @tags{Audio}
+*/
+class JUCE_API  OutOfProcessPluginScanner  : public KnownPluginList::CustomScanner
+{
+public:
+    //==============================================================================
+    /** Creates a scanner.
+
+        @param workerExecutable     the executable to launch for each worker process
+        @param maxNumWorkers        the largest number of worker processes to run at once
+        @param cacheFile            if this isn't File(), the results of each scan are
+                                    saved in this file, and read back the next time a
+                                    scanner is created
+    */
+    OutOfProcessPluginScanner (const File& workerExecutable = File::getSpecialLocation (File::currentExecutableFile),
+                               int maxNumWorkers = SystemStats::getNumCpus(),
+                               const File& cacheFile = {});
+
+    /** Destructor. */
+    ~OutOfProcessPluginScanner() override;
+
+    //==============================================================================
+    /** Sets how long a worker is allowed to spend scanning one file, before it's
+        assumed to have hung. The default is 30 seconds.
+    */
+    void setTimeoutPerFile (int timeoutMilliseconds);
+
+    /** If this is enabled and a worker process can't be launched, the file is scanned
+        in the host's own process instead, which means that a plugin which crashes will
+        take the host down with it. This is disabled by default.
+    */
+    void setScanInProcessIfWorkerCantBeLaunched (bool shouldScanInProcess);
+
+    /** Forgets all the cached results. */
+    void clearCache();
+
+    /** Returns the number of files that have been scanned by worker processes, and the
+        number whose results were found in the cache.
+    */
+    std::pair<int, int> getNumFilesScannedAndCached() const noexcept;
+
+    //==============================================================================
+    /** @internal */
+    bool findPluginTypesFor (AudioPluginFormat&, OwnedArray<PluginDescription>&, const String&) override;
+    /** @internal */
+    void scanFinished() override;
+    /** @internal */
+    bool canScanConcurrently() const override;
+
+private:
+    //==============================================================================
+    struct Worker;
+    class Cache;
+
+    const File executable;
+    const int maxNumWorkers;
+    std::atomic<int> timeoutMs { 30000 }, numFilesScanned { 0 }, numFilesCached { 0 };
+    std::atomic<bool> scanInProcessIfWorkerCantBeLaunched { false };
+
+    CriticalSection workersLock;
+    OwnedArray<Worker> workers;
+    WaitableEvent workerReleased;
+    CriticalSection inProcessScanLock;
+    std::unique_ptr<Cache> cache;
+
+    Worker* acquireWorker();
+    void releaseWorker (Worker&);
+    enum class ScanResult { succeeded, crashed, workerNotLaunched };
+
+    ScanResult scanInWorker (Worker&, AudioPluginFormat&, OwnedArray<PluginDescription>&, const String&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OutOfProcessPluginScanner)
+};
+
+} // namespace juce
@@ -105,14 +105,20 @@ bool PluginDirectoryScanner::scanNextFile (bool dontRescanIfAlreadyInList,
             OwnedArray<PluginDescription> typesFound;
 
             // Add this plugin to the end of the dead-man's pedal list in case it crashes...
-            auto crashedPlugins = readDeadMansPedalFile (deadMansPedalFile);
-            crashedPlugins.removeString (file);
-            crashedPlugins.add (file);
-            setDeadMansPedalFile (crashedPlugins);
+            {
+                const ScopedLock sl (lock);
+                auto crashedPlugins = readDeadMansPedalFile (deadMansPedalFile);
+                crashedPlugins.removeString (file);
+                crashedPlugins.add (file);
+                setDeadMansPedalFile (crashedPlugins);
+            }
 
             list.scanAndAddFile (file, dontRescanIfAlreadyInList, typesFound, format);
 
             // Managed to load without crashing, so remove it from the dead-man's-pedal..
+            // (this is re-read, as other threads may have changed it in the meantime)
+            const ScopedLock sl (lock);
+            auto crashedPlugins = readDeadMansPedalFile (deadMansPedalFile);
             crashedPlugins.removeString (file);
             setDeadMansPedalFile (crashedPlugins);
 
@@ -131,6 +137,49 @@ bool PluginDirectoryScanner::skipNextFile()
     return --nextIndex > 0;
 }
 
+void PluginDirectoryScanner::scanRemainingFiles (bool dontRescanIfAlreadyInList, int numThreads)
+{
+    struct ScanJob final : public ThreadPoolJob
+    {
+        ScanJob (PluginDirectoryScanner& s, bool dontRescan)
+            : ThreadPoolJob ("pluginscan"), scanner (s), dontRescanIfAlreadyInList (dontRescan) {}
+
+        JobStatus runJob() override
+        {
+            String nameOfPluginBeingScanned;
+
+            while (scanner.scanNextFile (dontRescanIfAlreadyInList, nameOfPluginBeingScanned) && ! shouldExit())
+            {}
+
+            return jobHasFinished;
+        }
+
+        PluginDirectoryScanner& scanner;
+        const bool dontRescanIfAlreadyInList;
+    };
+
+    // Without a suitable custom scanner, the plugins are loaded in this process, and most
+    // formats can't cope with loading several at once
+    if (numThreads <= 1 || ! list.canScanConcurrently())
+    {
+        String nameOfPluginBeingScanned;
+
+        while (scanNextFile (dontRescanIfAlreadyInList, nameOfPluginBeingScanned))
+        {}
+
+        return;
+    }
+
+    OwnedArray<ScanJob> jobs;
+    ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (numThreads));
+
+    for (int i = 0; i < numThreads; ++i)
+        pool.addJob (jobs.add (new ScanJob (*this, dontRescanIfAlreadyInList)), false);
+
+    for (auto* job : jobs)
+        pool.waitForJobToFinish (job, -1);
+}
+
 void PluginDirectoryScanner::setDeadMansPedalFile (const StringArray& newContents)
 {
     if (deadMansPedalFile.getFullPathName().isNotEmpty())
@@ -40,7 +40,12 @@ namespace juce
     Scans a directory for plugins, and adds them to a KnownPluginList.
 
     To use one of these, create it and call scanNextFile() repeatedly, until
-    it returns false.
+    it returns false. scanNextFile() can be called by several threads at once, or
+    you can use scanRemainingFiles() to do this for you.
+
+    Scanning a plugin loads it into the host, so a plugin that crashes will take
+    the host down with it. To avoid this, give the KnownPluginList an
+    OutOfProcessPluginScanner.
 
     @tags{Audio}
 */
@@ -107,6 +112,16 @@ public:
     */
     bool skipNextFile();
 
+    /** Scans all the files that haven't been scanned yet, using the given number of
+        threads, and returns when they're finished.
+
+        Several threads are only used if the KnownPluginList has a custom scanner which
+        can scan several plugins at the same time, such as OutOfProcessPluginScanner.
+        Otherwise the files are scanned one at a time on the calling thread. The
+        dontRescanIfAlreadyInList flag has the same meaning as for scanNextFile().
+    */
+    void scanRemainingFiles (bool dontRescanIfAlreadyInList, int numThreads);
+
     /** Returns the description of the plugin that will be scanned during the next
         call to scanNextFile().
 
@@ -134,6 +149,7 @@ private:
     StringArray filesOrIdentifiersToScan;
     File deadMansPedalFile;
     StringArray failedFiles;
+    CriticalSection lock;
     Atomic<int> nextIndex;
     std::atomic<float> progress { 0.0f };
     const bool allowAsync;
@@ -57,13 +57,17 @@ namespace juce
     To make all the array's methods thread-safe, pass in "CriticalSection" as the templated
     TypeOfCriticalSectionToUse parameter, instead of the default DummyCriticalSection.
 
-    @see OwnedArray, ReferenceCountedArray, StringArray, CriticalSection
+    If numInlineElements is more than zero, the array can hold that many elements without
+    allocating any memory - see SmallArray.
+
+    @see SmallArray, OwnedArray, ReferenceCountedArray, StringArray, CriticalSection
 
     @tags{Core}
 */
 template <typename ElementType,
           typename TypeOfCriticalSectionToUse = DummyCriticalSection,
-          int minimumAllocatedSize = 0>
+          int minimumAllocatedSize = 0,
+          int numInlineElements = 0>
 class Array
 {
 private:
@@ -1115,7 +1119,7 @@ public:
 
 private:
     //==============================================================================
-    ArrayBase<ElementType, TypeOfCriticalSectionToUse> values;
+    ArrayBase<ElementType, TypeOfCriticalSectionToUse, numInlineElements> values;
 
     void removeInternal (int indexToRemove)
     {
@@ -1131,9 +1135,9 @@ private:
 };
 
 //==============================================================================
-template <typename ElementType, typename TypeOfCriticalSectionToUse, int minimumAllocatedSize>
+template <typename ElementType, typename TypeOfCriticalSectionToUse, int minimumAllocatedSize, int numInlineElements>
 template <typename ElementComparator, typename TargetValueType>
-int Array<ElementType, TypeOfCriticalSectionToUse, minimumAllocatedSize>::indexOfSorted (
+int Array<ElementType, TypeOfCriticalSectionToUse, minimumAllocatedSize, numInlineElements>::indexOfSorted (
     [[maybe_unused]] ElementComparator& comparator,
     TargetValueType elementToLookFor) const
 {
@@ -1159,9 +1163,9 @@ int Array<ElementType, TypeOfCriticalSectionToUse, minimumAllocatedSize>::indexO
     }
 }
 
-template <typename ElementType, typename TypeOfCriticalSectionToUse, int minimumAllocatedSize>
+template <typename ElementType, typename TypeOfCriticalSectionToUse, int minimumAllocatedSize, int numInlineElements>
 template <class ElementComparator>
-void Array<ElementType, TypeOfCriticalSectionToUse, minimumAllocatedSize>::sort (
+void Array<ElementType, TypeOfCriticalSectionToUse, minimumAllocatedSize, numInlineElements>::sort (
     [[maybe_unused]] ElementComparator& comparator,
     bool retainOrderOfEquivalentItems)
 {
@@ -1169,4 +1173,26 @@ void Array<ElementType, TypeOfCriticalSectionToUse, minimumAllocatedSize>::sort
     sortArray (comparator, values.begin(), 0, size() - 1, retainOrderOfEquivalentItems);
 }
 
+//==============================================================================
+/**
+    An Array that keeps its first few elements inside the object itself.
+
+    A SmallArray behaves exactly like an Array, but it only allocates heap memory
+    once it holds more than numInlineElements items, so it's a good choice for
+    short-lived or frequently-copied lists which are usually small.
+
+    The elements must be safe to relocate in memory, so the same restrictions
+    apply as for Array. Note that the inline elements also make the object itself
+    bigger, and that moving or swapping a SmallArray has to move its elements
+    when they're stored inline.
+
+    @see Array
+
+    @tags{Core}
+*/
+template <typename ElementType,
+          int numInlineElements,
+          typename TypeOfCriticalSectionToUse = DummyCriticalSection>
+using SmallArray = Array<ElementType, TypeOfCriticalSectionToUse, 0, numInlineElements>;
+
 } // namespace juce
@@ -549,6 +549,103 @@ public:
             expectEquals (derived.size(), 0);
             expect (derived.data() == nullptr);
         }
+
+        beginTest ("inline storage");
+        {
+            std::vector<CopyableType> referenceContainer;
+            ArrayBase<CopyableType,    DummyCriticalSection, 4> copyableContainer;
+            ArrayBase<NoncopyableType, DummyCriticalSection, 4> noncopyableContainer;
+
+            auto* inlineCopyable    = copyableContainer.data();
+            auto* inlineNoncopyable = noncopyableContainer.data();
+
+            expectEquals (copyableContainer.capacity(), 4);
+            expect (inlineCopyable != nullptr && inlineNoncopyable != nullptr);
+
+            addData (referenceContainer, copyableContainer, noncopyableContainer, 4);
+
+            expectEquals (copyableContainer.capacity(), 4);
+            expect (copyableContainer.data() == inlineCopyable);
+            expect (noncopyableContainer.data() == inlineNoncopyable);
+            checkEqual (copyableContainer, noncopyableContainer, referenceContainer);
+
+            addData (referenceContainer, copyableContainer, noncopyableContainer, 10);
+
+            expectGreaterThan (copyableContainer.capacity(), 4);
+            expect (copyableContainer.data() != inlineCopyable);
+            expect (noncopyableContainer.data() != inlineNoncopyable);
+            checkEqual (copyableContainer, noncopyableContainer, referenceContainer);
+
+            referenceContainer.erase (referenceContainer.begin() + 1, referenceContainer.end() - 2);
+            copyableContainer.removeElements    (1, 11);
+            noncopyableContainer.removeElements (1, 11);
+
+            copyableContainer.shrinkToNoMoreThan    (copyableContainer.size());
+            noncopyableContainer.shrinkToNoMoreThan (noncopyableContainer.size());
+
+            expectEquals (copyableContainer.capacity(), 4);
+            expect (copyableContainer.data() == inlineCopyable);
+            expect (noncopyableContainer.data() == inlineNoncopyable);
+            checkEqual (copyableContainer, noncopyableContainer, referenceContainer);
+        }
+
+        beginTest ("inline storage move and swap");
+        {
+            std::vector<CopyableType> smallReference, largeReference;
+            ArrayBase<CopyableType,    DummyCriticalSection, 4> smallCopyable,    largeCopyable;
+            ArrayBase<NoncopyableType, DummyCriticalSection, 4> smallNoncopyable, largeNoncopyable;
+
+            addData (smallReference, smallCopyable, smallNoncopyable, 3);
+            addData (largeReference, largeCopyable, largeNoncopyable, 9);
+
+            smallCopyable.swapWith    (largeCopyable);
+            smallNoncopyable.swapWith (largeNoncopyable);
+
+            checkEqual (smallCopyable, smallNoncopyable, largeReference);
+            checkEqual (largeCopyable, largeNoncopyable, smallReference);
+
+            auto movedSmallCopyable    = std::move (largeCopyable);
+            auto movedSmallNoncopyable = std::move (largeNoncopyable);
+
+            checkEqual (movedSmallCopyable, movedSmallNoncopyable, smallReference);
+            expectEquals (largeCopyable.size(), 0);
+            expectEquals (largeNoncopyable.capacity(), 4);
+
+            movedSmallCopyable    = std::move (smallCopyable);
+            movedSmallNoncopyable = std::move (smallNoncopyable);
+
+            checkEqual (movedSmallCopyable, movedSmallNoncopyable, largeReference);
+            expectEquals (smallCopyable.size(), 0);
+            expectEquals (smallNoncopyable.capacity(), 4);
+        }
+
+        beginTest ("SmallArray");
+        {
+            SmallArray<String, 2> small;
+            Array<String> reference;
+
+            for (auto* text : { "one", "two", "three", "four", "five" })
+            {
+                small.add (text);
+                reference.add (text);
+                expect (small == reference);
+            }
+
+            small.insert (1, "inserted");
+            reference.insert (1, "inserted");
+            small.removeRange (2, 3);
+            reference.removeRange (2, 3);
+            expect (small == reference);
+
+            auto copy = small;
+            small.clearQuick();
+            small.minimiseStorageOverheads();
+            expect (small.isEmpty());
+            expect (copy == reference);
+
+            small.addArray (copy);
+            expect (small == reference);
+        }
     }
 
 private:
@@ -561,9 +658,10 @@ private:
     {
     };
 
+    template <int numInlineElements>
     static void addData (std::vector<CopyableType>& referenceContainer,
-                         ArrayBase<CopyableType,    DummyCriticalSection>& copyableContainer,
-                         ArrayBase<NoncopyableType, DummyCriticalSection>& NoncopyableContainer,
+                         ArrayBase<CopyableType,    DummyCriticalSection, numInlineElements>& copyableContainer,
+                         ArrayBase<NoncopyableType, DummyCriticalSection, numInlineElements>& NoncopyableContainer,
                          int numValues)
     {
         for (int i = 0; i < numValues; ++i)
@@ -574,9 +672,9 @@ private:
         }
     }
 
-    template <typename A, typename B>
-    void checkEqual (const ArrayBase<A, DummyCriticalSection>& a,
-                     const ArrayBase<B, DummyCriticalSection>& b)
+    template <typename A, typename B, int numInlineElements>
+    void checkEqual (const ArrayBase<A, DummyCriticalSection, numInlineElements>& a,
+                     const ArrayBase<B, DummyCriticalSection, numInlineElements>& b)
     {
         expectEquals ((int) a.size(), (int) b.size());
 
@@ -584,8 +682,8 @@ private:
             expect (a[i] == b[i]);
     }
 
-    template <typename A, typename B>
-    void checkEqual (ArrayBase<A, DummyCriticalSection>& a,
+    template <typename A, typename B, int numInlineElements>
+    void checkEqual (ArrayBase<A, DummyCriticalSection, numInlineElements>& a,
                      std::vector<B>& b)
     {
         expectEquals ((int) a.size(), (int) b.size());
@@ -594,9 +692,9 @@ private:
             expect (a[i] == b[(size_t) i]);
     }
 
-    template <typename A, typename B, typename C>
-    void checkEqual (ArrayBase<A, DummyCriticalSection>& a,
-                     ArrayBase<B, DummyCriticalSection>& b,
+    template <typename A, typename B, typename C, int numInlineElements>
+    void checkEqual (ArrayBase<A, DummyCriticalSection, numInlineElements>& a,
+                     ArrayBase<B, DummyCriticalSection, numInlineElements>& b,
                      std::vector<C>& c)
     {
         checkEqual (a, b);
@@ -35,6 +35,86 @@
 namespace juce
 {
 
+#ifndef DOXYGEN
+namespace detail
+{
+
+/*  The storage used by an ArrayBase that keeps its first few elements inside the
+    object itself, and only moves them to the heap once there are too many to fit.
+*/
+template <class ElementType, int numInlineElements>
+class InlineArrayStorage
+{
+public:
+    InlineArrayStorage() noexcept = default;
+
+    operator ElementType*() const noexcept
+    {
+        return heapElements != nullptr ? heapElements.get() : getInlineElements();
+    }
+
+    // Moves the live elements to storage with room for the given number of elements
+    void reallocate (int newCapacity, int numUsed)
+    {
+        if (newCapacity <= numInlineElements)
+        {
+            if (heapElements != nullptr)
+            {
+                relocate (heapElements, getInlineElements(), numUsed);
+                heapElements.free();
+            }
+
+            return;
+        }
+
+        HeapBlock<ElementType> newElements ((size_t) newCapacity);
+        relocate (*this, newElements, numUsed);
+        heapElements = std::move (newElements);
+    }
+
+    // Takes all the elements from another storage. This one must not have any elements.
+    void takeFrom (InlineArrayStorage& other, int numUsed) noexcept
+    {
+        jassert (heapElements == nullptr);
+
+        if (other.heapElements != nullptr)
+            heapElements = std::move (other.heapElements);
+        else
+            relocate (other.getInlineElements(), getInlineElements(), numUsed);
+    }
+
+private:
+    ElementType* getInlineElements() const noexcept
+    {
+        return reinterpret_cast<ElementType*> (const_cast<char*> (inlineElements));
+    }
+
+    static void relocate (ElementType* source, ElementType* destination, int numElements) noexcept
+    {
+        if constexpr (std::is_trivially_copyable_v<ElementType>)
+        {
+            if (numElements > 0)
+                memcpy (destination, source, (size_t) numElements * sizeof (ElementType));
+        }
+        else
+        {
+            for (int i = 0; i < numElements; ++i)
+            {
+                new (destination + i) ElementType (std::move (source[i]));
+                source[i].~ElementType();
+            }
+        }
+    }
+
+    HeapBlock<ElementType> heapElements;
+    alignas (ElementType) char inlineElements[sizeof (ElementType) * (size_t) numInlineElements];
+
+    JUCE_DECLARE_NON_COPYABLE (InlineArrayStorage)
+};
+
+} // namespace detail
+#endif
+
 /**
     A basic object container.
 
@@ -44,11 +124,14 @@ namespace juce
     It inherits from a critical section class to allow the arrays to use
     the "empty base class optimisation" pattern to reduce their footprint.
 
+    If numInlineElements is more than zero, that many elements are stored inside
+    the object itself, and the heap is only used if the array grows beyond them.
+
     @see Array, OwnedArray, ReferenceCountedArray
 
     @tags{Core}
 */
-template <class ElementType, class TypeOfCriticalSectionToUse>
+template <class ElementType, class TypeOfCriticalSectionToUse, int numInlineElements = 0>
 class ArrayBase  : public TypeOfCriticalSectionToUse
 {
 private:
@@ -71,12 +154,8 @@ public:
     }
 
     ArrayBase (ArrayBase&& other) noexcept
-        : elements (std::move (other.elements)),
-          numAllocated (other.numAllocated),
-          numUsed (other.numUsed)
     {
-        other.numAllocated = 0;
-        other.numUsed = 0;
+        takeElementsFrom (other);
     }
 
     ArrayBase& operator= (ArrayBase&& other) noexcept
@@ -103,6 +182,7 @@ public:
           numAllocated (other.numAllocated),
           numUsed (other.numUsed)
     {
+        static_assert (numInlineElements == 0, "Arrays with inline storage can't be converted");
         other.numAllocated = 0;
         other.numUsed = 0;
     }
@@ -117,6 +197,8 @@ public:
               typename = AllowConversion<OtherElementType, OtherCriticalSection>>
     ArrayBase& operator= (ArrayBase<OtherElementType, OtherCriticalSection>&& other) noexcept
     {
+        static_assert (numInlineElements == 0, "Arrays with inline storage can't be converted");
+
         // No need to worry about assignment to *this, because 'other' must be of a different type.
         elements = std::move (other.elements);
         numAllocated = other.numAllocated;
@@ -226,7 +308,14 @@ public:
     {
         jassert (numElements >= numUsed);
 
-        if (numAllocated != numElements)
+        if constexpr (numInlineElements > 0)
+        {
+            numElements = jmax (numElements, (int) numInlineElements);
+
+            if (numAllocated != numElements)
+                elements.reallocate (numElements, numUsed);
+        }
+        else if (numAllocated != numElements)
         {
             if (numElements > 0)
                 setAllocatedSizeInternal (numElements);
@@ -262,9 +351,18 @@ public:
     //==============================================================================
     void swapWith (ArrayBase& other) noexcept
     {
-        elements.swapWith (other.elements);
-        std::swap (numAllocated, other.numAllocated);
-        std::swap (numUsed,      other.numUsed);
+        if constexpr (numInlineElements > 0)
+        {
+            ArrayBase temp (std::move (other));
+            other.takeElementsFrom (*this);
+            takeElementsFrom (temp);
+        }
+        else
+        {
+            elements.swapWith (other.elements);
+            std::swap (numAllocated, other.numAllocated);
+            std::swap (numUsed,      other.numUsed);
+        }
     }
 
     //==============================================================================
@@ -406,6 +504,22 @@ private:
     static constexpr auto isTriviallyCopyable = std::is_trivially_copyable_v<ElementType>;
    #endif
 
+    //==============================================================================
+    // This array must be empty and have no heap storage; the other one is left in the same state
+    void takeElementsFrom (ArrayBase& other) noexcept
+    {
+        if constexpr (numInlineElements > 0)
+            elements.takeFrom (other.elements, other.numUsed);
+        else
+            elements = std::move (other.elements);
+
+        numAllocated = other.numAllocated;
+        numUsed = other.numUsed;
+
+        other.numAllocated = numInlineElements;
+        other.numUsed = 0;
+    }
+
     //==============================================================================
     template <typename Type>
     void addArrayInternal (const Type* otherElements, int numElements)
@@ -593,10 +707,14 @@ private:
     }
 
     //==============================================================================
-    HeapBlock<ElementType> elements;
-    int numAllocated = 0, numUsed = 0;
+    using StorageType = std::conditional_t<numInlineElements == 0,
+                                           HeapBlock<ElementType>,
+                                           detail::InlineArrayStorage<ElementType, numInlineElements>>;
 
-    template <class OtherElementType, class OtherCriticalSection>
+    StorageType elements;
+    int numAllocated = numInlineElements, numUsed = 0;
+
+    template <class OtherElementType, class OtherCriticalSection, int otherNumInlineElements>
     friend class ArrayBase;
 
     JUCE_DECLARE_NON_COPYABLE (ArrayBase)
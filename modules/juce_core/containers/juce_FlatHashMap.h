@@ -0,0 +1,735 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Generates full-width hash codes for the FlatHashMap and FlatHashSet classes.
+
+    Unlike DefaultHashFunctions, these return the whole hash rather than reducing it
+    to a slot index, so that the table can pick its own bits. Strings are hashed by
+    their characters, which means that a String, a StringRef, a const char* and an
+    Identifier with the same text all produce the same hash, and any of them can be
+    used to look up a string-keyed table without constructing a temporary String.
+
+    @see FlatHashMap, FlatHashSet
+
+    @tags{Core}
+*/
+struct DefaultFlatHashFunctions
+{
+    /** Generates a hash from an integer. */
+    template <typename IntegerType, std::enable_if_t<std::is_integral_v<IntegerType>, int> = 0>
+    static uint64 generateHash (IntegerType key) noexcept       { return (uint64) key; }
+    /** Generates a hash from a pointer. */
+    template <typename PointedType>
+    static uint64 generateHash (PointedType* key) noexcept      { return (uint64) (pointer_sized_uint) key; }
+    /** Generates a hash from a string. */
+    static uint64 generateHash (const String& key) noexcept     { return (uint64) key.hashCode64(); }
+    /** Generates a hash from a string. */
+    static uint64 generateHash (StringRef key) noexcept         { return hashCharacters (key.text); }
+    /** Generates a hash from a string. */
+    static uint64 generateHash (const char* key) noexcept       { return hashCharacters (CharPointer_UTF8 (key)); }
+    /** Generates a hash from an Identifier. */
+    static uint64 generateHash (const Identifier& key) noexcept { return generateHash (key.toString()); }
+    /** Generates a hash from a variant. */
+    static uint64 generateHash (const var& key) noexcept        { return generateHash (key.toString()); }
+    /** Generates a hash from a UUID. */
+    static uint64 generateHash (const Uuid& key) noexcept       { return key.hash(); }
+
+private:
+    // This must match String::hashCode64(), so that all the string-like types agree
+    template <typename CharPointer>
+    static uint64 hashCharacters (CharPointer t) noexcept
+    {
+        uint64 result = 0;
+
+        while (! t.isEmpty())
+            result = 101 * result + (uint64) t.getAndAdvance();
+
+        return result;
+    }
+};
+
+#ifndef DOXYGEN
+namespace detail
+{
+
+/*  The open-addressing table shared by FlatHashMap and FlatHashSet.
+
+    Entries live directly in one contiguous array and collisions are resolved by linear
+    probing with Robin Hood ordering: an entry being inserted displaces any entry that is
+    closer to its own ideal slot, so that probe lengths stay short and uniform, and a
+    lookup can stop as soon as it meets an entry that is closer to home than the key it's
+    looking for would be. Removal shifts the following entries back into the gap rather
+    than leaving tombstones, so the table never degrades after many removals.
+
+    A parallel array of bytes stores each slot's probe distance plus one (zero meaning
+    empty), so that probing mostly touches that small array rather than the entries.
+*/
+template <typename EntryType, class HashFunctionType>
+class FlatHashTable
+{
+public:
+    explicit FlatHashTable (HashFunctionType hashFunction) : hashFunctionToUse (hashFunction) {}
+
+    FlatHashTable (const FlatHashTable& other)
+        : hashFunctionToUse (other.hashFunctionToUse)
+    {
+        if (other.numItems == 0)
+            return;
+
+        allocate (other.getNumSlots());
+
+        for (size_t i = 0; i < getNumSlots(); ++i)
+        {
+            if (other.distances[i] != 0)
+            {
+                new (entries + i) EntryType (other.entries[i]);
+                distances[i] = other.distances[i];
+                ++numItems;
+            }
+        }
+    }
+
+    // Only the slots are swapped, as swapping the hash functions too would hand the moved
+    // entries back the other table's moved-from one
+    FlatHashTable (FlatHashTable&& other) noexcept
+        : hashFunctionToUse (std::move (other.hashFunctionToUse))
+    {
+        swapSlotsWith (other);
+    }
+
+    FlatHashTable& operator= (const FlatHashTable& other)
+    {
+        if (this != &other)
+        {
+            auto copy (other);
+            swapWith (copy);
+        }
+
+        return *this;
+    }
+
+    FlatHashTable& operator= (FlatHashTable&& other) noexcept
+    {
+        auto moved (std::move (other));
+        swapWith (moved);
+        return *this;
+    }
+
+    ~FlatHashTable()                            { clear(); }
+
+    void swapWith (FlatHashTable& other) noexcept
+    {
+        std::swap (hashFunctionToUse, other.hashFunctionToUse);
+        swapSlotsWith (other);
+    }
+
+    int size() const noexcept                   { return numItems; }
+    size_t getNumSlots() const noexcept         { return distances != nullptr ? mask + 1 : 0; }
+
+    void clear() noexcept
+    {
+        if (numItems > 0)
+        {
+            for (size_t i = 0; i < getNumSlots(); ++i)
+            {
+                if (distances[i] != 0)
+                {
+                    entries[i].~EntryType();
+                    distances[i] = 0;
+                }
+            }
+        }
+
+        numItems = 0;
+    }
+
+    void reserve (int numItemsNeeded)
+    {
+        auto numSlots = getNumSlots();
+
+        while (isOverloaded (numItemsNeeded, numSlots))
+            numSlots = jmax ((size_t) minimumNumSlots, numSlots * 2);
+
+        if (numSlots != getNumSlots())
+            rehash (numSlots);
+    }
+
+    template <typename OtherKeyType>
+    EntryType* find (const OtherKeyType& key) const noexcept
+    {
+        if (numItems == 0)
+            return nullptr;
+
+        auto index = getIdealSlot (hashFunctionToUse.generateHash (key));
+
+        for (uint8 distance = 1;; ++distance)
+        {
+            auto slotDistance = distances[index];
+
+            if (slotDistance < distance)
+                return nullptr;
+
+            if (slotDistance == distance && keysMatch (entries[index].key, key))
+                return entries + index;
+
+            index = (index + 1) & mask;
+        }
+    }
+
+    template <typename OtherKeyType, typename CreateEntry>
+    EntryType& findOrInsert (const OtherKeyType& key, CreateEntry&& createEntry)
+    {
+        if (auto* existing = find (key))
+            return *existing;
+
+        if (isOverloaded (numItems + 1, getNumSlots()))
+            rehash (jmax ((size_t) minimumNumSlots, getNumSlots() * 2));
+
+        auto hash = hashFunctionToUse.generateHash (key);
+        insertNewEntry (createEntry(), hash);
+        ++numItems;
+
+        // The new entry may have been displaced along its probe sequence, so look it up again
+        return *find (key);
+    }
+
+    template <typename OtherKeyType>
+    bool remove (const OtherKeyType& key)
+    {
+        auto* entry = find (key);
+
+        if (entry == nullptr)
+            return false;
+
+        auto index = (size_t) (entry - entries);
+        auto next = (index + 1) & mask;
+
+        while (distances[next] > 1)
+        {
+            entries[index] = std::move (entries[next]);
+            distances[index] = (uint8) (distances[next] - 1);
+            index = next;
+            next = (next + 1) & mask;
+        }
+
+        entries[index].~EntryType();
+        distances[index] = 0;
+        --numItems;
+        return true;
+    }
+
+    template <typename Predicate>
+    void removeIf (Predicate&& shouldRemove)
+    {
+        for (size_t i = 0; i < getNumSlots();)
+        {
+            if (distances[i] != 0 && shouldRemove (entries[i]))
+            {
+                // Copy the key first, as removing this entry may shift another one into its slot
+                auto key = entries[i].key;
+                remove (key);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    //==============================================================================
+    template <typename Table, typename Entry>
+    struct IteratorBase
+    {
+        IteratorBase (Table& t, size_t i) noexcept  : table (&t), index (i)   { skipEmptySlots(); }
+
+        Entry& operator*() const noexcept           { return table->entries[index]; }
+        Entry* operator->() const noexcept          { return table->entries + index; }
+
+        IteratorBase& operator++() noexcept         { ++index; skipEmptySlots(); return *this; }
+
+        bool operator== (const IteratorBase& other) const noexcept  { return index == other.index; }
+        bool operator!= (const IteratorBase& other) const noexcept  { return index != other.index; }
+
+    private:
+        void skipEmptySlots() noexcept
+        {
+            while (index < table->getNumSlots() && table->distances[index] == 0)
+                ++index;
+        }
+
+        Table* table;
+        size_t index;
+    };
+
+    using Iterator      = IteratorBase<FlatHashTable, EntryType>;
+    using ConstIterator = IteratorBase<const FlatHashTable, const EntryType>;
+
+    Iterator begin() noexcept                   { return { *this, 0 }; }
+    Iterator end() noexcept                     { return { *this, getNumSlots() }; }
+    ConstIterator begin() const noexcept        { return { *this, 0 }; }
+    ConstIterator end() const noexcept          { return { *this, getNumSlots() }; }
+
+private:
+    enum { minimumNumSlots = 8 };
+
+    void swapSlotsWith (FlatHashTable& other) noexcept
+    {
+        entries.swapWith (other.entries);
+        distances.swapWith (other.distances);
+        std::swap (mask, other.mask);
+        std::swap (numSlotBits, other.numSlotBits);
+        std::swap (numItems, other.numItems);
+    }
+
+    // Comparing mixed string-like types via StringRef avoids ambiguous operator== overloads
+    using KeyType = decltype (EntryType::key);
+
+    template <typename OtherKeyType>
+    static bool keysMatch (const KeyType& key, const OtherKeyType& other) noexcept
+    {
+        if constexpr (! std::is_same_v<KeyType, OtherKeyType>
+                        && std::is_convertible_v<const KeyType&, StringRef>
+                        && std::is_convertible_v<const OtherKeyType&, StringRef>)
+            return StringRef (key) == StringRef (other);
+        else
+            return key == other;
+    }
+
+    // Keeps the load factor at or below 7/8, which Robin Hood probing handles comfortably
+    static bool isOverloaded (int numItemsNeeded, size_t numSlots) noexcept
+    {
+        return (size_t) numItemsNeeded * 8 > numSlots * 7;
+    }
+
+    // Fibonacci hashing spreads weak hashes such as small integers over the whole table
+    size_t getIdealSlot (uint64 hash) const noexcept
+    {
+        return (size_t) ((hash * 0x9e3779b97f4a7c15ull) >> (64 - numSlotBits)) & mask;
+    }
+
+    void allocate (size_t numSlots)
+    {
+        jassert (isPowerOfTwo (numSlots));
+
+        entries.malloc (numSlots);
+        distances.calloc (numSlots);
+        mask = numSlots - 1;
+        numSlotBits = 0;
+
+        while (((size_t) 1 << numSlotBits) < numSlots)
+            ++numSlotBits;
+    }
+
+    void rehash (size_t newNumSlots)
+    {
+        auto oldNumSlots = getNumSlots();
+        auto oldEntries = std::move (entries);
+        auto oldDistances = std::move (distances);
+
+        allocate (newNumSlots);
+
+        for (size_t i = 0; i < oldNumSlots; ++i)
+        {
+            if (oldDistances[i] != 0)
+            {
+                auto& entry = oldEntries[i];
+                auto hash = hashFunctionToUse.generateHash (entry.key);
+                insertNewEntry (std::move (entry), hash);
+                entry.~EntryType();
+            }
+        }
+    }
+
+    void insertNewEntry (EntryType&& newEntry, uint64 hash)
+    {
+        EntryType carried (std::move (newEntry));
+        auto index = getIdealSlot (hash);
+        uint8 distance = 1;
+
+        for (;;)
+        {
+            auto slotDistance = distances[index];
+
+            if (slotDistance == 0)
+            {
+                new (entries + index) EntryType (std::move (carried));
+                distances[index] = distance;
+                return;
+            }
+
+            if (slotDistance < distance)
+            {
+                std::swap (carried, entries[index]);
+                std::swap (distance, distances[index]);
+            }
+
+            index = (index + 1) & mask;
+
+            if (++distance == std::numeric_limits<uint8>::max())
+            {
+                // A pathologically clustered hash: every entry placed so far is still valid, so
+                // grow the table and carry on inserting the one that's left over. If this happens
+                // while the table is mostly empty, your hash function is producing lots of
+                // identical values, and growing won't help for long!
+                jassert ((size_t) numItems * 4 > getNumSlots());
+                rehash (getNumSlots() * 2);
+                insertNewEntry (std::move (carried), hashFunctionToUse.generateHash (carried.key));
+                return;
+            }
+        }
+    }
+
+    HashFunctionType hashFunctionToUse;
+    HeapBlock<EntryType> entries;
+    HeapBlock<uint8> distances;
+    size_t mask = 0;
+    int numSlotBits = 0, numItems = 0;
+};
+
+} // namespace detail
+#endif
+
+//==============================================================================
+/**
+    A hash map that stores its keys and values directly in a single flat array.
+
+    This is an alternative to HashMap for performance-sensitive code. HashMap allocates
+    a separate node for every item and follows a linked list for each lookup, whereas
+    FlatHashMap uses open addressing, so a lookup is usually a few adjacent reads within
+    the same cache line, and adding items doesn't allocate except when the table grows.
+
+    The trade-offs are that adding or removing items may move other items around, so
+    references to values are only valid until the next non-const call, and that unlike
+    HashMap there's no built-in lock.
+
+    The hash function class must provide a function of the form:
+    @code
+    struct MyHashGenerator
+    {
+        uint64 generateHash (const MyKeyType& key) const;
+    };
+    @endcode
+
+    It may provide overloads for other types that compare equal to the key type, in which
+    case any of those types can be used for lookups. With the default hash functions, a
+    FlatHashMap<String, ...> can be searched with a StringRef, const char* or Identifier.
+
+    @code
+    FlatHashMap<String, int> map;
+    map.set ("one", 1);
+    map.set ("two", 2);
+
+    DBG (map["one"]); // prints "1"
+
+    for (auto& item : map)
+        DBG (item.key << " -> " << item.value);
+    @endcode
+
+    @see HashMap, FlatHashSet, DefaultFlatHashFunctions
+
+    @tags{Core}
+*/
+template <typename KeyType,
+          typename ValueType,
+          class HashFunctionType = DefaultFlatHashFunctions>
+class FlatHashMap
+{
+private:
+    using KeyTypeParameter   = typename TypeHelpers::ParameterType<KeyType>::type;
+    using ValueTypeParameter = typename TypeHelpers::ParameterType<ValueType>::type;
+
+public:
+    /** The type of the items that the map holds.
+        You must not modify the key of an item that's in the map.
+    */
+    struct Entry
+    {
+        KeyType key;
+        ValueType value;
+    };
+
+    //==============================================================================
+    /** Creates an empty map. */
+    explicit FlatHashMap (HashFunctionType hashFunction = HashFunctionType())
+        : table (hashFunction)
+    {}
+
+    //==============================================================================
+    /** Returns the number of items in the map. */
+    int size() const noexcept                                   { return table.size(); }
+
+    /** Returns true if the map is empty. */
+    bool isEmpty() const noexcept                               { return table.size() == 0; }
+
+    /** Removes all items from the map, keeping its storage allocated. */
+    void clear() noexcept                                       { table.clear(); }
+
+    /** Makes sure there's enough space to hold the given number of items without
+        having to reallocate.
+    */
+    void reserve (int numItemsNeeded)                           { table.reserve (numItemsNeeded); }
+
+    //==============================================================================
+    /** Returns the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is returned.
+    */
+    template <typename OtherKeyType>
+    ValueType operator[] (const OtherKeyType& keyToLookFor) const
+    {
+        if (auto* entry = table.find (keyToLookFor))
+            return entry->value;
+
+        return ValueType();
+    }
+
+    /** Returns a pointer to the value corresponding to a given key, or nullptr if the
+        map doesn't contain it.
+        The pointer is only valid until the map is next modified.
+    */
+    template <typename OtherKeyType>
+    ValueType* find (const OtherKeyType& keyToLookFor) noexcept
+    {
+        if (auto* entry = table.find (keyToLookFor))
+            return &(entry->value);
+
+        return nullptr;
+    }
+
+    /** Returns a pointer to the value corresponding to a given key, or nullptr if the
+        map doesn't contain it.
+        The pointer is only valid until the map is next modified.
+    */
+    template <typename OtherKeyType>
+    const ValueType* find (const OtherKeyType& keyToLookFor) const noexcept
+    {
+        if (auto* entry = table.find (keyToLookFor))
+            return &(entry->value);
+
+        return nullptr;
+    }
+
+    /** Returns true if the map contains an item with the specified key. */
+    template <typename OtherKeyType>
+    bool contains (const OtherKeyType& keyToLookFor) const noexcept
+    {
+        return table.find (keyToLookFor) != nullptr;
+    }
+
+    /** Returns a reference to the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is
+        added to the map and a reference to this is returned. The reference is only valid
+        until the map is next modified.
+    */
+    ValueType& getReference (KeyTypeParameter keyToLookFor)
+    {
+        return table.findOrInsert (keyToLookFor, [&] { return Entry { keyToLookFor, ValueType() }; }).value;
+    }
+
+    /** Adds or replaces an item in the map.
+        If there's already an item with the given key, this will replace its value.
+    */
+    void set (KeyTypeParameter newKey, ValueTypeParameter newValue)
+    {
+        table.findOrInsert (newKey, [&] { return Entry { newKey, ValueType() }; }).value = newValue;
+    }
+
+    /** Removes the item with the given key, returning true if there was one. */
+    template <typename OtherKeyType>
+    bool remove (const OtherKeyType& keyToRemove)               { return table.remove (keyToRemove); }
+
+    /** Removes all items with the given value. */
+    void removeValue (ValueTypeParameter valueToRemove)
+    {
+        table.removeIf ([&] (const Entry& e) { return e.value == valueToRemove; });
+    }
+
+    //==============================================================================
+    /** Efficiently swaps the contents of two maps. */
+    void swapWith (FlatHashMap& other) noexcept                 { table.swapWith (other.table); }
+
+    //==============================================================================
+    /** Returns an iterator over the map's items, in no particular order.
+        Iterators are invalidated by any call that adds or removes items.
+    */
+    auto begin() noexcept                                       { return table.begin(); }
+    auto end() noexcept                                         { return table.end(); }
+    auto begin() const noexcept                                 { return table.begin(); }
+    auto end() const noexcept                                   { return table.end(); }
+
+private:
+    //==============================================================================
+    detail::FlatHashTable<Entry, HashFunctionType> table;
+
+    JUCE_LEAK_DETECTOR (FlatHashMap)
+};
+
+//==============================================================================
+/**
+    A set of unique keys, stored in a single flat open-addressing array.
+
+    This is the set equivalent of FlatHashMap; see that class for details about how it
+    works, and about heterogeneous lookups with the default hash functions.
+
+    @code
+    FlatHashSet<String> names;
+    names.add ("Alice");
+
+    if (names.contains (StringRef ("Alice")))
+        DBG ("found");
+    @endcode
+
+    @see FlatHashMap, SortedSet
+
+    @tags{Core}
+*/
+template <typename KeyType,
+          class HashFunctionType = DefaultFlatHashFunctions>
+class FlatHashSet
+{
+private:
+    using KeyTypeParameter = typename TypeHelpers::ParameterType<KeyType>::type;
+
+    struct Entry
+    {
+        KeyType key;
+    };
+
+    using Table = detail::FlatHashTable<Entry, HashFunctionType>;
+
+public:
+    //==============================================================================
+    /** Creates an empty set. */
+    explicit FlatHashSet (HashFunctionType hashFunction = HashFunctionType())
+        : table (hashFunction)
+    {}
+
+    /** Creates a set containing some keys. */
+    FlatHashSet (std::initializer_list<KeyType> keys)
+        : table (HashFunctionType())
+    {
+        reserve ((int) keys.size());
+
+        for (auto& k : keys)
+            add (k);
+    }
+
+    //==============================================================================
+    /** Returns the number of keys in the set. */
+    int size() const noexcept                                   { return table.size(); }
+
+    /** Returns true if the set is empty. */
+    bool isEmpty() const noexcept                               { return table.size() == 0; }
+
+    /** Removes all keys from the set, keeping its storage allocated. */
+    void clear() noexcept                                       { table.clear(); }
+
+    /** Makes sure there's enough space to hold the given number of keys without
+        having to reallocate.
+    */
+    void reserve (int numItemsNeeded)                           { table.reserve (numItemsNeeded); }
+
+    //==============================================================================
+    /** Returns true if the set contains the given key. */
+    template <typename OtherKeyType>
+    bool contains (const OtherKeyType& keyToLookFor) const noexcept
+    {
+        return table.find (keyToLookFor) != nullptr;
+    }
+
+    /** Returns a pointer to the key in the set that matches the one given, or nullptr if
+        there isn't one. This is handy when the set is used to share copies of objects.
+        The pointer is only valid until the set is next modified.
+    */
+    template <typename OtherKeyType>
+    const KeyType* find (const OtherKeyType& keyToLookFor) const noexcept
+    {
+        if (auto* entry = table.find (keyToLookFor))
+            return &(entry->key);
+
+        return nullptr;
+    }
+
+    /** Adds a key to the set, returning true if it wasn't already there. */
+    bool add (KeyTypeParameter newKey)
+    {
+        auto sizeBefore = table.size();
+        table.findOrInsert (newKey, [&] { return Entry { newKey }; });
+        return table.size() != sizeBefore;
+    }
+
+    /** Removes a key from the set, returning true if it was there. */
+    template <typename OtherKeyType>
+    bool remove (const OtherKeyType& keyToRemove)               { return table.remove (keyToRemove); }
+
+    /** Removes all the keys for which a predicate returns true. */
+    template <typename Predicate>
+    void removeIf (Predicate&& shouldRemove)
+    {
+        table.removeIf ([&] (const Entry& e) { return shouldRemove (e.key); });
+    }
+
+    /** Efficiently swaps the contents of two sets. */
+    void swapWith (FlatHashSet& other) noexcept                 { table.swapWith (other.table); }
+
+    //==============================================================================
+    /** Iterates the keys in the set, in no particular order.
+        Iterators are invalidated by any call that adds or removes keys.
+    */
+    struct Iterator
+    {
+        const KeyType& operator*() const noexcept                   { return (*iter).key; }
+        const KeyType* operator->() const noexcept                  { return &((*iter).key); }
+        Iterator& operator++() noexcept                             { ++iter; return *this; }
+        bool operator== (const Iterator& other) const noexcept      { return iter == other.iter; }
+        bool operator!= (const Iterator& other) const noexcept      { return iter != other.iter; }
+
+        typename Table::ConstIterator iter;
+    };
+
+    Iterator begin() const noexcept                             { return { table.begin() }; }
+    Iterator end() const noexcept                               { return { table.end() }; }
+
+private:
+    //==============================================================================
+    Table table;
+
+    JUCE_LEAK_DETECTOR (FlatHashSet)
+};
+
+} // namespace juce
@@ -0,0 +1,221 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class FlatHashMapTests final : public UnitTest
+{
+public:
+    FlatHashMapTests() : UnitTest ("FlatHashMap", UnitTestCategories::containers) {}
+
+    void runTest() override
+    {
+        beginTest ("Random operations match std::map");
+        {
+            auto random = getRandom();
+            FlatHashMap<int, int> map;
+            std::map<int, int> groundTruth;
+
+            for (int i = 0; i < 20000; ++i)
+            {
+                auto key = random.nextInt (2000);
+
+                switch (random.nextInt (4))
+                {
+                    case 0:
+                    case 1:
+                    {
+                        auto value = random.nextInt();
+                        map.set (key, value);
+                        groundTruth[key] = value;
+                        break;
+                    }
+
+                    case 2:
+                        expectEquals ((int) map.remove (key), (int) groundTruth.erase (key));
+                        break;
+
+                    default:
+                    {
+                        auto* value = map.find (key);
+                        auto found = groundTruth.find (key);
+                        expect ((value != nullptr) == (found != groundTruth.end()));
+
+                        if (value != nullptr)
+                            expectEquals (*value, found->second);
+
+                        break;
+                    }
+                }
+
+                expectEquals (map.size(), (int) groundTruth.size());
+            }
+
+            std::map<int, int> iterated;
+
+            for (auto& item : map)
+                iterated[item.key] = item.value;
+
+            expect (iterated == groundTruth);
+
+            map.removeValue (groundTruth.begin()->second);
+            expect (! map.contains (groundTruth.begin()->first));
+
+            map.clear();
+            expect (map.isEmpty());
+            expect (map.begin() == map.end());
+        }
+
+        beginTest ("Clustered keys and large tables");
+        {
+            FlatHashMap<int64, int64> map;
+
+            for (int64 i = 0; i < 100000; ++i)
+                map.set (i << 32, i);
+
+            expectEquals (map.size(), 100000);
+
+            for (int64 i = 0; i < 100000; i += 2)
+                map.remove (i << 32);
+
+            for (int64 i = 0; i < 100000; ++i)
+                expect (map.contains (i << 32) == ((i & 1) != 0));
+        }
+
+        beginTest ("String keys can be looked up with other string types");
+        {
+            FlatHashMap<String, int> map;
+            map.set ("alpha", 1);
+            map.set (String (CharPointer_UTF8 ("\xc3\xa9t\xc3\xa9")), 2);
+
+            expectEquals (map["alpha"], 1);
+            expectEquals (map[StringRef ("alpha")], 1);
+            expectEquals (map[Identifier ("alpha")], 1);
+            expectEquals (map[String ("alpha")], 1);
+            expectEquals (map[String (CharPointer_UTF8 ("\xc3\xa9t\xc3\xa9"))], 2);
+            expectEquals (map["beta"], 0);
+            expect (map.remove (StringRef ("alpha")));
+            expect (! map.contains ("alpha"));
+
+            FlatHashMap<Identifier, int> identifiers;
+            identifiers.set ("gamma", 3);
+            expectEquals (identifiers["gamma"], 3);
+            expectEquals (identifiers[String ("gamma")], 3);
+        }
+
+        beginTest ("Copying and moving");
+        {
+            FlatHashMap<String, String> map;
+
+            for (int i = 0; i < 100; ++i)
+                map.set (String (i), String (i * 2));
+
+            auto copy = map;
+            map.set ("0", "changed");
+            expectEquals (copy.size(), 100);
+            expectEquals (copy["0"], String ("0"));
+            expectEquals (copy["99"], String ("198"));
+
+            auto moved = std::move (copy);
+            expectEquals (moved.size(), 100);
+            expectEquals (moved["50"], String ("100"));
+
+            map = moved;
+            expectEquals (map["0"], String ("0"));
+        }
+
+        beginTest ("Moving keeps the hash function that the entries were added with");
+        {
+            FlatHashMap<int, int, SaltedHash> map (SaltedHash { 0x5a5a5a5a });
+
+            for (int i = 0; i < 100; ++i)
+                map.set (i, i * 3);
+
+            auto moved = std::move (map);
+            expectEquals (moved.size(), 100);
+
+            for (int i = 0; i < 100; ++i)
+                expectEquals (moved[i], i * 3);
+
+            expect (map.isEmpty());
+            map.set (7, 1);
+            expectEquals (map[7], 1);
+
+            FlatHashMap<int, int, SaltedHash> assigned (SaltedHash { 0x1234 });
+            assigned.set (1, 1);
+            assigned = std::move (moved);
+
+            for (int i = 0; i < 100; ++i)
+                expectEquals (assigned[i], i * 3);
+        }
+
+        beginTest ("Sets");
+        {
+            FlatHashSet<String> set { "a", "b", "c" };
+            expectEquals (set.size(), 3);
+            expect (! set.add ("a"));
+            expect (set.add ("d"));
+            expect (set.contains (StringRef ("d")));
+            expect (set.remove ("b"));
+            expect (! set.contains ("b"));
+
+            StringArray keys;
+
+            for (auto& key : set)
+                keys.add (key);
+
+            keys.sort (false);
+            expectEquals (keys.joinIntoString (","), String ("a,c,d"));
+        }
+    }
+
+private:
+    // Keeps its salt on the heap, so that a moved-from copy produces different hashes
+    struct SaltedHash
+    {
+        explicit SaltedHash (uint64 s = 0) : salt (1, s) {}
+
+        uint64 generateHash (int key) const noexcept
+        {
+            return (uint64) key * 0x9e3779b97f4a7c15ULL + (salt.empty() ? 0 : salt.front());
+        }
+
+        std::vector<uint64> salt;
+    };
+};
+
+static FlatHashMapTests flatHashMapTests;
+
+} // namespace juce
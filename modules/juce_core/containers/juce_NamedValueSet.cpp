@@ -70,32 +70,74 @@ bool NamedValueSet::NamedValue::operator!= (const NamedValue& other) const noexc
 NamedValueSet::NamedValueSet() noexcept {}
 NamedValueSet::~NamedValueSet() noexcept {}
 
-NamedValueSet::NamedValueSet (const NamedValueSet& other)  : values (other.values) {}
+NamedValueSet::NamedValueSet (const NamedValueSet& other)
+   : values (other.values),
+     indexByName (other.indexByName != nullptr ? std::make_unique<IndexMap> (*other.indexByName) : nullptr)
+{
+}
 
 NamedValueSet::NamedValueSet (NamedValueSet&& other) noexcept
-   : values (std::move (other.values)) {}
+   : values (std::move (other.values)),
+     indexByName (std::move (other.indexByName))
+{
+}
 
 NamedValueSet::NamedValueSet (std::initializer_list<NamedValue> list)
    : values (std::move (list))
 {
+    rebuildIndex();
 }
 
 NamedValueSet& NamedValueSet::operator= (const NamedValueSet& other)
 {
     clear();
     values = other.values;
+    indexByName = other.indexByName != nullptr ? std::make_unique<IndexMap> (*other.indexByName) : nullptr;
     return *this;
 }
 
 NamedValueSet& NamedValueSet::operator= (NamedValueSet&& other) noexcept
 {
     other.values.swapWith (values);
+    std::swap (other.indexByName, indexByName);
     return *this;
 }
 
 void NamedValueSet::clear()
 {
     values.clear();
+    indexByName.reset();
+}
+
+//==============================================================================
+void NamedValueSet::rebuildIndex()
+{
+    if (values.size() < minSizeForIndex)
+    {
+        indexByName.reset();
+        return;
+    }
+
+    if (indexByName == nullptr)
+        indexByName = std::make_unique<IndexMap>();
+    else
+        indexByName->clear();
+
+    indexByName->reserve (values.size());
+
+    // If there are duplicate names, the first one wins, as it would in a linear search
+    for (int i = values.size(); --i >= 0;)
+        indexByName->set (values.getReference (i).name, i);
+}
+
+void NamedValueSet::addValue (NamedValue&& newValue)
+{
+    values.add (std::move (newValue));
+
+    if (indexByName != nullptr)
+        indexByName->set (values.getLast().name, values.size() - 1);
+    else if (values.size() >= minSizeForIndex)
+        rebuildIndex();
 }
 
 bool NamedValueSet::operator== (const NamedValueSet& other) const noexcept
@@ -161,20 +203,12 @@ var NamedValueSet::getWithDefault (const Identifier& name, const var& defaultRet
 
 var* NamedValueSet::getVarPointer (const Identifier& name) noexcept
 {
-    for (auto& i : values)
-        if (i.name == name)
-            return &(i.value);
-
-    return {};
+    return getVarPointerAt (indexOf (name));
 }
 
 const var* NamedValueSet::getVarPointer (const Identifier& name) const noexcept
 {
-    for (auto& i : values)
-        if (i.name == name)
-            return &(i.value);
-
-    return {};
+    return getVarPointerAt (indexOf (name));
 }
 
 bool NamedValueSet::set (const Identifier& name, var&& newValue)
@@ -188,7 +222,7 @@ bool NamedValueSet::set (const Identifier& name, var&& newValue)
         return true;
     }
 
-    values.add ({ name, std::move (newValue) });
+    addValue ({ name, std::move (newValue) });
     return true;
 }
 
@@ -203,7 +237,7 @@ bool NamedValueSet::set (const Identifier& name, const var& newValue)
         return true;
     }
 
-    values.add ({ name, newValue });
+    addValue ({ name, newValue });
     return true;
 }
 
@@ -214,6 +248,14 @@ bool NamedValueSet::contains (const Identifier& name) const noexcept
 
 int NamedValueSet::indexOf (const Identifier& name) const noexcept
 {
+    if (indexByName != nullptr)
+    {
+        if (auto* i = indexByName->find (name))
+            return *i;
+
+        return -1;
+    }
+
     auto numValues = values.size();
 
     for (int i = 0; i < numValues; ++i)
@@ -225,18 +267,40 @@ int NamedValueSet::indexOf (const Identifier& name) const noexcept
 
 bool NamedValueSet::remove (const Identifier& name)
 {
-    auto numValues = values.size();
+    auto indexToRemove = indexOf (name);
 
-    for (int i = 0; i < numValues; ++i)
+    if (indexToRemove < 0)
+        return false;
+
+    values.remove (indexToRemove);
+
+    if (indexByName != nullptr)
     {
-        if (values.getReference (i).name == name)
+        if (values.size() < minSizeForIndex / 2)
         {
-            values.remove (i);
-            return true;
+            indexByName.reset();
+        }
+        else
+        {
+            // Removing a duplicate name would expose an entry that isn't in the index
+            indexByName->remove (name);
+
+            for (auto& item : *indexByName)
+                if (item.value > indexToRemove)
+                    --item.value;
+
+            for (int i = indexToRemove; i < values.size(); ++i)
+            {
+                if (values.getReference (i).name == name)
+                {
+                    indexByName->set (name, i);
+                    break;
+                }
+            }
         }
     }
 
-    return false;
+    return true;
 }
 
 Identifier NamedValueSet::getName (const int index) const noexcept
@@ -276,6 +340,7 @@ const var* NamedValueSet::getVarPointerAt (int index) const noexcept
 void NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 {
     values.clearQuick();
+    indexByName.reset();
 
     for (auto* att = xml.attributes.get(); att != nullptr; att = att->nextListItem)
     {
@@ -292,6 +357,8 @@ void NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 
         values.add ({ att->name, var (att->value) });
     }
+
+    rebuildIndex();
 }
 
 void NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
@@ -315,4 +382,79 @@ void NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
     }
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class NamedValueSetTests final : public UnitTest
+{
+public:
+    NamedValueSetTests()
+        : UnitTest ("NamedValueSet", UnitTestCategories::containers)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Lookups stay consistent as the set grows past the indexing threshold and shrinks again");
+        {
+            auto random = getRandom();
+            NamedValueSet set;
+            Array<Identifier> expectedOrder;
+
+            for (int i = 0; i < 5000; ++i)
+            {
+                const Identifier key ("name" + String (random.nextInt (60)));
+
+                if (random.nextInt (3) == 0)
+                {
+                    expectEquals ((int) set.remove (key), (int) expectedOrder.contains (key));
+                    expectedOrder.removeFirstMatchingValue (key);
+                }
+                else
+                {
+                    set.set (key, i);
+                    expectedOrder.addIfNotAlreadyThere (key);
+                }
+
+                expectEquals (set.size(), expectedOrder.size());
+
+                for (int j = 0; j < expectedOrder.size(); ++j)
+                {
+                    expect (set.getName (j) == expectedOrder.getReference (j));
+                    expectEquals (set.indexOf (expectedOrder.getReference (j)), j);
+                }
+            }
+
+            auto copy = set;
+            expect (copy == set);
+
+            for (auto& key : expectedOrder)
+                expect (copy.getVarPointer (key) == copy.getVarPointerAt (set.indexOf (key)));
+
+            expect (! copy.contains ("not-there"));
+        }
+
+        beginTest ("The first of several duplicate names is found");
+        {
+            std::initializer_list<NamedValueSet::NamedValue> items
+            {
+                { "a", 0 }, { "b", 1 }, { "c", 2 }, { "d", 3 }, { "e", 4 }, { "f", 5 }, { "g", 6 }, { "h", 7 },
+                { "i", 8 }, { "j", 9 }, { "k", 10 }, { "l", 11 }, { "m", 12 }, { "n", 13 }, { "o", 14 }, { "a", 15 },
+                { "p", 16 }
+            };
+
+            NamedValueSet set (items);
+            expectEquals ((int) set["a"], 0);
+            expect (set.remove ("a"));
+            expectEquals ((int) set["a"], 15);
+            expectEquals (set.indexOf ("a"), 14);
+            expectEquals ((int) set["p"], 16);
+        }
+    }
+};
+
+static NamedValueSetTests namedValueSetTests;
+
+#endif
+
 } // namespace juce
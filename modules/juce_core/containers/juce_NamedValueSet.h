@@ -41,6 +41,9 @@ namespace juce
     This can be used as a basic structure to hold a set of var object, which can
     be retrieved by using their identifier.
 
+    The values are kept in the order in which they were added. Looking up a name
+    takes roughly constant time, however many values the set contains.
+
     @tags{Core}
 */
 class JUCE_API  NamedValueSet
@@ -191,7 +194,22 @@ public:
 
 private:
     //==============================================================================
+    struct IdentifierHashFunctions
+    {
+        static uint64 generateHash (const Identifier& name) noexcept    { return (uint64) name.hash(); }
+    };
+
+    using IndexMap = FlatHashMap<Identifier, int, IdentifierHashFunctions>;
+
+    // Small sets are searched linearly, which is quickest when there are only a few
+    // items. Larger ones also keep a hashed index of the position of each name.
+    enum { minSizeForIndex = 8 };
+
     Array<NamedValue> values;
+    std::unique_ptr<IndexMap> indexByName;
+
+    void rebuildIndex();
+    void addValue (NamedValue&&);
 };
 
 } // namespace juce
@@ -543,6 +543,10 @@ Result File::createDirectory() const
     if (r.wasOk())
         r = createDirectoryInternal (fullPath.trimCharactersAtEnd (getSeparatorString()));
 
+    // (another thread or process may have created it in the meantime)
+    if (r.failed() && isDirectory())
+        return Result::ok();
+
     return r;
 }
 
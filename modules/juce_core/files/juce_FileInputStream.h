@@ -78,6 +78,13 @@ public:
     */
     bool openedOk() const noexcept                      { return status.wasOk(); }
 
+    /** Tells the OS that the file is going to be read from start to end, so that it
+        can read further ahead than it otherwise would. This does nothing on platforms
+        where there's no way to do this.
+
+        @see ReadAheadInputStream
+    */
+    void hintSequentialAccess();
 
     //==============================================================================
     int64 getTotalLength() override;
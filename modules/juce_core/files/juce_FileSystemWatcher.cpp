@@ -0,0 +1,586 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+// Receives change notifications for folders from the OS. create() returns nullptr
+// where there's no way to do this, in which case all folders are polled.
+class FileSystemWatcher::NativeWatcher
+{
+public:
+    virtual ~NativeWatcher() = default;
+
+    // Starts watching a folder, returning false if it must be polled instead.
+    // These are called with the Pimpl's lock held.
+    virtual bool addFolder (const File& folder) = 0;
+    virtual void removeFolder (const File& folder) = 0;
+
+    // Blocks until some changes have been received and passed to Pimpl::addChange(),
+    // the timeout has elapsed, or wake() has been called.
+    virtual void readChanges (int timeoutMs) = 0;
+    virtual void wake() = 0;
+
+    static std::unique_ptr<NativeWatcher> create (Pimpl&);
+
+   #if JUCE_LINUX || JUCE_ANDROID
+    class Inotify;
+   #endif
+};
+
+//==============================================================================
+class FileSystemWatcher::Pimpl final : private Thread
+{
+public:
+    Pimpl (Callback cb, const Options& o)
+        : Thread ("FileSystemWatcher"),
+          options (o),
+          callbackHolder (std::make_shared<CallbackHolder> (std::move (cb)))
+    {
+        if (! options.pollingOnly)
+            nativeWatcher = NativeWatcher::create (*this);
+
+        startThread();
+    }
+
+    ~Pimpl() override
+    {
+        signalThreadShouldExit();
+        wake();
+        stopThread (-1);
+
+        const ScopedLock sl (callbackHolder->lock);
+        callbackHolder->callback = nullptr;
+    }
+
+    //==============================================================================
+    bool addFolder (const File& folder)
+    {
+        if (! folder.isDirectory())
+            return false;
+
+        const ScopedLock sl (lock);
+
+        if (findFolder (folder) == nullptr)
+        {
+            folders.push_back ({ folder, false, {} });
+
+            if (nativeWatcher != nullptr && nativeWatcher->addFolder (folder))
+                folders.back().isNative = true;
+            else
+                startPolling (folder);
+
+            wake();
+        }
+
+        return true;
+    }
+
+    void removeFolder (const File& folder)
+    {
+        const ScopedLock sl (lock);
+
+        if (auto* watched = findFolder (folder))
+        {
+            if (watched->isNative)
+                nativeWatcher->removeFolder (folder);
+
+            folders.erase (folders.begin() + (watched - folders.data()));
+        }
+    }
+
+    void removeAllFolders()
+    {
+        const ScopedLock sl (lock);
+
+        for (auto& f : getWatchedFolders())
+            removeFolder (f);
+    }
+
+    Array<File> getWatchedFolders() const
+    {
+        const ScopedLock sl (lock);
+        Array<File> result;
+
+        for (auto& f : folders)
+            result.add (f.folder);
+
+        return result;
+    }
+
+    //==============================================================================
+    // Records a change, merging it with any earlier one to the same item that
+    // hasn't been delivered yet.
+    void addChange (const File& file, ChangeType type)
+    {
+        const ScopedLock sl (lock);
+
+        if (pendingChanges.empty())
+            firstPendingChangeTime = Time::getMillisecondCounter();
+
+        auto [iter, inserted] = pendingChanges.emplace (file, type);
+
+        if (inserted)
+            return;
+
+        auto& existing = iter->second;
+
+        if (existing == ChangeType::created)
+        {
+            if (type == ChangeType::deleted)
+                pendingChanges.erase (iter);
+        }
+        else if (existing == ChangeType::deleted)
+        {
+            if (type != ChangeType::deleted)
+                existing = ChangeType::modified;
+        }
+        else
+        {
+            existing = type == ChangeType::deleted ? type : ChangeType::modified;
+        }
+    }
+
+    // Adds a 'created' change for everything inside a folder that's just appeared.
+    void addChangesForNewFolder (const File& folder)
+    {
+        for (auto& entry : RangedDirectoryIterator (folder, options.recursive, "*",
+                                                    File::findFilesAndDirectories, File::FollowSymlinks::no))
+            addChange (entry.getFile(), ChangeType::created);
+    }
+
+    // Called if a folder that was being watched by the OS needs to be polled instead.
+    void startPolling (const File& folder)
+    {
+        const ScopedLock sl (lock);
+
+        if (auto* watched = findFolder (folder))
+        {
+            watched->isNative = false;
+            watched->snapshot = takeSnapshot (folder);
+        }
+    }
+
+    const Options options;
+    CriticalSection lock;
+
+private:
+    //==============================================================================
+    struct ItemState
+    {
+        int64 size, modificationTime;
+        bool isDirectory;
+    };
+
+    using Snapshot = std::map<File, ItemState>;
+
+    struct WatchedFolder
+    {
+        File folder;
+        bool isNative;
+        Snapshot snapshot;
+    };
+
+    struct CallbackHolder
+    {
+        explicit CallbackHolder (Callback cb) : callback (std::move (cb)) {}
+
+        CriticalSection lock;
+        Callback callback;
+    };
+
+    std::unique_ptr<NativeWatcher> nativeWatcher;
+    std::vector<WatchedFolder> folders;
+    std::map<File, ChangeType> pendingChanges;
+    uint32 firstPendingChangeTime = 0, lastPollTime = 0;
+    std::shared_ptr<CallbackHolder> callbackHolder;
+
+    //==============================================================================
+    void run() override
+    {
+        lastPollTime = Time::getMillisecondCounter();
+
+        while (! threadShouldExit())
+        {
+            const auto timeout = getTimeUntilNextTask();
+
+            if (nativeWatcher != nullptr)
+                nativeWatcher->readChanges (timeout);
+            else
+                wait (timeout);
+
+            if (threadShouldExit())
+                break;
+
+            if (Time::getMillisecondCounter() - lastPollTime >= (uint32) options.pollingIntervalMs)
+                pollFolders();
+
+            deliverChanges();
+        }
+    }
+
+    void wake()
+    {
+        if (nativeWatcher != nullptr)
+            nativeWatcher->wake();
+        else
+            notify();
+    }
+
+    int getTimeUntilNextTask() const
+    {
+        const ScopedLock sl (lock);
+        const auto now = Time::getMillisecondCounter();
+        auto timeout = 10000;
+
+        if (std::any_of (folders.begin(), folders.end(), [] (auto& f) { return ! f.isNative; }))
+            timeout = jmax (0, options.pollingIntervalMs - (int) (now - lastPollTime));
+
+        if (! pendingChanges.empty())
+            timeout = jmin (timeout, jmax (0, options.coalescingIntervalMs - (int) (now - firstPendingChangeTime)));
+
+        return timeout;
+    }
+
+    WatchedFolder* findFolder (const File& folder)
+    {
+        for (auto& f : folders)
+            if (f.folder == folder)
+                return &f;
+
+        return nullptr;
+    }
+
+    //==============================================================================
+    Snapshot takeSnapshot (const File& folder) const
+    {
+        Snapshot snapshot;
+
+        for (auto& entry : RangedDirectoryIterator (folder, options.recursive, "*",
+                                                    File::findFilesAndDirectories, File::FollowSymlinks::no))
+            snapshot.emplace (entry.getFile(), ItemState { entry.getFileSize(),
+                                                           entry.getModificationTime().toMilliseconds(),
+                                                           entry.isDirectory() });
+
+        return snapshot;
+    }
+
+    void pollFolders()
+    {
+        const ScopedLock sl (lock);
+        lastPollTime = Time::getMillisecondCounter();
+
+        for (auto& f : folders)
+        {
+            if (f.isNative)
+                continue;
+
+            auto newSnapshot = takeSnapshot (f.folder);
+            auto oldItem = f.snapshot.cbegin();
+            auto newItem = newSnapshot.cbegin();
+
+            // (both snapshots are sorted, so they can be compared in a single pass)
+            while (oldItem != f.snapshot.cend() || newItem != newSnapshot.cend())
+            {
+                if (newItem == newSnapshot.cend()
+                     || (oldItem != f.snapshot.cend() && oldItem->first < newItem->first))
+                {
+                    // (the contents of a deleted folder aren't reported, as the OS doesn't do
+                    // that when a folder is moved away)
+                    auto parent = oldItem->first.getParentDirectory();
+
+                    if (f.snapshot.count (parent) == 0 || newSnapshot.count (parent) != 0)
+                        addChange (oldItem->first, ChangeType::deleted);
+
+                    ++oldItem;
+                }
+                else if (oldItem == f.snapshot.cend() || newItem->first < oldItem->first)
+                {
+                    addChange (newItem++->first, ChangeType::created);
+                }
+                else
+                {
+                    auto& o = oldItem++->second;
+                    auto& n = newItem->second;
+
+                    if (o.isDirectory != n.isDirectory)
+                    {
+                        addChange (newItem->first, ChangeType::deleted);
+                        addChange (newItem->first, ChangeType::created);
+                    }
+                    else if (! n.isDirectory && (o.size != n.size || o.modificationTime != n.modificationTime))
+                    {
+                        addChange (newItem->first, ChangeType::modified);
+                    }
+
+                    ++newItem;
+                }
+            }
+
+            f.snapshot = std::move (newSnapshot);
+        }
+    }
+
+    void deliverChanges()
+    {
+        Array<Change> changes;
+
+        {
+            const ScopedLock sl (lock);
+
+            if (pendingChanges.empty()
+                 || (int) (Time::getMillisecondCounter() - firstPendingChangeTime) < options.coalescingIntervalMs)
+                return;
+
+            changes.ensureStorageAllocated ((int) pendingChanges.size());
+
+            for (auto& [file, type] : pendingChanges)
+                changes.add ({ file, type });
+
+            pendingChanges.clear();
+        }
+
+        auto call = [holder = callbackHolder, changes = std::move (changes)]
+        {
+            const ScopedLock sl (holder->lock);
+
+            if (auto callback = holder->callback)
+                callback (changes);
+        };
+
+        if (options.dispatcher != nullptr)
+            options.dispatcher (std::move (call));
+        else
+            call();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+#if ! (JUCE_LINUX || JUCE_ANDROID)
+std::unique_ptr<FileSystemWatcher::NativeWatcher> FileSystemWatcher::NativeWatcher::create (Pimpl&)
+{
+    return nullptr;
+}
+#endif
+
+//==============================================================================
+FileSystemWatcher::FileSystemWatcher (Callback callback)
+    : FileSystemWatcher (std::move (callback), Options{})
+{
+}
+
+FileSystemWatcher::FileSystemWatcher (Callback callback, const Options& options)
+    : pimpl (std::make_unique<Pimpl> (std::move (callback), options))
+{
+}
+
+FileSystemWatcher::~FileSystemWatcher() = default;
+
+bool FileSystemWatcher::addFolder (const File& folder)      { return pimpl->addFolder (folder); }
+void FileSystemWatcher::removeFolder (const File& folder)   { pimpl->removeFolder (folder); }
+void FileSystemWatcher::removeAllFolders()                  { pimpl->removeAllFolders(); }
+Array<File> FileSystemWatcher::getWatchedFolders() const    { return pimpl->getWatchedFolders(); }
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class FileSystemWatcherTests final : public UnitTest
+{
+public:
+    FileSystemWatcherTests()
+        : UnitTest ("FileSystemWatcher", UnitTestCategories::files)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Native notifications");
+        testWatcher ({});
+
+        beginTest ("Polling");
+        testWatcher (FileSystemWatcher::Options{}.withPollingOnly (true).withPollingInterval (20));
+
+        beginTest ("Too many folders to watch");
+        testWatcher (FileSystemWatcher::Options{}.withMaxWatchedDirectories (1).withPollingInterval (20));
+
+        beginTest ("Non-recursive");
+        {
+            TemporaryFile tempFolder;
+            auto root = tempFolder.getFile();
+            expect (root.getChildFile ("sub").createDirectory());
+
+            Recorder recorder (root, FileSystemWatcher::Options{}.withRecursive (false).withPollingInterval (20));
+            expect (root.getChildFile ("sub/a.txt").replaceWithText ("a"));
+            expect (root.getChildFile ("b.txt").replaceWithText ("b"));
+
+            expect (recorder.waitFor ({ { root.getChildFile ("b.txt"), FileSystemWatcher::ChangeType::created } }));
+        }
+
+        beginTest ("Dispatcher");
+        {
+            TemporaryFile tempFolder;
+            auto root = tempFolder.getFile();
+            expect (root.createDirectory());
+
+            std::atomic<int> numDispatches { 0 };
+            Recorder recorder (root, FileSystemWatcher::Options{}.withDispatcher ([&] (std::function<void()> f)
+                                                                                  {
+                                                                                      ++numDispatches;
+                                                                                      f();
+                                                                                  }));
+
+            expect (root.getChildFile ("a.txt").replaceWithText ("a"));
+            expect (recorder.waitFor ({ { root.getChildFile ("a.txt"), FileSystemWatcher::ChangeType::created } }));
+            expect (numDispatches > 0);
+        }
+    }
+
+private:
+    using Changes = Array<FileSystemWatcher::Change>;
+
+    struct Recorder
+    {
+        Recorder (const File& root, const FileSystemWatcher::Options& options)
+            : watcher ([this] (const Changes& c)
+                       {
+                           const ScopedLock sl (lock);
+                           changes.addArray (c);
+                           changesArrived.signal();
+                       },
+                       options.withCoalescingInterval (20))
+        {
+            watcher.addFolder (root);
+        }
+
+        // Waits until exactly these changes have been seen, in any order. Once enough
+        // changes have arrived, it keeps listening until the watcher has been quiet for
+        // a while, so that unexpected extra changes are caught here rather than being
+        // left behind for the next call.
+        bool waitFor (std::initializer_list<FileSystemWatcher::Change> expectedChanges)
+        {
+            Changes expected (expectedChanges);
+            auto sortChanges = [] (Changes& c)
+            {
+                std::sort (c.begin(), c.end(), [] (auto& a, auto& b) { return a.file < b.file || (a.file == b.file && a.type < b.type); });
+            };
+
+            sortChanges (expected);
+
+            // Generous, as the filesystem can be slow to report on a loaded machine
+            const auto endTime = Time::getMillisecondCounter() + 30000;
+
+            while (getNumChanges() < expected.size())
+            {
+                if (Time::getMillisecondCounter() > endTime)
+                    break;
+
+                changesArrived.wait (100);
+            }
+
+            while (changesArrived.wait (quietPeriodMs) && Time::getMillisecondCounter() < endTime)
+            {}
+
+            const ScopedLock sl (lock);
+            sortChanges (changes);
+            auto result = changes == expected;
+            changes.clear();
+            return result;
+        }
+
+        int getNumChanges() const
+        {
+            const ScopedLock sl (lock);
+            return changes.size();
+        }
+
+        static constexpr int quietPeriodMs = 300;
+
+        CriticalSection lock;
+        Changes changes;
+        WaitableEvent changesArrived;
+        FileSystemWatcher watcher;
+    };
+
+    void testWatcher (const FileSystemWatcher::Options& options)
+    {
+        using CT = FileSystemWatcher::ChangeType;
+
+        TemporaryFile tempFolder;
+        auto root = tempFolder.getFile();
+        auto existing = root.getChildFile ("a/b/existing.txt");
+        expect (existing.getParentDirectory().createDirectory());
+        expect (existing.replaceWithText ("x"));
+
+        Recorder recorder (root, options);
+
+        expect (existing.appendText ("y"));
+        expect (recorder.waitFor ({ { existing, CT::modified } }));
+
+        auto newFile = root.getChildFile ("a/new.txt");
+        expect (newFile.replaceWithText ("1"));
+        expect (newFile.appendText ("2"));
+        expect (recorder.waitFor ({ { newFile, CT::created } }));
+
+        auto temp = root.getChildFile ("temp.txt");
+        expect (temp.replaceWithText ("temp"));
+        expect (temp.deleteFile());
+        expect (existing.deleteFile());
+        expect (recorder.waitFor ({ { existing, CT::deleted } }));
+
+        auto newFolder = root.getChildFile ("c/d");
+        expect (newFolder.createDirectory());
+        expect (newFolder.getChildFile ("e.txt").replaceWithText ("e"));
+        expect (recorder.waitFor ({ { root.getChildFile ("c"), CT::created },
+                                    { newFolder, CT::created },
+                                    { newFolder.getChildFile ("e.txt"), CT::created } }));
+
+        auto moved = root.getChildFile ("moved");
+        expect (root.getChildFile ("c").moveFileTo (moved));
+        expect (recorder.waitFor ({ { root.getChildFile ("c"), CT::deleted },
+                                    { moved, CT::created },
+                                    { moved.getChildFile ("d"), CT::created },
+                                    { moved.getChildFile ("d/e.txt"), CT::created } }));
+
+        expect (moved.getChildFile ("d/f.txt").replaceWithText ("f"));
+        expect (recorder.waitFor ({ { moved.getChildFile ("d/f.txt"), CT::created } }));
+    }
+};
+
+static FileSystemWatcherTests fileSystemWatcherTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Watches one or more folders, and reports the files and folders inside them that
+    get created, modified or deleted.
+
+    On Linux and Android the changes are reported by the kernel using inotify, so
+    they arrive almost immediately and cost nothing while nothing is happening.
+    Elsewhere, or where the OS can't watch a folder (for example when watching its
+    whole tree would need more than Options::maxWatchedDirectories watches), the
+    folder is periodically re-scanned and compared with what was there before.
+
+    Changes are gathered together for a short time before being delivered, so that
+    e.g. a file that's written in many small chunks is reported once, and a temporary
+    file that's created and deleted again is not reported at all. Each batch is passed
+    to the callback on the watcher's background thread, unless a dispatcher has been
+    set in the Options, e.g. to call it on the message thread:
+
+    @code
+    FileSystemWatcher watcher ([this] (const Array<FileSystemWatcher::Change>& changes) { rescan (changes); },
+                               FileSystemWatcher::Options{}.withDispatcher ([] (std::function<void()> f)
+                                                                            {
+                                                                                MessageManager::callAsync (std::move (f));
+                                                                            }));
+    watcher.addFolder (File ("/samples"));
+    @endcode
+
+    When a folder is deleted or moved away, the items inside it may or may not also
+    be reported. A file that's replaced by moving another one over it (which is how
+    File::replaceWithText() and many applications save files) may be reported as
+    having been created rather than modified. Symbolic links to folders aren't followed.
+
+    @tags{Core}
+*/
+class JUCE_API  FileSystemWatcher  final
+{
+public:
+    //==============================================================================
+    /** The kinds of change that can be reported. */
+    enum class ChangeType
+    {
+        created,    /**< The item has been created, or moved into the watched folder. */
+        modified,   /**< The item's contents or attributes have changed. */
+        deleted     /**< The item has been deleted, or moved out of the watched folder. */
+    };
+
+    /** Describes a change to a single file or folder. */
+    struct Change
+    {
+        File file;
+        ChangeType type;
+
+        bool operator== (const Change& other) const noexcept    { return file == other.file && type == other.type; }
+        bool operator!= (const Change& other) const noexcept    { return ! operator== (other); }
+    };
+
+    /** The callback that receives each batch of changes. */
+    using Callback = std::function<void (const Array<Change>&)>;
+
+    /** A function that's given each call to the callback, and must arrange for it to
+        be made, e.g. asynchronously on another thread.
+    */
+    using Dispatcher = std::function<void (std::function<void()>)>;
+
+    //==============================================================================
+    /** The settings for a FileSystemWatcher. */
+    struct Options
+    {
+        /** Whether the subfolders of each watched folder should also be watched. */
+        [[nodiscard]] Options withRecursive (bool x) const                  { return withMember (*this, &Options::recursive, x); }
+
+        /** The time in milliseconds for which changes are gathered together before
+            being delivered as one batch.
+        */
+        [[nodiscard]] Options withCoalescingInterval (int x) const          { return withMember (*this, &Options::coalescingIntervalMs, x); }
+
+        /** The time in milliseconds between re-scans of folders that can't be watched
+            by the OS.
+        */
+        [[nodiscard]] Options withPollingInterval (int x) const             { return withMember (*this, &Options::pollingIntervalMs, x); }
+
+        /** The largest number of folders that will be watched using the OS at once.
+            inotify needs one watch for each folder in a recursively-watched tree, and
+            the system limit on these is shared with other processes. A tree that
+            would exceed this number is polled instead.
+        */
+        [[nodiscard]] Options withMaxWatchedDirectories (int x) const       { return withMember (*this, &Options::maxWatchedDirectories, x); }
+
+        /** If true, folders are always polled, even where the OS could watch them. */
+        [[nodiscard]] Options withPollingOnly (bool x) const                { return withMember (*this, &Options::pollingOnly, x); }
+
+        /** Sets a function that's used to make each call to the callback. If none is
+            set, the callback is called directly on the watcher's thread.
+
+            Calls that are still waiting to be made when the watcher is deleted will
+            do nothing.
+        */
+        [[nodiscard]] Options withDispatcher (Dispatcher x) const           { return withMember (*this, &Options::dispatcher, std::move (x)); }
+
+        bool recursive = true;
+        int coalescingIntervalMs = 50;
+        int pollingIntervalMs = 1000;
+        int maxWatchedDirectories = 4096;
+        bool pollingOnly = false;
+        Dispatcher dispatcher;
+    };
+
+    //==============================================================================
+    /** Creates a watcher with the default options, which starts off watching nothing. */
+    explicit FileSystemWatcher (Callback callback);
+
+    /** Creates a watcher, which starts off watching nothing. */
+    FileSystemWatcher (Callback callback, const Options& options);
+
+    /** Destructor.
+        This waits for any callback that's currently being made to return, so it
+        mustn't be called from inside the callback when no dispatcher is being used.
+    */
+    ~FileSystemWatcher();
+
+    //==============================================================================
+    /** Starts watching a folder.
+        Returns false if the folder doesn't exist.
+    */
+    bool addFolder (const File& folder);
+
+    /** Stops watching a folder. */
+    void removeFolder (const File& folder);
+
+    /** Stops watching all folders. */
+    void removeAllFolders();
+
+    /** Returns the folders that are being watched. */
+    Array<File> getWatchedFolders() const;
+
+private:
+    //==============================================================================
+    class Pimpl;
+    class NativeWatcher;
+    std::unique_ptr<Pimpl> pimpl;
+
+    JUCE_DECLARE_NON_COPYABLE (FileSystemWatcher)
+};
+
+} // namespace juce
@@ -0,0 +1,316 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class ParallelDirectoryScanner::Scan
+{
+public:
+    Scan (const Options& o, std::function<void (const DirectoryEntry&)> cb)
+        : options (o),
+          callback (std::move (cb)),
+          wildcards (StringArray::fromTokens (options.wildcard, ";,", "\"'"))
+    {
+        // you have to specify the type of files you're looking for!
+        jassert ((options.whatToLookFor & (File::findFiles | File::findDirectories)) != 0);
+
+        wildcards.trim();
+        wildcards.removeEmptyStrings();
+    }
+
+    void run (const File& directory)
+    {
+        if (! directory.isDirectory())
+            return;
+
+        addDirectories ({ directory });
+        pendingDirectories.add (directory);
+
+        auto numThreads = options.numThreads > 0 ? options.numThreads : SystemStats::getNumCpus();
+        std::unique_ptr<ThreadPool> pool;
+
+        if (numThreads > 1)
+        {
+            pool = std::make_unique<ThreadPool> (numThreads - 1);
+
+            for (int i = numThreads - 1; --i >= 0;)
+                pool->addJob ([this] { readDirectories(); });
+        }
+
+        readDirectories();
+
+        if (pool != nullptr)
+            pool->removeAllJobs (false, -1);
+    }
+
+private:
+    const Options options;
+    const std::function<void (const DirectoryEntry&)> callback;
+    StringArray wildcards;
+
+    CriticalSection lock;
+    Array<File> pendingDirectories;
+    std::set<File> knownDirectories;
+    int numDirectoriesBeingRead = 0;
+    WaitableEvent directoriesAvailable { true };
+
+    //==============================================================================
+    void readDirectories()
+    {
+        File directory;
+        Array<File> subdirectories;
+
+        while (getNextDirectory (directory))
+        {
+            subdirectories.clearQuick();
+            readDirectory (directory, subdirectories);
+            finishedDirectory (subdirectories);
+        }
+    }
+
+    bool getNextDirectory (File& directory)
+    {
+        for (;;)
+        {
+            {
+                const ScopedLock sl (lock);
+
+                if (! pendingDirectories.isEmpty())
+                {
+                    // (taking the most recently found directory keeps the queue short)
+                    directory = pendingDirectories.removeAndReturn (pendingDirectories.size() - 1);
+                    ++numDirectoriesBeingRead;
+                    return true;
+                }
+
+                if (numDirectoriesBeingRead == 0)
+                    return false;
+
+                directoriesAvailable.reset();
+            }
+
+            directoriesAvailable.wait();
+        }
+    }
+
+    void finishedDirectory (const Array<File>& subdirectories)
+    {
+        const ScopedLock sl (lock);
+
+        pendingDirectories.addArray (subdirectories);
+
+        if (--numDirectoriesBeingRead == 0 || ! subdirectories.isEmpty())
+            directoriesAvailable.signal();
+    }
+
+    void addDirectories (const Array<File>& directories)
+    {
+        if (options.followSymlinks == File::FollowSymlinks::noCycles)
+        {
+            const ScopedLock sl (lock);
+            knownDirectories.insert (directories.begin(), directories.end());
+        }
+    }
+
+    //==============================================================================
+    // Returns true if an item with this name and type should be passed to the callback.
+    // Whether an item is hidden depends on the platform, so the caller has to work that out.
+    bool isWanted (const String& name, bool isDirectory, bool isHidden) const
+    {
+        if ((options.whatToLookFor & (isDirectory ? File::findDirectories : File::findFiles)) == 0)
+            return false;
+
+        if ((options.whatToLookFor & File::ignoreHiddenFiles) != 0 && isHidden)
+            return false;
+
+        for (auto& w : wildcards)
+            if (name.matchesWildcard (w, ! File::areFileNamesCaseSensitive()))
+                return true;
+
+        return false;
+    }
+
+    bool shouldRecurseInto (const DirectoryEntry& entry, bool isSymbolicLink)
+    {
+        if ((options.whatToLookFor & File::ignoreHiddenFiles) != 0 && entry.isHidden())
+            return false;
+
+        if (! isSymbolicLink || options.followSymlinks == File::FollowSymlinks::yes)
+            return true;
+
+        if (options.followSymlinks == File::FollowSymlinks::no)
+            return false;
+
+        const ScopedLock sl (lock);
+        return knownDirectories.find (entry.getFile().getLinkedTarget()) == knownDirectories.end();
+    }
+
+    // Called by readDirectory() for each item it finds
+    void addItem (const DirectoryEntry& entry, bool isSymbolicLink, bool wanted, Array<File>& subdirectories)
+    {
+        if (entry.isDirectory() && shouldRecurseInto (entry, isSymbolicLink))
+        {
+            subdirectories.add (entry.getFile());
+            addDirectories ({ entry.getFile() });
+        }
+
+        if (wanted)
+            callback (entry);
+    }
+
+    // Lists the items in one directory, calling addItem() for each one. This is
+    // implemented natively where there's a faster way to do it.
+    void readDirectory (const File& directory, Array<File>& subdirectories);
+
+    JUCE_DECLARE_NON_COPYABLE (Scan)
+};
+
+#if ! (JUCE_LINUX || JUCE_BSD || JUCE_ANDROID)
+void ParallelDirectoryScanner::Scan::readDirectory (const File& directory, Array<File>& subdirectories)
+{
+    for (auto& entry : RangedDirectoryIterator (directory, false, "*", File::findFilesAndDirectories))
+    {
+        auto isSymbolicLink = entry.isDirectory()
+                               && options.followSymlinks != File::FollowSymlinks::yes
+                               && entry.getFile().isSymbolicLink();
+
+        addItem (entry, isSymbolicLink, isWanted (entry.getFile().getFileName(), entry.isDirectory(), entry.isHidden()), subdirectories);
+    }
+}
+#endif
+
+//==============================================================================
+void ParallelDirectoryScanner::scan (const File& directory,
+                                     const Options& options,
+                                     std::function<void (const DirectoryEntry&)> callback)
+{
+    Scan (options, std::move (callback)).run (directory);
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ParallelDirectoryScannerTests final : public UnitTest
+{
+public:
+    ParallelDirectoryScannerTests()
+        : UnitTest ("ParallelDirectoryScanner", UnitTestCategories::files)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Finds all files");
+
+        TemporaryFile tempFolder;
+        auto root = tempFolder.getFile();
+
+        StringArray expectedFiles, expectedDirectories;
+
+        for (int i = 0; i < 6; ++i)
+        {
+            auto dir = root.getChildFile ("dir" + String (i)).getChildFile ("sub" + String (i % 2));
+            expect (dir.createDirectory());
+            expectedDirectories.addIfNotAlreadyThere (dir.getParentDirectory().getFullPathName());
+            expectedDirectories.addIfNotAlreadyThere (dir.getFullPathName());
+
+            for (int j = 0; j < 5; ++j)
+            {
+                auto file = dir.getChildFile ("file" + String (j) + (j % 2 == 0 ? ".txt" : ".dat"));
+                expect (file.replaceWithText (String::repeatedString ("x", j)));
+                expectedFiles.add (file.getFullPathName());
+            }
+        }
+
+        expect (root.getChildFile (".hidden.txt").replaceWithText ("hidden"));
+
+        const auto scan = [&] (const ParallelDirectoryScanner::Options& options)
+        {
+            CriticalSection lock;
+            StringArray found;
+            int64 totalSize = 0;
+
+            ParallelDirectoryScanner::scan (root, options.withNumThreads (3), [&] (const DirectoryEntry& entry)
+            {
+                const ScopedLock sl (lock);
+                found.add (entry.getFile().getFullPathName());
+                totalSize += entry.getFileSize();
+                expect (entry.isDirectory() == entry.getFile().isDirectory());
+            });
+
+            found.sort (false);
+            return std::make_pair (found, totalSize);
+        };
+
+        const auto sorted = [] (StringArray s) { s.sort (false); return s; };
+
+        {
+            auto [found, totalSize] = scan ({});
+            auto expected = expectedFiles;
+            expected.add (root.getChildFile (".hidden.txt").getFullPathName());
+            expect (found == sorted (expected));
+            expectEquals (totalSize, (int64) (6 * (0 + 1 + 2 + 3 + 4) + 6));
+        }
+
+        beginTest ("Wildcards and hidden files");
+        {
+            auto options = ParallelDirectoryScanner::Options{}.withWildcard ("*.txt")
+                                                                .withTypesToFind (File::findFiles | File::ignoreHiddenFiles)
+                                                                .withFileDetails (false);
+            auto [found, totalSize] = scan (options);
+
+            StringArray expected;
+
+            for (auto& f : expectedFiles)
+                if (f.endsWith (".txt"))
+                    expected.add (f);
+
+            expect (found == sorted (expected));
+            expectEquals (totalSize, (int64) 0);
+        }
+
+        beginTest ("Directories");
+        {
+            auto [found, totalSize] = scan (ParallelDirectoryScanner::Options{}.withTypesToFind (File::findDirectories));
+            expect (found == sorted (expectedDirectories));
+        }
+    }
+};
+
+static ParallelDirectoryScannerTests parallelDirectoryScannerTests;
+
+#endif
+
+} // namespace juce
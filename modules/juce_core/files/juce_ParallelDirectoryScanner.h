@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Searches a directory and all its subdirectories on several threads at once,
+    passing each matching file or folder to a callback.
+
+    For large trees this is much faster than RangedDirectoryIterator, because
+    subdirectories are read in parallel, and names are checked against the wildcard
+    before any other information about an item is fetched. On Linux, the item types
+    reported by the directory listing also mean that no stat() call is needed for
+    each file unless its details have been requested.
+
+    The callback is called on the scanning threads, possibly several at once, so it
+    must be thread-safe. Items arrive in no particular order, and scan() returns
+    once the whole tree has been searched.
+
+    @code
+    std::atomic<int64> totalSize { 0 };
+
+    ParallelDirectoryScanner::scan (File ("/samples"),
+                                    ParallelDirectoryScanner::Options{}.withWildcard ("*.wav;*.aif"),
+                                    [&] (const DirectoryEntry& entry) { totalSize += entry.getFileSize(); });
+    @endcode
+
+    @see RangedDirectoryIterator
+
+    @tags{Core}
+*/
+class JUCE_API  ParallelDirectoryScanner  final
+{
+public:
+    //==============================================================================
+    /** The settings for a scan. */
+    struct Options
+    {
+        /** The file pattern to match. This may contain multiple patterns separated
+            by a semi-colon or comma, e.g. "*.jpg;*.png"
+        */
+        [[nodiscard]] Options withWildcard (const String& x) const                  { return withMember (*this, &Options::wildcard, x); }
+
+        /** A value from the File::TypesOfFileToFind enum, specifying whether to look
+            for files, directories, or both, and whether to skip hidden items.
+        */
+        [[nodiscard]] Options withTypesToFind (int x) const                         { return withMember (*this, &Options::whatToLookFor, x); }
+
+        /** The policy to use when symlinks to directories are encountered. */
+        [[nodiscard]] Options withFollowSymlinks (File::FollowSymlinks x) const     { return withMember (*this, &Options::followSymlinks, x); }
+
+        /** If this is false, only the file, isDirectory() and isHidden() are filled-in
+            for each entry, which avoids fetching anything else from the file system.
+        */
+        [[nodiscard]] Options withFileDetails (bool x) const                        { return withMember (*this, &Options::fetchFileDetails, x); }
+
+        /** The number of threads to search with, including the calling one. If this
+            is 0, one thread per CPU core is used.
+        */
+        [[nodiscard]] Options withNumThreads (int x) const                          { return withMember (*this, &Options::numThreads, x); }
+
+        String wildcard = "*";
+        int whatToLookFor = File::findFiles;
+        File::FollowSymlinks followSymlinks = File::FollowSymlinks::noCycles;
+        bool fetchFileDetails = true;
+        int numThreads = 0;
+    };
+
+    /** Searches a directory tree, calling the callback for each item that matches. */
+    static void scan (const File& directory,
+                      const Options& options,
+                      std::function<void (const DirectoryEntry&)> callback);
+
+private:
+    class Scan;
+};
+
+} // namespace juce
@@ -83,6 +83,7 @@ private:
     bool readOnly   = false;
 
     friend class RangedDirectoryIterator;
+    friend class ParallelDirectoryScanner;
 };
 
 /** A convenience operator so that the expression `*it++` works correctly when
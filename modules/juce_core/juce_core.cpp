@@ -135,6 +135,8 @@
 #include "containers/juce_SparseSet.cpp"
 #include "files/juce_DirectoryIterator.cpp"
 #include "files/juce_RangedDirectoryIterator.cpp"
+#include "files/juce_ParallelDirectoryScanner.cpp"
+#include "files/juce_FileSystemWatcher.cpp"
 #include "files/juce_File.cpp"
 #include "files/juce_FileInputStream.cpp"
 #include "files/juce_FileOutputStream.cpp"
@@ -157,14 +159,19 @@
 #if ! JUCE_WINDOWS
  #include "native/juce_SharedCode_posix.h"
  #include "native/juce_NamedPipe_posix.cpp"
+ #include "native/juce_SharedMemoryPipe_posix.cpp"
 #else
  #include "native/juce_Files_windows.cpp"
+ #include "native/juce_SharedMemoryPipe_windows.cpp"
 #endif
 
 #include "network/juce_NamedPipe.cpp"
+#include "network/juce_SharedMemoryPipe.cpp"
 #include "network/juce_Socket.cpp"
+#include "network/juce_SocketReactor.cpp"
 #include "network/juce_IPAddress.cpp"
 #include "streams/juce_BufferedInputStream.cpp"
+#include "streams/juce_ReadAheadInputStream.cpp"
 #include "streams/juce_FileInputSource.cpp"
 #include "streams/juce_InputStream.cpp"
 #include "streams/juce_MemoryInputStream.cpp"
@@ -177,6 +184,7 @@
 #include "text/juce_String.cpp"
 #include "streams/juce_OutputStream.cpp"
 #include "text/juce_StringArray.cpp"
+#include "text/juce_StringBuilder.cpp"
 #include "text/juce_StringPairArray.cpp"
 #include "text/juce_StringPool.cpp"
 #include "text/juce_TextDiff.cpp"
@@ -196,6 +204,7 @@
 #include "xml/juce_XmlDocument.cpp"
 #include "xml/juce_XmlElement.cpp"
 #include "zip/juce_GZIPDecompressorInputStream.cpp"
+#include "zip/juce_CRC32.cpp"
 #include "zip/juce_GZIPCompressorOutputStream.cpp"
 #include "zip/juce_ZipFile.cpp"
 #include "files/juce_FileFilter.cpp"
@@ -287,6 +296,7 @@
 //==============================================================================
 #if JUCE_UNIT_TESTS
  #include "containers/juce_HashMap_test.cpp"
+ #include "containers/juce_FlatHashMap_test.cpp"
  #include "containers/juce_Optional_test.cpp"
  #include "containers/juce_Enumerate_test.cpp"
  #include "containers/juce_ListenerList_test.cpp"
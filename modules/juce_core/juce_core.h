@@ -289,6 +289,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "text/juce_StringPool.h"
 #include "text/juce_Identifier.h"
 #include "text/juce_StringArray.h"
+#include "text/juce_StringBuilder.h"
 #include "system/juce_SystemStats.h"
 #include "memory/juce_HeavyweightLeakedObjectDetector.h"
 #include "text/juce_StringPairArray.h"
@@ -301,6 +302,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "misc/juce_Uuid.h"
 #include "misc/juce_ConsoleApplication.h"
 #include "containers/juce_Variant.h"
+#include "containers/juce_FlatHashMap.h"
 #include "containers/juce_NamedValueSet.h"
 #include "json/juce_JSON.h"
 #include "containers/juce_DynamicObject.h"
@@ -311,6 +313,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "streams/juce_InputStream.h"
 #include "streams/juce_OutputStream.h"
 #include "streams/juce_BufferedInputStream.h"
+#include "streams/juce_ReadAheadInputStream.h"
 #include "streams/juce_MemoryInputStream.h"
 #include "streams/juce_MemoryOutputStream.h"
 #include "streams/juce_SubregionStream.h"
@@ -318,6 +321,8 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "files/juce_File.h"
 #include "files/juce_DirectoryIterator.h"
 #include "files/juce_RangedDirectoryIterator.h"
+#include "files/juce_ParallelDirectoryScanner.h"
+#include "files/juce_FileSystemWatcher.h"
 #include "files/juce_FileInputStream.h"
 #include "files/juce_FileOutputStream.h"
 #include "files/juce_FileSearchPath.h"
@@ -352,7 +357,9 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "network/juce_IPAddress.h"
 #include "network/juce_MACAddress.h"
 #include "network/juce_NamedPipe.h"
+#include "network/juce_SharedMemoryPipe.h"
 #include "network/juce_Socket.h"
+#include "network/juce_SocketReactor.h"
 #include "network/juce_URL.h"
 #include "network/juce_WebInputStream.h"
 #include "streams/juce_URLInputSource.h"
@@ -360,6 +367,7 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "unit_tests/juce_UnitTest.h"
 #include "xml/juce_XmlDocument.h"
 #include "xml/juce_XmlElement.h"
+#include "zip/juce_CRC32.h"
 #include "zip/juce_GZIPCompressorOutputStream.h"
 #include "zip/juce_GZIPDecompressorInputStream.h"
 #include "zip/juce_ZipFile.h"
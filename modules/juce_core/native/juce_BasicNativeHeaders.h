@@ -209,7 +209,10 @@
  #include <sys/vfs.h>
  #include <sys/wait.h>
  #include <sys/timerfd.h>
+ #include <sys/epoll.h>
  #include <sys/eventfd.h>
+ #include <sys/inotify.h>
+ #include <linux/futex.h>
  #include <utime.h>
  #include <poll.h>
 
@@ -247,6 +250,10 @@
  #include <utime.h>
  #include <poll.h>
 
+ #if defined (__FreeBSD__)
+  #include <sys/umtx.h>
+ #endif
+
 //==============================================================================
 #elif JUCE_ANDROID
  #include <jni.h>
@@ -267,7 +274,11 @@
  #include <fnmatch.h>
  #include <sys/wait.h>
  #include <sys/timerfd.h>
+ #include <sys/epoll.h>
  #include <sys/eventfd.h>
+ #include <sys/inotify.h>
+ #include <sys/syscall.h>
+ #include <linux/futex.h>
  #include <android/api-level.h>
  #include <poll.h>
 
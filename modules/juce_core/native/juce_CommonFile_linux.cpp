@@ -152,4 +152,288 @@ bool DirectoryIterator::NativeIterator::next (String& filenameFound,
     return pimpl->next (filenameFound, isDir, isHidden, fileSize, modTime, creationTime, isReadOnly);
 }
 
+//==============================================================================
+void ParallelDirectoryScanner::Scan::readDirectory (const File& directory, Array<File>& subdirectories)
+{
+    auto* dir = opendir (directory.getFullPathName().toUTF8());
+
+    if (dir == nullptr)
+        return;
+
+    const auto fd = dirfd (dir);
+    const auto parentPath = File::addTrailingSeparator (directory.getFullPathName());
+
+    // readdir() fetches the entries in large batches, and each one comes with its type,
+    // so an item only needs to be stat'ed if that's unknown, or if its details are needed.
+    while (auto* de = readdir (dir))
+    {
+        if (de->d_name[0] == '.' && (de->d_name[1] == 0 || (de->d_name[1] == '.' && de->d_name[2] == 0)))
+            continue;
+
+        juce_statStruct info;
+        bool hasInfo = false;
+
+        const auto statItem = [&]
+        {
+           #if JUCE_LINUX
+            hasInfo = fstatat64 (fd, de->d_name, &info, 0) == 0;
+           #else
+            hasInfo = fstatat (fd, de->d_name, &info, 0) == 0;
+           #endif
+            return hasInfo;
+        };
+
+        const auto isSymbolicLink = de->d_type == DT_LNK;
+        auto isDirectory = de->d_type == DT_DIR;
+
+        if (de->d_type == DT_UNKNOWN || isSymbolicLink)
+            isDirectory = statItem() && S_ISDIR (info.st_mode);
+
+        auto name = String::fromUTF8 (de->d_name);
+        const auto isHidden = name.startsWithChar ('.');
+        auto wanted = isWanted (name, isDirectory, isHidden);
+
+        if (! (wanted || isDirectory))
+            continue;
+
+        DirectoryEntry entry;
+        entry.file = File::createFileWithoutCheckingPath (parentPath + name);
+        entry.directory = isDirectory;
+        entry.hidden = isHidden;
+
+        if (wanted && options.fetchFileDetails)
+        {
+            if (hasInfo || statItem())
+            {
+                entry.fileSize = (int64) info.st_size;
+                entry.modTime = Time ((int64) info.st_mtime * 1000);
+                entry.creationTime = Time (getCreationTime (info) * 1000);
+            }
+
+            entry.readOnly = faccessat (fd, de->d_name, W_OK, 0) != 0;
+        }
+
+        addItem (entry, isSymbolicLink, wanted, subdirectories);
+    }
+
+    closedir (dir);
+}
+
+#if JUCE_LINUX || JUCE_ANDROID
+//==============================================================================
+class FileSystemWatcher::NativeWatcher::Inotify final : public NativeWatcher
+{
+public:
+    explicit Inotify (Pimpl& p)
+        : owner (p),
+          inotifyFd (inotify_init1 (IN_NONBLOCK | IN_CLOEXEC)),
+          wakeFd (eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+    }
+
+    ~Inotify() override
+    {
+        if (inotifyFd >= 0)  close (inotifyFd);
+        if (wakeFd >= 0)     close (wakeFd);
+    }
+
+    bool isValid() const noexcept    { return inotifyFd >= 0 && wakeFd >= 0; }
+
+    bool addFolder (const File& folder) override
+    {
+        if (addWatches (folder, folder))
+            return true;
+
+        removeFolder (folder);
+        return false;
+    }
+
+    void removeFolder (const File& folder) override
+    {
+        removeWatchesIf ([&] (const Watch& w) { return w.root == folder; });
+    }
+
+    void readChanges (int timeoutMs) override
+    {
+        pollfd fds[] = { { inotifyFd, POLLIN, 0 }, { wakeFd, POLLIN, 0 } };
+
+        if (poll (fds, 2, timeoutMs) <= 0)
+            return;
+
+        if (fds[1].revents != 0)
+        {
+            uint64_t value;
+            [[maybe_unused]] auto numBytes = read (wakeFd, &value, sizeof (value));
+        }
+
+        if (fds[0].revents == 0)
+            return;
+
+        alignas (inotify_event) char buffer[16384];
+        const ScopedLock sl (owner.lock);
+
+        for (;;)
+        {
+            const auto numBytes = read (inotifyFd, buffer, sizeof (buffer));
+
+            if (numBytes <= 0)
+                break;
+
+            for (ssize_t i = 0; i < numBytes;)
+            {
+                auto* event = reinterpret_cast<const inotify_event*> (buffer + i);
+                handleEvent (*event);
+                i += (ssize_t) (sizeof (inotify_event) + event->len);
+            }
+        }
+    }
+
+    void wake() override
+    {
+        const uint64_t value = 1;
+        [[maybe_unused]] auto numBytes = write (wakeFd, &value, sizeof (value));
+    }
+
+private:
+    struct Watch
+    {
+        File directory, root;
+    };
+
+    static constexpr uint32_t eventMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO
+                                           | IN_DELETE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+
+    Pimpl& owner;
+    const int inotifyFd, wakeFd;
+    std::map<int, Watch> watches;
+
+    bool addWatch (const File& directory, const File& root)
+    {
+        if ((int) watches.size() >= owner.options.maxWatchedDirectories)
+            return false;
+
+        const auto wd = inotify_add_watch (inotifyFd, directory.getFullPathName().toRawUTF8(), eventMask);
+
+        if (wd < 0)
+            return false;
+
+        // (a folder that's inside two watched trees can only be watched for one of them)
+        auto [iter, inserted] = watches.emplace (wd, Watch { directory, root });
+        return inserted || iter->second.root == root;
+    }
+
+    bool addWatches (const File& directory, const File& root)
+    {
+        if (! addWatch (directory, root))
+            return false;
+
+        if (owner.options.recursive)
+            for (auto& entry : RangedDirectoryIterator (directory, true, "*", File::findDirectories, File::FollowSymlinks::no))
+                if (! addWatch (entry.getFile(), root))
+                    return false;
+
+        return true;
+    }
+
+    template <typename Predicate>
+    void removeWatchesIf (Predicate&& predicate)
+    {
+        for (auto iter = watches.begin(); iter != watches.end();)
+        {
+            if (predicate (iter->second))
+            {
+                inotify_rm_watch (inotifyFd, iter->first);
+                iter = watches.erase (iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+
+    void handleEvent (const inotify_event& event)
+    {
+        if ((event.mask & IN_Q_OVERFLOW) != 0)
+        {
+            // Some events have been lost, so all that can be reported is that something changed
+            for (auto& w : watches)
+                if (w.second.directory == w.second.root)
+                    owner.addChange (w.second.root, ChangeType::modified);
+
+            return;
+        }
+
+        auto iter = watches.find (event.wd);
+
+        if (iter == watches.end())
+            return;
+
+        // (the watch is removed automatically when its folder is deleted or unmounted)
+        if ((event.mask & IN_IGNORED) != 0)
+        {
+            watches.erase (iter);
+            return;
+        }
+
+        const auto watch = iter->second;
+
+        // Changes to a folder itself are reported by the watch on its parent, except
+        // for the top-level folder
+        if (event.len == 0)
+        {
+            if ((event.mask & IN_DELETE_SELF) != 0 && watch.directory == watch.root)
+                owner.addChange (watch.root, ChangeType::deleted);
+
+            return;
+        }
+
+        const auto file = File::createFileWithoutCheckingPath (File::addTrailingSeparator (watch.directory.getFullPathName())
+                                                                 + String::fromUTF8 (event.name));
+        const auto isDirectory = (event.mask & IN_ISDIR) != 0;
+
+        if ((event.mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+        {
+            owner.addChange (file, ChangeType::created);
+
+            if (isDirectory && owner.options.recursive)
+            {
+                if (! addWatches (file, watch.root))
+                {
+                    removeFolder (watch.root);
+                    owner.startPolling (watch.root);
+                }
+
+                // Anything created before the new watches were added would otherwise be missed
+                owner.addChangesForNewFolder (file);
+            }
+        }
+        else if ((event.mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+        {
+            owner.addChange (file, ChangeType::deleted);
+
+            // The watches inside a folder that's moved would report the wrong paths
+            if (isDirectory && (event.mask & IN_MOVED_FROM) != 0)
+                removeWatchesIf ([&] (const Watch& w) { return w.directory == file || w.directory.isAChildOf (file); });
+        }
+        else if ((event.mask & IN_MODIFY) != 0 || ((event.mask & IN_ATTRIB) != 0 && ! isDirectory))
+        {
+            owner.addChange (file, ChangeType::modified);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Inotify)
+};
+
+std::unique_ptr<FileSystemWatcher::NativeWatcher> FileSystemWatcher::NativeWatcher::create (Pimpl& owner)
+{
+    auto watcher = std::make_unique<Inotify> (owner);
+
+    if (watcher->isValid())
+        return watcher;
+
+    return nullptr;
+}
+#endif
+
 } // namespace juce
@@ -425,6 +425,12 @@ size_t FileInputStream::readInternal (void* buffer, size_t numBytes)
     return 0;
 }
 
+void FileInputStream::hintSequentialAccess()
+{
+    // (Windows can only be told this when a file is opened, and it already reads
+    // ahead when it sees a file being read sequentially)
+}
+
 //==============================================================================
 void FileOutputStream::openHandle()
 {
@@ -484,6 +484,18 @@ size_t FileInputStream::readInternal (void* buffer, size_t numBytes)
     return (size_t) result;
 }
 
+void FileInputStream::hintSequentialAccess()
+{
+    if (fileHandle != nullptr)
+    {
+       #if JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+        posix_fadvise (getFD (fileHandle), 0, 0, POSIX_FADV_SEQUENTIAL);
+       #elif JUCE_MAC || JUCE_IOS
+        fcntl (getFD (fileHandle), F_RDAHEAD, 1);
+       #endif
+    }
+}
+
 //==============================================================================
 void FileOutputStream::openHandle()
 {
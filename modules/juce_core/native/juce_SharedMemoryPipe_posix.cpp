@@ -0,0 +1,251 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#if JUCE_MAC || JUCE_IOS
+// These are what libc++ uses to implement std::atomic::wait(). They only appeared in
+// macOS 10.12 and iOS 10, so are weakly linked in case we're running on something older.
+extern "C" int __ulock_wait (uint32_t operation, void* address, uint64_t value, uint32_t timeoutMicroseconds) __attribute__ ((weak_import));
+extern "C" int __ulock_wake (uint32_t operation, void* address, uint64_t wakeValue) __attribute__ ((weak_import));
+#endif
+
+namespace juce
+{
+
+#if ! JUCE_WASM
+
+class SharedMemoryRegion
+{
+public:
+    ~SharedMemoryRegion()
+    {
+        munmap (data, size);
+    }
+
+    static std::unique_ptr<SharedMemoryRegion> create (const String& name, size_t size, bool mustNotExist)
+    {
+        const auto path = getPath (name);
+
+        if (! mustNotExist)
+            unlinkName (path);
+
+        const auto fd = openName (path, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+        if (fd < 0)
+            return {};
+
+        if (ftruncate (fd, (off_t) size) != 0)
+        {
+            ::close (fd);
+            unlinkName (path);
+            return {};
+        }
+
+        auto region = map (fd, size, path);
+
+        if (region == nullptr)
+            unlinkName (path);
+
+        return region;
+    }
+
+    static std::unique_ptr<SharedMemoryRegion> open (const String& name)
+    {
+        const auto path = getPath (name);
+        const auto fd = openName (path, O_RDWR, 0);
+
+        if (fd < 0)
+            return {};
+
+        struct stat info;
+
+        if (fstat (fd, &info) != 0 || info.st_size <= 0)
+        {
+            ::close (fd);
+            return {};
+        }
+
+        return map (fd, (size_t) info.st_size, path);
+    }
+
+    void* getData() const noexcept      { return data; }
+    size_t getSize() const noexcept     { return size; }
+
+    // Stops any more processes from opening the region, and frees it once it's unmapped
+    void removeName()
+    {
+        unlinkName (path);
+    }
+
+    //==============================================================================
+    // These block on the word itself, using whatever the OS provides for waiting on an
+    // address that's shared between processes (the private variants won't do, as the
+    // other process has the region mapped at a different address).
+    void wait (std::atomic<uint32>& word, uint32 expectedValue, int timeoutMs)
+    {
+        static_assert (sizeof (word) == sizeof (uint32) && std::atomic<uint32>::is_always_lock_free);
+        auto* address = reinterpret_cast<uint32*> (&word);
+
+       #if JUCE_LINUX || JUCE_ANDROID
+        const timespec timeout { timeoutMs / 1000, (long) (timeoutMs % 1000) * 1000000 };
+        syscall (SYS_futex, address, FUTEX_WAIT, expectedValue, &timeout, nullptr, 0);
+       #elif JUCE_MAC || JUCE_IOS
+        if (__ulock_wait != nullptr)
+        {
+            __ulock_wait (ulockCompareAndWaitShared, address, expectedValue, (uint32_t) timeoutMs * 1000);
+            return;
+        }
+
+        pollForChange (word, expectedValue, timeoutMs);
+       #elif defined (__FreeBSD__)
+        timespec timeout { timeoutMs / 1000, (long) (timeoutMs % 1000) * 1000000 };
+        _umtx_op (address, UMTX_OP_WAIT_UINT, expectedValue, (void*) sizeof (timeout), &timeout);
+       #else
+        ignoreUnused (address);
+        pollForChange (word, expectedValue, timeoutMs);
+       #endif
+    }
+
+    void wake (std::atomic<uint32>& word)
+    {
+        auto* address = reinterpret_cast<uint32*> (&word);
+
+       #if JUCE_LINUX || JUCE_ANDROID
+        syscall (SYS_futex, address, FUTEX_WAKE, std::numeric_limits<int>::max(), nullptr, nullptr, 0);
+       #elif JUCE_MAC || JUCE_IOS
+        if (__ulock_wake != nullptr)
+            __ulock_wake (ulockCompareAndWaitShared | ulockWakeAll, address, 0);
+       #elif defined (__FreeBSD__)
+        _umtx_op (address, UMTX_OP_WAKE, (u_long) std::numeric_limits<int>::max(), nullptr, nullptr);
+       #else
+        ignoreUnused (address);
+       #endif
+    }
+
+    static int getCurrentProcessId()
+    {
+        return (int) getpid();
+    }
+
+    static bool isProcessRunning (int processId)
+    {
+        if (kill ((pid_t) processId, 0) != 0 && errno != EPERM)
+            return false;
+
+       #if JUCE_LINUX || JUCE_ANDROID
+        // A child process that has died stays around as a zombie until its parent
+        // collects its exit code, so we need to check for that too
+        const auto stat = File ("/proc/" + String (processId) + "/stat").loadFileAsString();
+
+        if (stat.fromLastOccurrenceOf (")", false, false).trimStart().startsWithChar ('Z'))
+            return false;
+       #endif
+
+        return true;
+    }
+
+private:
+    SharedMemoryRegion (void* d, size_t s, const String& p)
+        : data (d), size (s), path (p)
+    {}
+
+   #if JUCE_MAC || JUCE_IOS
+    // (from the xnu sources, as there's no public header for these)
+    static constexpr uint32_t ulockCompareAndWaitShared = 3;
+    static constexpr uint32_t ulockWakeAll              = 0x100;
+   #endif
+
+   #if ! (JUCE_LINUX || JUCE_ANDROID || defined (__FreeBSD__))
+    // For systems with nothing to wait on: this just backs off, checking the word for a change
+    static void pollForChange (const std::atomic<uint32>& word, uint32 expectedValue, int timeoutMs)
+    {
+        const auto endTime = Time::getMillisecondCounter() + (uint32) timeoutMs;
+
+        for (int spins = 0; word.load() == expectedValue; ++spins)
+        {
+            if (Time::getMillisecondCounter() >= endTime)
+                return;
+
+            if (spins < 100)
+                Thread::yield();
+            else
+                Thread::sleep (1);
+        }
+    }
+   #endif
+
+    static String getPath (const String& name)
+    {
+        // (some systems only allow short names, so the user's name is hashed)
+        return "/juce_" + String::toHexString ((int64) name.hashCode64());
+    }
+
+   #if JUCE_ANDROID
+    // Bionic has no shm_open(), and the anonymous shared memory that Android does have
+    // (memfd or ASharedMemory) can only be handed to another process as a file descriptor,
+    // so it can't be found by name. Named regions just fail to open here.
+    static int openName (const String&, int, mode_t)    { errno = ENOSYS; return -1; }
+    static void unlinkName (const String&)              {}
+   #else
+    static int openName (const String& path, int flags, mode_t mode)
+    {
+        return shm_open (path.toRawUTF8(), flags, mode);
+    }
+
+    static void unlinkName (const String& path)
+    {
+        shm_unlink (path.toRawUTF8());
+    }
+   #endif
+
+    static std::unique_ptr<SharedMemoryRegion> map (int fd, size_t size, const String& path)
+    {
+        auto* data = mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close (fd);
+
+        if (data == MAP_FAILED)
+            return {};
+
+        return std::unique_ptr<SharedMemoryRegion> (new SharedMemoryRegion (data, size, path));
+    }
+
+    void* data;
+    size_t size;
+    String path;
+
+    JUCE_DECLARE_NON_COPYABLE (SharedMemoryRegion)
+};
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class SharedMemoryRegion
+{
+public:
+    ~SharedMemoryRegion()
+    {
+        for (auto& e : events)
+            CloseHandle (e.handle);
+
+        UnmapViewOfFile (data);
+        CloseHandle (mapping);
+    }
+
+    static std::unique_ptr<SharedMemoryRegion> create (const String& name, size_t size, [[maybe_unused]] bool mustNotExist)
+    {
+        const auto mapping = CreateFileMappingW (INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                                 (DWORD) ((uint64) size >> 32), (DWORD) size,
+                                                 getPath (name).toWideCharPointer());
+
+        if (mapping == nullptr)
+            return {};
+
+        // A mapping goes away with its last handle, so an existing one always belongs to
+        // a live pipe and can't be replaced, whatever mustNotExist says
+        if (GetLastError() == ERROR_ALREADY_EXISTS)
+        {
+            CloseHandle (mapping);
+            return {};
+        }
+
+        return map (mapping, size, getPath (name));
+    }
+
+    static std::unique_ptr<SharedMemoryRegion> open (const String& name)
+    {
+        const auto mapping = OpenFileMappingW (FILE_MAP_ALL_ACCESS, FALSE, getPath (name).toWideCharPointer());
+
+        if (mapping == nullptr)
+            return {};
+
+        return map (mapping, 0, getPath (name));
+    }
+
+    void* getData() const noexcept      { return data; }
+    size_t getSize() const noexcept     { return size; }
+
+    // Named mappings can't be unlinked on Windows; the name goes when the last handle is closed
+    void removeName() {}
+
+    //==============================================================================
+    // WaitOnAddress doesn't work across processes, so each word that gets waited on has a
+    // named auto-reset event to go with it. A wake that arrives before the wait leaves the
+    // event set, so it can't be lost, though it may cause a spurious wake-up later on.
+    void wait (std::atomic<uint32>& word, uint32 expectedValue, int timeoutMs)
+    {
+        const auto event = getEventFor (word);
+
+        if (event == nullptr)
+        {
+            if (word.load() == expectedValue)
+                Sleep ((DWORD) jmin (1, timeoutMs));
+
+            return;
+        }
+
+        if (word.load() == expectedValue)
+            WaitForSingleObject (event, (DWORD) timeoutMs);
+    }
+
+    void wake (std::atomic<uint32>& word)
+    {
+        if (const auto event = getEventFor (word))
+            SetEvent (event);
+    }
+
+    static int getCurrentProcessId()
+    {
+        return (int) GetCurrentProcessId();
+    }
+
+    static bool isProcessRunning (int processId)
+    {
+        const auto process = OpenProcess (SYNCHRONIZE, FALSE, (DWORD) processId);
+
+        if (process == nullptr)
+            return GetLastError() == ERROR_ACCESS_DENIED;
+
+        const auto running = WaitForSingleObject (process, 0) == WAIT_TIMEOUT;
+        CloseHandle (process);
+        return running;
+    }
+
+private:
+    SharedMemoryRegion (HANDLE m, void* d, size_t s, const String& p)
+        : mapping (m), data (d), size (s), path (p)
+    {}
+
+    struct Event
+    {
+        size_t offset;
+        HANDLE handle;
+    };
+
+    // The events are named after the word's offset in the region, so that both processes
+    // end up with the same one, and are only created the first time they're needed
+    HANDLE getEventFor (std::atomic<uint32>& word)
+    {
+        const auto offset = (size_t) (reinterpret_cast<char*> (&word) - static_cast<char*> (data));
+        const ScopedLock sl (eventLock);
+
+        for (auto& e : events)
+            if (e.offset == offset)
+                return e.handle;
+
+        const auto handle = CreateEventW (nullptr, FALSE, FALSE, (path + "_" + String ((int64) offset)).toWideCharPointer());
+
+        if (handle != nullptr)
+            events.push_back ({ offset, handle });
+
+        return handle;
+    }
+
+    static String getPath (const String& name)
+    {
+        return "Local\\juce_" + String::toHexString ((int64) name.hashCode64());
+    }
+
+    static std::unique_ptr<SharedMemoryRegion> map (HANDLE mapping, size_t size, const String& path)
+    {
+        auto* data = MapViewOfFile (mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+
+        if (data == nullptr)
+        {
+            CloseHandle (mapping);
+            return {};
+        }
+
+        if (size == 0)
+        {
+            MEMORY_BASIC_INFORMATION info;
+
+            if (VirtualQuery (data, &info, sizeof (info)) == 0)
+            {
+                UnmapViewOfFile (data);
+                CloseHandle (mapping);
+                return {};
+            }
+
+            size = info.RegionSize;
+        }
+
+        return std::unique_ptr<SharedMemoryRegion> (new SharedMemoryRegion (mapping, data, size, path));
+    }
+
+    HANDLE mapping;
+    void* data;
+    size_t size;
+    String path;
+    CriticalSection eventLock;
+    std::vector<Event> events;
+
+    JUCE_DECLARE_NON_COPYABLE (SharedMemoryRegion)
+};
+
+} // namespace juce
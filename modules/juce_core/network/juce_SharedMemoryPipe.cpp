@@ -0,0 +1,606 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#if ! JUCE_WASM
+
+//==============================================================================
+// The shared memory starts with a Header, followed by the data for the two rings.
+// Each ring has a single writer and a single reader, which communicate only through
+// its read and write positions. These count the total number of bytes written, so
+// the ring is empty when they're equal.
+//
+// Each message is written as a RecordHeader followed by the data, padded to a
+// multiple of 8 bytes, so that a record never wraps around the end of the ring. If
+// there isn't room for a record at the end, a padding record fills the space.
+class SharedMemoryPipe::Pimpl
+{
+public:
+    Pimpl (std::unique_ptr<SharedMemoryRegion> r, bool isCreator)
+        : region (std::move (r)),
+          header (*static_cast<Header*> (region->getData())),
+          end (isCreator ? 0 : 1)
+    {
+    }
+
+    ~Pimpl()
+    {
+        close();
+    }
+
+    static std::unique_ptr<Pimpl> create (const String& name, int bufferSizeBytes, bool mustNotExist)
+    {
+        const auto ringSize = (uint32) nextPowerOfTwo (jlimit (4096, 1 << 30, bufferSizeBytes));
+        auto region = SharedMemoryRegion::create (name, dataOffset + 2 * (size_t) ringSize, mustNotExist);
+
+        if (region == nullptr)
+            return {};
+
+        auto* h = new (region->getData()) Header();
+        h->version = currentVersion;
+        h->ringSize = ringSize;
+        h->processIds[0] = SharedMemoryRegion::getCurrentProcessId();
+        h->magic.store (magicNumber, std::memory_order_release);
+
+        return std::make_unique<Pimpl> (std::move (region), true);
+    }
+
+    static std::unique_ptr<Pimpl> open (const String& name, int timeoutMs)
+    {
+        const auto endTime = Time::getMillisecondCounter() + (uint32) jmax (0, timeoutMs);
+
+        for (;;)
+        {
+            if (auto region = SharedMemoryRegion::open (name))
+            {
+                auto& h = *static_cast<Header*> (region->getData());
+
+                // (the creator may not have finished setting up the header yet)
+                if (region->getSize() >= sizeof (Header) && h.magic.load (std::memory_order_acquire) == magicNumber)
+                {
+                    int32 noProcess = 0;
+
+                    if (h.version != currentVersion
+                         || region->getSize() < dataOffset + 2 * (size_t) h.ringSize
+                         || ! isPowerOfTwo (h.ringSize)
+                         || ! h.processIds[1].compare_exchange_strong (noProcess, SharedMemoryRegion::getCurrentProcessId()))
+                        return {};
+
+                    region->removeName();
+                    return std::make_unique<Pimpl> (std::move (region), false);
+                }
+            }
+
+            if (Time::getMillisecondCounter() >= endTime)
+                return {};
+
+            Thread::sleep (5);
+        }
+    }
+
+    void close()
+    {
+        header.closed = 1;
+
+        for (auto& ring : header.rings)
+        {
+            notify (ring.dataAvailable, ring.readerIsWaiting);
+            notify (ring.spaceAvailable, ring.writerIsWaiting);
+        }
+    }
+
+    bool isClosed() const noexcept
+    {
+        return header.closed.load() != 0;
+    }
+
+    //==============================================================================
+    bool write (const char* data, size_t numBytes, int timeoutMs)
+    {
+        const ScopedLock sl (writeLock);
+
+        if (numBytes <= getMaxRecordSize())
+            return writeRecord (data, numBytes, RecordType::message, timeoutMs);
+
+        for (size_t pos = 0; pos < numBytes;)
+        {
+            const auto num = jmin (numBytes - pos, getMaxRecordSize());
+            const auto type = pos == 0 ? RecordType::firstPart
+                                       : (pos + num == numBytes ? RecordType::lastPart : RecordType::middlePart);
+
+            if (! writeRecord (data + pos, num, type, timeoutMs))
+            {
+                // The reader can't recover from a message that's only partly written
+                if (pos > 0)
+                    close();
+
+                return false;
+            }
+
+            pos += num;
+        }
+
+        return true;
+    }
+
+    ReadResult read (const MessageCallback& callback, int timeoutMs)
+    {
+        auto& ring = header.rings[1 - end];
+        auto* ringData = getRingData (1 - end);
+        const auto ringSize = (uint64) header.ringSize;
+
+        for (;;)
+        {
+            const auto readPosition = ring.readPosition.load (std::memory_order_relaxed);
+
+            if (! waitUntil (ring.dataAvailable, ring.readerIsWaiting, timeoutMs,
+                             [&] { return ring.writePosition.load (std::memory_order_acquire) != readPosition; }))
+                return isClosed() ? ReadResult::closed : ReadResult::timedOut;
+
+            const auto offset = (size_t) (readPosition & (ringSize - 1));
+            const auto available = ring.writePosition.load (std::memory_order_acquire) - readPosition;
+
+            RecordHeader record;
+            memcpy (&record, ringData + offset, sizeof (record));
+
+            const auto recordSize = record.type == (uint32) RecordType::padding
+                                        ? ringSize - offset
+                                        : (uint64) getRecordSize (record.size);
+
+            if (record.size > getMaxRecordSize() || record.type > (uint32) RecordType::padding
+                 || offset + recordSize > ringSize || recordSize > available)
+            {
+                jassertfalse; // the data has been corrupted!
+                close();
+                return ReadResult::closed;
+            }
+
+            const Span<const std::byte> contents (reinterpret_cast<const std::byte*> (ringData + offset + sizeof (record)),
+                                                  record.size);
+            bool messageRead = true;
+
+            switch ((RecordType) record.type)
+            {
+                case RecordType::message:
+                    callback (contents);
+                    break;
+
+                case RecordType::firstPart:
+                    partialMessage.reset();
+                    partialMessage.write (contents.data(), contents.size());
+                    messageRead = false;
+                    break;
+
+                case RecordType::middlePart:
+                    partialMessage.write (contents.data(), contents.size());
+                    messageRead = false;
+                    break;
+
+                case RecordType::lastPart:
+                    partialMessage.write (contents.data(), contents.size());
+                    callback ({ static_cast<const std::byte*> (partialMessage.getData()), partialMessage.getDataSize() });
+                    partialMessage.reset();
+                    break;
+
+                case RecordType::padding:
+                    messageRead = false;
+                    break;
+            }
+
+            ring.readPosition.store (readPosition + recordSize, std::memory_order_release);
+            notify (ring.spaceAvailable, ring.writerIsWaiting);
+
+            if (messageRead)
+                return ReadResult::messageRead;
+        }
+    }
+
+private:
+    //==============================================================================
+    struct Ring
+    {
+        alignas (64) std::atomic<uint64> writePosition;
+        std::atomic<uint32> dataAvailable, readerIsWaiting;
+
+        alignas (64) std::atomic<uint64> readPosition;
+        std::atomic<uint32> spaceAvailable, writerIsWaiting;
+    };
+
+    struct Header
+    {
+        std::atomic<uint32> magic;
+        uint32 version, ringSize;
+        std::atomic<int32> processIds[2];   // the creator, and the process that opened it
+        std::atomic<uint32> closed;
+        Ring rings[2];                      // rings[n] is written by processIds[n]
+    };
+
+    enum class RecordType : uint32
+    {
+        message,
+        firstPart,
+        middlePart,
+        lastPart,
+        padding
+    };
+
+    struct RecordHeader
+    {
+        uint32 size, type;
+    };
+
+    static_assert (std::atomic<uint64>::is_always_lock_free && std::atomic<uint32>::is_always_lock_free,
+                   "The atomics must be lock-free to work across processes");
+
+    static constexpr uint32 magicNumber = 0x5a3c9e71, currentVersion = 1;
+    static constexpr size_t dataOffset = (sizeof (Header) + 63) & ~(size_t) 63;
+
+    std::unique_ptr<SharedMemoryRegion> region;
+    Header& header;
+    const int end;
+    CriticalSection writeLock;
+    MemoryOutputStream partialMessage;
+
+    char* getRingData (int index) const noexcept
+    {
+        return static_cast<char*> (region->getData()) + dataOffset + (size_t) index * header.ringSize;
+    }
+
+    size_t getMaxRecordSize() const noexcept                   { return header.ringSize / 4 - sizeof (RecordHeader); }
+    static size_t getRecordSize (size_t numBytes) noexcept      { return sizeof (RecordHeader) + ((numBytes + 7) & ~(size_t) 7); }
+
+    bool writeRecord (const char* data, size_t numBytes, RecordType type, int timeoutMs)
+    {
+        auto& ring = header.rings[end];
+        auto* ringData = getRingData (end);
+        const auto ringSize = (uint64) header.ringSize;
+
+        auto writePosition = ring.writePosition.load (std::memory_order_relaxed);
+        const auto recordSize = getRecordSize (numBytes);
+        auto offset = (size_t) (writePosition & (ringSize - 1));
+        const auto paddingSize = offset + recordSize > ringSize ? (size_t) (ringSize - offset) : 0;
+
+        if (! waitUntil (ring.spaceAvailable, ring.writerIsWaiting, timeoutMs, [&]
+                         {
+                             const auto used = writePosition - ring.readPosition.load (std::memory_order_acquire);
+                             return ringSize - used >= paddingSize + recordSize;
+                         })
+             || isClosed())
+            return false;
+
+        if (paddingSize > 0)
+        {
+            const RecordHeader padding { 0, (uint32) RecordType::padding };
+            memcpy (ringData + offset, &padding, sizeof (padding));
+            writePosition += paddingSize;
+            offset = 0;
+        }
+
+        const RecordHeader record { (uint32) numBytes, (uint32) type };
+        memcpy (ringData + offset, &record, sizeof (record));
+        memcpy (ringData + offset + sizeof (record), data, numBytes);
+
+        ring.writePosition.store (writePosition + recordSize, std::memory_order_release);
+        notify (ring.dataAvailable, ring.readerIsWaiting);
+        return true;
+    }
+
+    void notify (std::atomic<uint32>& doorbell, std::atomic<uint32>& waitingFlag)
+    {
+        ++doorbell;
+
+        if (waitingFlag.load() != 0)
+            region->wake (doorbell);
+    }
+
+    // Waits until the condition is true, sleeping on the doorbell if it takes more than a
+    // moment. Returns false if the timeout expires or the pipe is closed first.
+    template <typename Condition>
+    bool waitUntil (std::atomic<uint32>& doorbell, std::atomic<uint32>& waitingFlag, int timeoutMs, Condition&& condition)
+    {
+        for (int i = 0; i < 50; ++i)
+        {
+            if (condition())
+                return true;
+
+            if (isClosed())
+                return false;
+
+            std::this_thread::yield();
+        }
+
+        const auto startTime = Time::getMillisecondCounter();
+        auto lastProcessCheckTime = startTime;
+
+        for (;;)
+        {
+            const auto doorbellValue = doorbell.load();
+            waitingFlag = 1;
+
+            const auto result = condition();
+
+            if (result || isClosed())
+            {
+                waitingFlag = 0;
+                return result;
+            }
+
+            const auto now = Time::getMillisecondCounter();
+            const auto elapsed = (int) (now - startTime);
+
+            // Checking the other process is relatively slow, so it's only done once
+            // we've been waiting for a while, in case it has died
+            if (now - lastProcessCheckTime >= 100)
+            {
+                lastProcessCheckTime = now;
+
+                if (! isOtherProcessRunning())
+                {
+                    waitingFlag = 0;
+                    return false;
+                }
+            }
+
+            if (timeoutMs >= 0 && elapsed >= timeoutMs)
+            {
+                waitingFlag = 0;
+                return false;
+            }
+
+            region->wait (doorbell, doorbellValue, timeoutMs >= 0 ? jmin (100, timeoutMs - elapsed) : 100);
+            waitingFlag = 0;
+        }
+    }
+
+    bool isOtherProcessRunning()
+    {
+        const auto processId = header.processIds[1 - end].load();
+
+        if (processId == 0 || SharedMemoryRegion::isProcessRunning (processId))
+            return true;
+
+        header.closed = 1;
+        return false;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Pimpl)
+};
+
+//==============================================================================
+SharedMemoryPipe::SharedMemoryPipe() {}
+
+SharedMemoryPipe::~SharedMemoryPipe()
+{
+    close();
+}
+
+bool SharedMemoryPipe::createNewPipe (const String& pipeName, int bufferSizeBytes, bool mustNotExist)
+{
+    close();
+
+    const ScopedWriteLock sl (lock);
+    currentPipeName = pipeName;
+    pimpl = Pimpl::create (pipeName, bufferSizeBytes, mustNotExist);
+    return pimpl != nullptr;
+}
+
+bool SharedMemoryPipe::openExisting (const String& pipeName, int timeOutMilliseconds)
+{
+    close();
+
+    const ScopedWriteLock sl (lock);
+    currentPipeName = pipeName;
+    pimpl = Pimpl::open (pipeName, timeOutMilliseconds);
+    return pimpl != nullptr;
+}
+
+void SharedMemoryPipe::close()
+{
+    // (the memory stays mapped until the pipe is re-opened or deleted, so that this
+    // is safe to call while other threads are using it)
+    const ScopedReadLock sl (lock);
+
+    if (pimpl != nullptr)
+        pimpl->close();
+}
+
+bool SharedMemoryPipe::isOpen() const
+{
+    const ScopedReadLock sl (lock);
+    return pimpl != nullptr && ! pimpl->isClosed();
+}
+
+String SharedMemoryPipe::getName() const
+{
+    const ScopedReadLock sl (lock);
+    return currentPipeName;
+}
+
+bool SharedMemoryPipe::write (const void* sourceData, size_t numBytes, int timeOutMilliseconds)
+{
+    const ScopedReadLock sl (lock);
+    return pimpl != nullptr && pimpl->write (static_cast<const char*> (sourceData), numBytes, timeOutMilliseconds);
+}
+
+SharedMemoryPipe::ReadResult SharedMemoryPipe::read (const MessageCallback& messageCallback, int timeOutMilliseconds)
+{
+    const ScopedReadLock sl (lock);
+
+    if (pimpl == nullptr)
+        return ReadResult::closed;
+
+    return pimpl->read (messageCallback, timeOutMilliseconds);
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS && ! JUCE_ANDROID
+
+class SharedMemoryPipeTests final : public UnitTest
+{
+public:
+    SharedMemoryPipeTests()
+        : UnitTest ("SharedMemoryPipe", UnitTestCategories::networking)
+    {}
+
+    void runTest() override
+    {
+        const auto pipeName = "TestSharedMemoryPipe" + String ((intptr_t) Thread::getCurrentThreadId());
+        auto r = getRandom();
+
+        beginTest ("Create and open");
+        {
+            SharedMemoryPipe pipe;
+            expect (! pipe.isOpen());
+            expect (pipe.createNewPipe (pipeName, 4096, true));
+            expect (pipe.isOpen());
+            expectEquals (pipe.getName(), pipeName);
+
+            SharedMemoryPipe otherPipe;
+            expect (! otherPipe.createNewPipe (pipeName, 4096, true));
+
+            expect (otherPipe.openExisting (pipeName));
+            expect (otherPipe.isOpen());
+
+            SharedMemoryPipe thirdPipe;
+            expect (! thirdPipe.openExisting (pipeName));
+            expect (! thirdPipe.openExisting (pipeName + "x"));
+        }
+
+        beginTest ("Messages");
+        {
+            SharedMemoryPipe sender, receiver;
+            expect (sender.createNewPipe (pipeName, 4096));
+            expect (receiver.openExisting (pipeName));
+
+            MemoryBlock received;
+            const auto receive = [&] (Span<const std::byte> m) { received.replaceAll (m.data(), m.size()); };
+
+            expect (receiver.read (receive, 0) == SharedMemoryPipe::ReadResult::timedOut);
+
+            // (enough messages to wrap around the ring many times, including ones that
+            // need to be split into parts)
+            for (int i = 0; i < 500; ++i)
+            {
+                MemoryBlock message ((size_t) (i % 10 == 0 ? r.nextInt (3000) : r.nextInt (300)));
+                r.fillBitsRandomly (message.getData(), message.getSize());
+
+                expect (sender.write (message.getData(), message.getSize(), 0));
+                expect (receiver.read (receive, 0) == SharedMemoryPipe::ReadResult::messageRead);
+                expect (received == message);
+            }
+
+            int numWritten = 0;
+
+            while (sender.write (&numWritten, sizeof (numWritten), 0))
+                ++numWritten;
+
+            // (there may be a padding record at the end of the ring)
+            expect (numWritten == 4096 / 16 || numWritten == 4096 / 16 - 1);
+
+            for (int i = 0; i < numWritten; ++i)
+            {
+                expect (receiver.read (receive, 0) == SharedMemoryPipe::ReadResult::messageRead);
+                expect (received == MemoryBlock (&i, sizeof (i)));
+            }
+
+            expect (receiver.write ("abc", 3, 0));
+            sender.close();
+            expect (! receiver.isOpen());
+            expect (receiver.read (receive, 0) == SharedMemoryPipe::ReadResult::closed);
+            expect (sender.read (receive, 0) == SharedMemoryPipe::ReadResult::messageRead);
+            expect (received == MemoryBlock ("abc", 3));
+            expect (sender.read (receive, 0) == SharedMemoryPipe::ReadResult::closed);
+        }
+
+        beginTest ("Streaming between threads");
+        {
+            SharedMemoryPipe sender, receiver;
+            expect (sender.createNewPipe (pipeName, 8192));
+            expect (receiver.openExisting (pipeName));
+
+            constexpr int numMessages = 20000;
+            std::atomic<bool> messagesMatched { true };
+
+            std::thread reader ([&]
+            {
+                for (int i = 0; i < numMessages; ++i)
+                {
+                    const auto result = receiver.read ([&] (Span<const std::byte> m)
+                    {
+                        const auto expectedSize = (size_t) (i % 1000 == 0 ? 5000 : 4 + i % 50);
+
+                        if (m.size() != expectedSize || readUnaligned<int> (m.data()) != i)
+                            messagesMatched = false;
+                    }, 5000);
+
+                    if (result != SharedMemoryPipe::ReadResult::messageRead)
+                        messagesMatched = false;
+                }
+            });
+
+            HeapBlock<char> message (5000, true);
+
+            for (int i = 0; i < numMessages; ++i)
+            {
+                writeUnaligned (message.get(), i);
+                expect (sender.write (message, (size_t) (i % 1000 == 0 ? 5000 : 4 + i % 50), 5000));
+            }
+
+            reader.join();
+            expect (messagesMatched);
+        }
+
+        beginTest ("Close wakes up a waiting reader");
+        {
+            SharedMemoryPipe sender, receiver;
+            expect (sender.createNewPipe (pipeName, 4096));
+            expect (receiver.openExisting (pipeName));
+
+            std::thread closer ([&] { Thread::sleep (50); sender.close(); });
+            expect (receiver.read ([] (auto) {}, -1) == SharedMemoryPipe::ReadResult::closed);
+            closer.join();
+        }
+    }
+};
+
+static SharedMemoryPipeTests sharedMemoryPipeTests;
+
+#endif
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A fast message-based connection between two processes on the same machine,
+    which passes data through a block of shared memory.
+
+    The memory holds a ring buffer for each direction. Sending a message copies it
+    straight into the buffer, and a message that's read is passed to a callback in
+    place, without being copied out. On Linux a futex is used to wake up an end that's
+    waiting, and this only needs a system call if the other end is actually asleep,
+    so streaming lots of small messages is much cheaper than with a NamedPipe or a
+    socket. Elsewhere, an end that's waiting polls the memory.
+
+    Each end must only be written to by one thread at a time, and read by one thread
+    at a time. Messages that are too large to fit into a quarter of the buffer are
+    split up when they're written and put back together by the reader.
+
+    Android doesn't support named shared memory, so there createNewPipe() and
+    openExisting() always fail.
+
+    @see NamedPipe, InterprocessConnection
+
+    @tags{Core}
+*/
+class JUCE_API  SharedMemoryPipe  final
+{
+public:
+    //==============================================================================
+    /** Creates a SharedMemoryPipe. */
+    SharedMemoryPipe();
+
+    /** Destructor. */
+    ~SharedMemoryPipe();
+
+    //==============================================================================
+    /** Tries to create a new pipe, which another process can connect to by calling
+        openExisting() with the same name.
+
+        bufferSizeBytes is the size of the buffer for each direction, which is rounded
+        up to a power of two. If mustNotExist is true then it will fail if a pipe with
+        the same name has already been created.
+    */
+    bool createNewPipe (const String& pipeName, int bufferSizeBytes = 1 << 20, bool mustNotExist = false);
+
+    /** Tries to connect to a pipe that was created by another process.
+
+        If the pipe doesn't exist yet, this keeps trying until the timeout has elapsed.
+        Only one process can connect to each pipe.
+    */
+    bool openExisting (const String& pipeName, int timeOutMilliseconds = 0);
+
+    /** Closes the pipe, so that both ends see it as being closed.
+        This can be called while other threads are waiting to read or write, which will
+        make them return.
+    */
+    void close();
+
+    /** True if the pipe has been created or opened, and neither end has closed it.
+        The pipe is also closed if the other process stops running.
+    */
+    bool isOpen() const;
+
+    /** Returns the last name that was used to try to open this pipe. */
+    String getName() const;
+
+    //==============================================================================
+    /** Sends a message to the other end.
+
+        If there isn't enough space in the buffer, this waits for the other end to read
+        some messages. If timeOutMilliseconds is less than zero, it will wait indefinitely.
+        Returns false if the message couldn't be written.
+    */
+    bool write (const void* sourceData, size_t numBytes, int timeOutMilliseconds);
+
+    /** The possible results of a call to read(). */
+    enum class ReadResult
+    {
+        messageRead,    /**< A message was passed to the callback. */
+        timedOut,       /**< No message arrived before the timeout elapsed. */
+        closed          /**< The pipe has been closed, and there are no more messages to read. */
+    };
+
+    /** The type of callback that read() passes messages to.
+
+        Unlike a std::function, this never allocates, so a lambda can be passed to read()
+        on a realtime thread, as long as its captures fit into 64 bytes.
+    */
+    using MessageCallback = FixedSizeFunction<64, void (Span<const std::byte>)>;
+
+    /** Waits for the next message, and passes it to the callback.
+
+        The data that the callback is given points into the shared buffer, so it's only
+        valid until the callback returns. If timeOutMilliseconds is less than zero, this
+        will wait indefinitely.
+    */
+    ReadResult read (const MessageCallback& messageCallback, int timeOutMilliseconds);
+
+private:
+    //==============================================================================
+    class Pimpl;
+    std::unique_ptr<Pimpl> pimpl;
+    String currentPipeName;
+    ReadWriteLock lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedMemoryPipe)
+};
+
+} // namespace juce
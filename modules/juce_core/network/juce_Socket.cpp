@@ -311,6 +311,68 @@ namespace SocketHelpers
         return (int) bytesRead;
     }
 
+    static bool isWouldBlockError() noexcept
+    {
+       #if JUCE_WINDOWS
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+       #else
+        return errno == EWOULDBLOCK || errno == EAGAIN;
+       #endif
+    }
+
+    static bool isInterruptedError() noexcept
+    {
+       #if JUCE_WINDOWS
+        return false;
+       #else
+        return errno == EINTR;
+       #endif
+    }
+
+    static int readSocketNonBlocking (SocketHandle handle, void* destBuffer, int maxBytesToRead,
+                                      const std::atomic<bool>& connected, CriticalSection& readLock) noexcept
+    {
+        // avoid race-condition
+        CriticalSection::ScopedTryLockType lock (readLock);
+
+        if (! lock.isLocked() || maxBytesToRead <= 0)
+            return 0;
+
+        auto bytesRead = ::recv (handle, static_cast<char*> (destBuffer), (juce_recvsend_size_t) maxBytesToRead, 0);
+
+        // (a call that was interrupted by a signal didn't do anything, so it's retried)
+        while (bytesRead < 0 && isInterruptedError() && connected)
+            bytesRead = ::recv (handle, static_cast<char*> (destBuffer), (juce_recvsend_size_t) maxBytesToRead, 0);
+
+        if (! connected)
+            return -1;
+
+        if (bytesRead < 0)
+            return isWouldBlockError() ? 0 : -1;
+
+        // (a read of 0 bytes means that the other end has closed the connection)
+        return bytesRead > 0 ? (int) bytesRead : -1;
+    }
+
+    static int writeSocketNonBlocking (SocketHandle handle, const void* sourceBuffer, int numBytesToWrite) noexcept
+    {
+       #ifdef MSG_NOSIGNAL
+        constexpr int flags = MSG_NOSIGNAL;  // report a closed connection as an error, rather than raising SIGPIPE
+       #else
+        constexpr int flags = 0;
+       #endif
+
+        auto bytesWritten = ::send (handle, static_cast<const char*> (sourceBuffer), (juce_recvsend_size_t) numBytesToWrite, flags);
+
+        while (bytesWritten < 0 && isInterruptedError())
+            bytesWritten = ::send (handle, static_cast<const char*> (sourceBuffer), (juce_recvsend_size_t) numBytesToWrite, flags);
+
+        if (bytesWritten < 0)
+            return isWouldBlockError() ? 0 : -1;
+
+        return (int) bytesWritten;
+    }
+
     static int waitForReadiness (std::atomic<int>& handle, CriticalSection& readLock,
                                  bool forReading, int timeoutMsecs) noexcept
     {
@@ -519,6 +581,11 @@ StreamingSocket::~StreamingSocket()
 //==============================================================================
 int StreamingSocket::read (void* destBuffer, int maxBytesToRead, bool shouldBlock)
 {
+    if (nonBlocking)
+        return (connected && ! isListener) ? SocketHelpers::readSocketNonBlocking ((SocketHandle) handle.load(), destBuffer, maxBytesToRead,
+                                                                               connected, readLock)
+                                           : -1;
+
     return (connected && ! isListener) ? SocketHelpers::readSocket ((SocketHandle) handle.load(), destBuffer,maxBytesToRead,
                                                                     connected, shouldBlock, readLock)
                                        : -1;
@@ -529,9 +596,19 @@ int StreamingSocket::write (const void* sourceBuffer, int numBytesToWrite)
     if (isListener || ! connected)
         return -1;
 
+    if (nonBlocking)
+        return SocketHelpers::writeSocketNonBlocking ((SocketHandle) handle.load(), sourceBuffer, numBytesToWrite);
+
     return (int) ::send ((SocketHandle) handle.load(), (const char*) sourceBuffer, (juce_recvsend_size_t) numBytesToWrite, 0);
 }
 
+bool StreamingSocket::setNonBlockingMode (bool shouldBeNonBlocking)
+{
+    nonBlocking = shouldBeNonBlocking;
+
+    return handle < 0 || SocketHelpers::setSocketBlockingState ((SocketHandle) handle.load(), ! shouldBeNonBlocking);
+}
+
 //==============================================================================
 int StreamingSocket::waitUntilReady (bool readyForReading, int timeoutMsecs)
 {
@@ -581,7 +658,8 @@ bool StreamingSocket::connect (const String& remoteHostName, int remotePortNumbe
     if (! connected)
         return false;
 
-    if (! SocketHelpers::resetSocketOptions ((SocketHandle) handle.load(), false, false, options))
+    if (! SocketHelpers::resetSocketOptions ((SocketHandle) handle.load(), false, false, options)
+         || (nonBlocking && ! SocketHelpers::setSocketBlockingState ((SocketHandle) handle.load(), false)))
     {
         close();
         return false;
@@ -592,8 +670,9 @@ bool StreamingSocket::connect (const String& remoteHostName, int remotePortNumbe
 
 void StreamingSocket::close()
 {
+    // (a non-blocking listener can't be stuck in accept(), so doesn't need to be interrupted)
     if (handle >= 0)
-        SocketHelpers::closeSocket (handle, readLock, isListener, portNumber, connected);
+        SocketHelpers::closeSocket (handle, readLock, isListener && ! nonBlocking, portNumber, connected);
 
     hostName.clear();
     portNumber = 0;
@@ -623,7 +702,8 @@ bool StreamingSocket::createListener (int newPortNumber, const String& localHost
    #endif
 
     if (SocketHelpers::bindSocket ((SocketHandle) handle.load(), portNumber, localHostName)
-         && listen ((SocketHandle) handle.load(), SOMAXCONN) >= 0)
+         && listen ((SocketHandle) handle.load(), SOMAXCONN) >= 0
+         && (! nonBlocking || SocketHelpers::setSocketBlockingState ((SocketHandle) handle.load(), false)))
     {
         connected = true;
         return true;
@@ -646,8 +726,15 @@ StreamingSocket* StreamingSocket::waitForNextConnection() const
         auto newSocket = (int) accept ((SocketHandle) handle.load(), (struct sockaddr*) &address, &len);
 
         if (newSocket >= 0 && connected)
-            return new StreamingSocket (inet_ntoa (((struct sockaddr_in*) &address)->sin_addr),
-                                        portNumber, newSocket, options);
+        {
+            auto* s = new StreamingSocket (inet_ntoa (((struct sockaddr_in*) &address)->sin_addr),
+                                           portNumber, newSocket, options);
+
+            if (nonBlocking)
+                s->setNonBlockingMode (true);
+
+            return s;
+        }
     }
 
     return nullptr;
@@ -876,6 +963,49 @@ struct SocketTests final : public UnitTest
             expect (static_cast<SocketHandle> (socket.getRawSocketHandle()) == invalidSocket);
         }
 
+        beginTest ("Non-blocking StreamingSocket");
+        {
+            auto waitFor = [] (auto&& condition)
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    if (condition())
+                        return true;
+
+                    Thread::sleep (5);
+                }
+
+                return false;
+            };
+
+            StreamingSocket listener;
+
+            expect (listener.setNonBlockingMode (true));
+            expect (listener.createListener (0, localHost.toString()));
+            expect (std::unique_ptr<StreamingSocket> (listener.waitForNextConnection()) == nullptr);
+
+            StreamingSocket socket;
+
+            expect (socket.connect (localHost.toString(), listener.getBoundPort()));
+
+            std::unique_ptr<StreamingSocket> accepted;
+
+            expect (waitFor ([&] { accepted.reset (listener.waitForNextConnection()); return accepted != nullptr; }));
+            expect (accepted->isNonBlocking());
+
+            char buffer[16];
+            int numRead = 0;
+
+            expect (accepted->read (buffer, (int) sizeof (buffer), true) == 0);
+            expect (socket.write ("hello", 5) == 5);
+            expect (waitFor ([&] { numRead = accepted->read (buffer, (int) sizeof (buffer), false); return numRead != 0; }));
+            expect (numRead == 5 && memcmp (buffer, "hello", 5) == 0);
+
+            socket.close();
+
+            expect (waitFor ([&] { return accepted->read (buffer, (int) sizeof (buffer), false) < 0; }));
+        }
+
         beginTest ("DatagramSocket");
         {
             DatagramSocket socket;
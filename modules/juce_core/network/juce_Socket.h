@@ -86,7 +86,7 @@ private:
     This allows low-level use of sockets; for an easier-to-use messaging layer on top of
     sockets, you could also try the InterprocessConnection class.
 
-    @see DatagramSocket, InterprocessConnection, InterprocessConnectionServer
+    @see DatagramSocket, InterprocessConnection, InterprocessConnectionServer, SocketReactor
 
     @tags{Core}
 */
@@ -206,8 +206,11 @@ public:
         flag is false, the method will return as much data as is currently available
         without blocking.
 
+        If the socket is in non-blocking mode, the flag is ignored, and this returns
+        0 if there's no data available, or -1 if the connection has been closed.
+
         @returns  the number of bytes read, or -1 if there was an error
-        @see waitUntilReady
+        @see waitUntilReady, setNonBlockingMode
     */
     int read (void* destBuffer, int maxBytesToRead,
               bool blockUntilSpecifiedAmountHasArrived);
@@ -217,10 +220,32 @@ public:
         Note that this method will block unless you have checked the socket is ready
         for writing before calling it (see the waitUntilReady() method).
 
+        If the socket is in non-blocking mode, this never blocks, and writes as many
+        bytes as the OS will accept, which may be 0 if its send buffer is full.
+
         @returns  the number of bytes written, or -1 if there was an error
+        @see setNonBlockingMode
     */
     int write (const void* sourceBuffer, int numBytesToWrite);
 
+    //==============================================================================
+    /** Puts the socket into, or takes it out of, non-blocking mode.
+
+        In non-blocking mode, read(), write() and waitForNextConnection() return
+        immediately instead of waiting for the other end, which lets one thread service
+        many sockets. The mode is kept if the socket is reconnected, and sockets
+        returned by waitForNextConnection() inherit it from the listener.
+
+        @returns  true on success
+        @see SocketReactor
+    */
+    bool setNonBlockingMode (bool shouldBeNonBlocking);
+
+    /** Returns true if the socket is in non-blocking mode.
+        @see setNonBlockingMode
+    */
+    bool isNonBlocking() const noexcept                         { return nonBlocking; }
+
     //==============================================================================
     /** Puts this socket into "listener" mode.
 
@@ -242,7 +267,8 @@ public:
 
         The object that gets returned will be owned by the caller.
 
-        This method can only be called after using createListener().
+        This method can only be called after using createListener(). If the socket is
+        in non-blocking mode, this returns nullptr if there's no connection waiting.
 
         @see createListener
     */
@@ -253,7 +279,7 @@ private:
     SocketOptions options;
     String hostName;
     std::atomic<int> portNumber { 0 }, handle { -1 };
-    std::atomic<bool> connected { false }, isListener { false };
+    std::atomic<bool> connected { false }, isListener { false }, nonBlocking { false };
     mutable CriticalSection readLock;
 
     StreamingSocket (const String& hostname, int portNumber, int handle, const SocketOptions& options);
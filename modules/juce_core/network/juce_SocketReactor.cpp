@@ -0,0 +1,884 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#if ! JUCE_WASM
+
+//==============================================================================
+// Waits for any of a set of sockets to become ready. The add(), remove() and
+// setWantsToWrite() methods can be called on any thread, while the event loop's
+// thread is waiting.
+class SocketReactor::Poller
+{
+public:
+    struct Event
+    {
+        void* userData;
+        bool readable, writable;  // (errors and hang-ups are reported as readable)
+    };
+
+    virtual ~Poller() = default;
+
+    virtual bool add (int handle, void* userData) = 0;
+    virtual void remove (int handle) = 0;
+    virtual void setWantsToWrite (int handle, void* userData, bool shouldWrite) = 0;
+
+    // Waits until some sockets are ready, or wake() is called
+    virtual int wait (Event* events, int maxEvents) = 0;
+    virtual void wake() = 0;
+
+    static std::unique_ptr<Poller> create();
+
+private:
+    class Epoll;
+    class Generic;
+};
+
+#if JUCE_LINUX || JUCE_ANDROID
+class SocketReactor::Poller::Epoll final : public Poller
+{
+public:
+    Epoll()
+        : epollFd (epoll_create1 (EPOLL_CLOEXEC)),
+          wakeFd (eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+        if (epollFd >= 0 && wakeFd >= 0)
+            valid = control (EPOLL_CTL_ADD, wakeFd, this, false);
+    }
+
+    ~Epoll() override
+    {
+        if (epollFd >= 0)  ::close (epollFd);
+        if (wakeFd >= 0)   ::close (wakeFd);
+    }
+
+    bool isValid() const noexcept    { return valid; }
+
+    bool add (int handle, void* userData) override
+    {
+        return control (EPOLL_CTL_ADD, handle, userData, false);
+    }
+
+    void remove (int handle) override
+    {
+        epoll_event event {};
+        epoll_ctl (epollFd, EPOLL_CTL_DEL, handle, &event);
+    }
+
+    void setWantsToWrite (int handle, void* userData, bool shouldWrite) override
+    {
+        control (EPOLL_CTL_MOD, handle, userData, shouldWrite);
+    }
+
+    int wait (Event* events, int maxEvents) override
+    {
+        const auto numReady = epoll_wait (epollFd, readyEvents.data(), jmin (maxEvents, (int) readyEvents.size()), -1);
+        int numEvents = 0;
+
+        for (int i = 0; i < numReady; ++i)
+        {
+            const auto& e = readyEvents[(size_t) i];
+
+            if (e.data.ptr == this)
+            {
+                uint64_t value;
+                [[maybe_unused]] auto numBytes = ::read (wakeFd, &value, sizeof (value));
+                continue;
+            }
+
+            events[numEvents++] = { e.data.ptr,
+                                    (e.events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0,
+                                    (e.events & EPOLLOUT) != 0 };
+        }
+
+        return numEvents;
+    }
+
+    void wake() override
+    {
+        const uint64_t value = 1;
+        [[maybe_unused]] auto numBytes = ::write (wakeFd, &value, sizeof (value));
+    }
+
+private:
+    const int epollFd, wakeFd;
+    bool valid = false;
+    std::array<epoll_event, 256> readyEvents;
+
+    bool control (int operation, int handle, void* userData, bool shouldWrite)
+    {
+        epoll_event event {};
+        event.events = EPOLLIN | (shouldWrite ? (uint32_t) EPOLLOUT : 0u);
+        event.data.ptr = userData;
+        return epoll_ctl (epollFd, operation, handle, &event) == 0;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Epoll)
+};
+#endif
+
+//==============================================================================
+// Uses poll(), rebuilding the list of sockets each time it waits. To wake it, a
+// datagram is sent to a socket that's bound to the loopback interface.
+class SocketReactor::Poller::Generic final : public Poller
+{
+public:
+    Generic()
+    {
+        wakeReceiver.bindToPort (0, "127.0.0.1");
+    }
+
+    bool isValid()    { return wakeReceiver.getBoundPort() > 0; }
+
+    bool add (int handle, void* userData) override
+    {
+        {
+            const ScopedLock sl (lock);
+            sockets.push_back ({ handle, userData, false });
+        }
+
+        wake();
+        return true;
+    }
+
+    void remove (int handle) override
+    {
+        {
+            const ScopedLock sl (lock);
+            sockets.erase (std::remove_if (sockets.begin(), sockets.end(), [handle] (auto& s) { return s.handle == handle; }),
+                           sockets.end());
+        }
+
+        wake();
+    }
+
+    void setWantsToWrite (int handle, void* userData, bool shouldWrite) override
+    {
+        {
+            const ScopedLock sl (lock);
+
+            for (auto& s : sockets)
+                if (s.handle == handle)
+                    s = { handle, userData, shouldWrite };
+        }
+
+        wake();
+    }
+
+    int wait (Event* events, int maxEvents) override
+    {
+        pollFds.clear();
+        pollUserData.clear();
+        pollFds.push_back ({ (SocketHandle) wakeReceiver.getRawSocketHandle(), POLLIN, 0 });
+        pollUserData.push_back (nullptr);
+
+        {
+            const ScopedLock sl (lock);
+
+            for (auto& s : sockets)
+            {
+                pollFds.push_back ({ (SocketHandle) s.handle, (short) (POLLIN | (s.wantsToWrite ? POLLOUT : 0)), 0 });
+                pollUserData.push_back (s.userData);
+            }
+        }
+
+       #if JUCE_WINDOWS
+        // (WSAPoll doesn't report failed connection attempts, but these sockets are already connected)
+        const auto numReady = WSAPoll (pollFds.data(), (ULONG) pollFds.size(), -1);
+       #else
+        const auto numReady = ::poll (pollFds.data(), (nfds_t) pollFds.size(), -1);
+       #endif
+
+        if (numReady <= 0)
+            return 0;
+
+        if (pollFds.front().revents != 0)
+        {
+            char buffer[64];
+
+            while (wakeReceiver.read (buffer, (int) sizeof (buffer), false) > 0)
+            {}
+        }
+
+        int numEvents = 0;
+
+        for (size_t i = 1; i < pollFds.size() && numEvents < maxEvents; ++i)
+        {
+            const auto revents = pollFds[i].revents;
+
+            if (revents != 0)
+                events[numEvents++] = { pollUserData[i],
+                                        (revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL)) != 0,
+                                        (revents & POLLOUT) != 0 };
+        }
+
+        return numEvents;
+    }
+
+    void wake() override
+    {
+        const ScopedLock sl (wakeLock);
+        const char byte = 0;
+        wakeSender.write ("127.0.0.1", wakeReceiver.getBoundPort(), &byte, 1);
+    }
+
+private:
+    struct Socket
+    {
+        int handle;
+        void* userData;
+        bool wantsToWrite;
+    };
+
+   #if JUCE_WINDOWS
+    using PollFd = WSAPOLLFD;
+   #else
+    using PollFd = pollfd;
+   #endif
+
+    CriticalSection lock, wakeLock;
+    std::vector<Socket> sockets;
+    std::vector<PollFd> pollFds;
+    std::vector<void*> pollUserData;
+    DatagramSocket wakeReceiver, wakeSender;
+
+    JUCE_DECLARE_NON_COPYABLE (Generic)
+};
+
+std::unique_ptr<SocketReactor::Poller> SocketReactor::Poller::create()
+{
+   #if JUCE_LINUX || JUCE_ANDROID
+    if (auto epoll = std::make_unique<Epoll>(); epoll->isValid())
+        return epoll;
+   #endif
+
+    if (auto generic = std::make_unique<Generic>(); generic->isValid())
+        return generic;
+
+    jassertfalse;  // couldn't create the sockets used for waking the event loop
+    return {};
+}
+
+//==============================================================================
+class SocketReactor::EventLoop final : private Thread
+{
+public:
+    EventLoop (SocketReactor& r, int index)
+        : Thread ("SocketReactor " + String (index)),
+          owner (r),
+          poller (Poller::create())
+    {
+        if (poller != nullptr)
+            startThread();
+    }
+
+    ~EventLoop() override
+    {
+        stop();
+        stopThread (-1);
+
+        // (another loop's callbacks may have added a connection after this one finished)
+        abandonNewConnections();
+    }
+
+    Poller& getPoller() noexcept    { return *poller; }
+
+    void stop()
+    {
+        signalThreadShouldExit();
+
+        if (poller != nullptr)
+            poller->wake();
+    }
+
+    void addConnection (std::unique_ptr<Connection> connection)
+    {
+        connection->eventLoop = this;
+
+        {
+            const ScopedLock sl (lock);
+            newConnections.push_back (std::move (connection));
+        }
+
+        poller->wake();
+    }
+
+private:
+    static constexpr int readBufferSize = 65536;
+
+    SocketReactor& owner;
+    std::unique_ptr<Poller> poller;
+    std::array<Poller::Event, 256> events;
+    HeapBlock<char> readBuffer { (size_t) readBufferSize };
+
+    std::unordered_map<Connection*, std::unique_ptr<Connection>> connections;
+    std::vector<Connection*> closedConnections;
+
+    CriticalSection lock;
+    std::vector<std::unique_ptr<Connection>> newConnections;
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            startNewConnections();
+
+            const auto numEvents = poller->wait (events.data(), (int) events.size());
+
+            for (int i = 0; i < numEvents; ++i)
+            {
+                const auto& e = events[(size_t) i];
+
+                if (e.userData == &owner)
+                    owner.acceptConnections();
+                else
+                    handleEvent (*static_cast<Connection*> (e.userData), e);
+            }
+
+            deleteClosedConnections();
+        }
+
+        for (auto& c : connections)
+            closeConnection (*c.second);
+
+        deleteClosedConnections();
+        abandonNewConnections();
+    }
+
+    // Connections that were added but never started still have their connectionLost()
+    // method called before they're deleted
+    void abandonNewConnections()
+    {
+        std::vector<std::unique_ptr<Connection>> abandoned;
+
+        {
+            const ScopedLock sl (lock);
+            std::swap (abandoned, newConnections);
+        }
+
+        for (auto& c : abandoned)
+        {
+            c->closed = true;
+            c->connectionLost();
+            --owner.numConnections;
+        }
+    }
+
+    void startNewConnections()
+    {
+        std::vector<std::unique_ptr<Connection>> connectionsToStart;
+
+        {
+            const ScopedLock sl (lock);
+            std::swap (connectionsToStart, newConnections);
+        }
+
+        for (auto& c : connectionsToStart)
+        {
+            auto& connection = *c;
+            connections[&connection] = std::move (c);
+            connection.connected = true;
+
+            if (! poller->add (connection.socket->getRawSocketHandle(), &connection))
+            {
+                closeConnection (connection);
+                continue;
+            }
+
+            connection.connectionMade();
+        }
+    }
+
+    void handleEvent (Connection& connection, const Poller::Event& e)
+    {
+        if (connection.closed)
+            return;
+
+        if (e.writable)
+        {
+            const ScopedLock sl (connection.writeLock);
+
+            if (! connection.flushPendingOutput())
+            {
+                closeConnection (connection);
+                return;
+            }
+        }
+
+        if (e.readable)
+        {
+            const auto numRead = connection.socket->read (readBuffer, readBufferSize, false);
+
+            if (numRead > 0)
+                connection.dataReceived (readBuffer, (size_t) numRead);
+            else if (numRead < 0)
+                closeConnection (connection);
+        }
+    }
+
+    void closeConnection (Connection& connection)
+    {
+        if (connection.closed)
+            return;
+
+        {
+            // Once this is cleared, other threads won't try to use the socket
+            const ScopedLock sl (connection.writeLock);
+            connection.connected = false;
+        }
+
+        connection.closed = true;
+        poller->remove (connection.socket->getRawSocketHandle());
+        connection.connectionLost();
+        closedConnections.push_back (&connection);
+    }
+
+    // Closed connections are deleted after all the events have been handled, as
+    // there may be more events for them in the same batch
+    void deleteClosedConnections()
+    {
+        for (auto* c : closedConnections)
+        {
+            connections.erase (c);
+            --owner.numConnections;
+        }
+
+        closedConnections.clear();
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (EventLoop)
+};
+
+//==============================================================================
+SocketReactor::Connection::Connection() = default;
+SocketReactor::Connection::~Connection() = default;
+
+bool SocketReactor::Connection::send (const void* data, size_t numBytes)
+{
+    const ScopedLock sl (writeLock);
+
+    if (! connected)
+        return false;
+
+    // If nothing's queued, as much as possible is written straight away, to avoid copying it
+    if (pendingOutputStart == pendingOutput.getSize())
+    {
+        while (numBytes > 0)
+        {
+            const auto numWritten = socket->write (data, (int) jmin (numBytes, (size_t) std::numeric_limits<int>::max()));
+
+            if (numWritten < 0)
+                return false;
+
+            if (numWritten == 0)
+                break;
+
+            data = addBytesToPointer (data, numWritten);
+            numBytes -= (size_t) numWritten;
+        }
+
+        if (numBytes == 0)
+            return true;
+    }
+
+    pendingOutput.append (data, numBytes);
+    return flushPendingOutput();
+}
+
+bool SocketReactor::Connection::flushPendingOutput()
+{
+    while (pendingOutputStart < pendingOutput.getSize())
+    {
+        const auto numWritten = socket->write (addBytesToPointer (pendingOutput.getData(), pendingOutputStart),
+                                               (int) jmin (pendingOutput.getSize() - pendingOutputStart,
+                                                           (size_t) std::numeric_limits<int>::max()));
+
+        if (numWritten < 0)
+            return false;
+
+        if (numWritten == 0)
+            break;
+
+        pendingOutputStart += (size_t) numWritten;
+    }
+
+    // Moving the unwritten data to the start of the block after each partial write would make
+    // sending a large amount quadratic, so it's only done once most of the block has been written
+    if (pendingOutputStart == pendingOutput.getSize())
+    {
+        pendingOutput.reset();
+        pendingOutputStart = 0;
+    }
+    else if (pendingOutputStart > pendingOutput.getSize() / 2)
+    {
+        pendingOutput.removeSection (0, pendingOutputStart);
+        pendingOutputStart = 0;
+    }
+
+    // The reactor only waits for the socket to become writable while there's something to write
+    const auto shouldWait = pendingOutputStart < pendingOutput.getSize();
+
+    if (shouldWait != waitingToWrite)
+    {
+        waitingToWrite = shouldWait;
+        eventLoop->getPoller().setWantsToWrite (socket->getRawSocketHandle(), this, shouldWait);
+    }
+
+    return true;
+}
+
+size_t SocketReactor::Connection::getNumBytesWaitingToBeSent() const
+{
+    const ScopedLock sl (writeLock);
+    return pendingOutput.getSize() - pendingOutputStart;
+}
+
+void SocketReactor::Connection::disconnect()
+{
+    const ScopedLock sl (writeLock);
+
+    if (! connected)
+        return;
+
+    flushPendingOutput();
+
+    // This makes the socket readable, so the reactor will find that it's closed
+    const auto handle = (SocketHandle) socket->getRawSocketHandle();
+
+   #if JUCE_WINDOWS
+    ::shutdown (handle, SD_BOTH);
+   #else
+    ::shutdown (handle, SHUT_RDWR);
+   #endif
+}
+
+bool SocketReactor::Connection::isConnected() const noexcept
+{
+    return connected;
+}
+
+String SocketReactor::Connection::getHostName() const
+{
+    return socket != nullptr ? socket->getHostName() : String();
+}
+
+//==============================================================================
+SocketReactor::SocketReactor (int numThreads)
+{
+    SocketHelpers::initSockets();
+
+    for (int i = 0; i < jmax (1, numThreads); ++i)
+        eventLoops.add (new EventLoop (*this, i));
+}
+
+SocketReactor::~SocketReactor()
+{
+    stopListening();
+
+    // All the loops are stopped before any are deleted, as a connection's callbacks
+    // may still try to add new connections to the other loops
+    for (auto* loop : eventLoops)
+        loop->stop();
+
+    eventLoops.clear();
+}
+
+bool SocketReactor::beginListening (int portNumber, ConnectionFactory createConnection, const String& bindAddress)
+{
+    stopListening();
+
+    auto newListener = std::make_unique<StreamingSocket>();
+
+    if (! newListener->setNonBlockingMode (true) || ! newListener->createListener (portNumber, bindAddress))
+        return false;
+
+    const ScopedLock sl (listenerLock);
+
+    if (! eventLoops.getFirst()->getPoller().add (newListener->getRawSocketHandle(), this))
+        return false;
+
+    listener = std::move (newListener);
+    connectionFactory = std::move (createConnection);
+    return true;
+}
+
+void SocketReactor::stopListening()
+{
+    const ScopedLock sl (listenerLock);
+
+    // The socket must be removed from the poller before it's closed, as its handle
+    // may be reused straight away
+    if (listener != nullptr)
+        eventLoops.getFirst()->getPoller().remove (listener->getRawSocketHandle());
+
+    listener.reset();
+    connectionFactory = nullptr;
+}
+
+int SocketReactor::getBoundPort() const
+{
+    const ScopedLock sl (listenerLock);
+    return listener != nullptr ? listener->getBoundPort() : -1;
+}
+
+bool SocketReactor::addConnection (std::unique_ptr<StreamingSocket> connectedSocket, std::unique_ptr<Connection> connection)
+{
+    // A connection can only be added to one reactor!
+    jassert (connection == nullptr || connection->socket == nullptr);
+
+    if (connectedSocket == nullptr || connection == nullptr
+         || ! connectedSocket->isConnected() || ! connectedSocket->setNonBlockingMode (true))
+        return false;
+
+    connection->socket = std::move (connectedSocket);
+    assignConnection (std::move (connection));
+    return true;
+}
+
+int SocketReactor::getNumConnections() const noexcept
+{
+    return numConnections;
+}
+
+int SocketReactor::getNumThreads() const noexcept
+{
+    return eventLoops.size();
+}
+
+void SocketReactor::acceptConnections()
+{
+    const ScopedLock sl (listenerLock);
+
+    // (the factory function might call stopListening())
+    while (listener != nullptr)
+    {
+        std::unique_ptr<StreamingSocket> socket (listener->waitForNextConnection());
+
+        if (socket == nullptr)
+            break;
+
+        if (auto connection = connectionFactory())
+        {
+            connection->socket = std::move (socket);
+            assignConnection (std::move (connection));
+        }
+    }
+}
+
+void SocketReactor::assignConnection (std::unique_ptr<Connection> connection)
+{
+    ++numConnections;
+    eventLoops.getUnchecked ((int) (nextEventLoop++ % (uint32) eventLoops.size()))->addConnection (std::move (connection));
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct SocketReactorTests final : public UnitTest
+{
+    SocketReactorTests()
+        : UnitTest ("SocketReactor", UnitTestCategories::networking)
+    {
+    }
+
+    struct EchoConnection final : public SocketReactor::Connection
+    {
+        void dataReceived (const void* data, size_t numBytes) override
+        {
+            send (data, numBytes);
+        }
+    };
+
+    // (the counter is kept outside the connection, as the reactor deletes it after it's lost)
+    struct ClientConnection final : public SocketReactor::Connection
+    {
+        explicit ClientConnection (std::atomic<int>& n) : numLost (n) {}
+
+        void connectionMade() override
+        {
+            made.signal();
+        }
+
+        void dataReceived (const void* data, size_t numBytes) override
+        {
+            const ScopedLock sl (lock);
+            received.append (data, numBytes);
+        }
+
+        void connectionLost() override
+        {
+            ++numLost;
+        }
+
+        size_t getNumBytesReceived() const
+        {
+            const ScopedLock sl (lock);
+            return received.getSize();
+        }
+
+        std::atomic<int>& numLost;
+        CriticalSection lock;
+        MemoryBlock received;
+        WaitableEvent made;
+    };
+
+    static bool waitFor (std::function<bool()> condition)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            if (condition())
+                return true;
+
+            Thread::sleep (5);
+        }
+
+        return false;
+    }
+
+    ClientConnection* connectClient (SocketReactor& clients, int port, std::atomic<int>& numLost)
+    {
+        auto socket = std::make_unique<StreamingSocket>();
+        expect (socket->connect ("127.0.0.1", port));
+
+        auto connection = std::make_unique<ClientConnection> (numLost);
+        auto* c = connection.get();
+        expect (clients.addConnection (std::move (socket), std::move (connection)));
+        expect (c->made.wait (5000));
+        return c;
+    }
+
+    void runTest() override
+    {
+        beginTest ("Echo");
+        {
+            SocketReactor server (2), clients (2);
+            expect (server.beginListening (0, [] { return std::make_unique<EchoConnection>(); }, "127.0.0.1"));
+            const auto port = server.getBoundPort();
+            expect (port > 0);
+
+            std::atomic<int> numLost { 0 };
+            Array<ClientConnection*> connections;
+
+            for (int i = 0; i < 20; ++i)
+                connections.add (connectClient (clients, port, numLost));
+
+            expect (waitFor ([&] { return server.getNumConnections() == 20; }));
+
+            for (auto* c : connections)
+                expect (c->send ("0123456789", 10));
+
+            // This is large enough that the socket can't accept it all at once
+            MemoryBlock message (4 << 20);
+            getRandom().fillBitsRandomly (message.getData(), message.getSize());
+            expect (connections[0]->send (message.getData(), message.getSize()));
+
+            for (auto* c : connections)
+                expect (waitFor ([&] { return c->getNumBytesReceived() == (c == connections[0] ? message.getSize() + 10 : 10); }));
+
+            expect (memcmp (connections[1]->received.getData(), "0123456789", 10) == 0);
+            expect (memcmp (addBytesToPointer (connections[0]->received.getData(), 10), message.getData(), message.getSize()) == 0);
+            expect (connections[0]->getNumBytesWaitingToBeSent() == 0);
+
+            beginTest ("Disconnection");
+
+            connections[0]->disconnect();
+            expect (waitFor ([&] { return numLost == 1; }));
+            expect (waitFor ([&] { return server.getNumConnections() == 19 && clients.getNumConnections() == 19; }));
+
+            server.stopListening();
+            expect (server.getBoundPort() == -1);
+
+            StreamingSocket refused;
+            expect (! refused.connect ("127.0.0.1", port, 1000));
+        }
+
+        beginTest ("Deleting the reactor");
+        {
+            std::atomic<int> numServerConnectionsLost { 0 }, numClientConnectionsLost { 0 };
+
+            struct CountingConnection final : public SocketReactor::Connection
+            {
+                explicit CountingConnection (std::atomic<int>& n) : numLost (n) {}
+                void dataReceived (const void*, size_t) override {}
+                void connectionLost() override  { ++numLost; }
+                std::atomic<int>& numLost;
+            };
+
+            SocketReactor clients (1);
+
+            {
+                SocketReactor server (3);
+                expect (server.beginListening (0, [&] { return std::make_unique<CountingConnection> (numServerConnectionsLost); },
+                                               "127.0.0.1"));
+
+                for (int i = 0; i < 10; ++i)
+                    connectClient (clients, server.getBoundPort(), numClientConnectionsLost);
+
+                expect (waitFor ([&] { return server.getNumConnections() == 10; }));
+            }
+
+            expectEquals (numServerConnectionsLost.load(), 10);
+            expect (waitFor ([&] { return numClientConnectionsLost == 10 && clients.getNumConnections() == 0; }));
+
+            beginTest ("Deleting the reactor before its connections have started");
+
+            SocketReactor server (1);
+            expect (server.beginListening (0, [] { return std::make_unique<EchoConnection>(); }, "127.0.0.1"));
+            std::atomic<int> numLost { 0 };
+
+            {
+                SocketReactor reactor (4);
+
+                for (int i = 0; i < 10; ++i)
+                {
+                    auto socket = std::make_unique<StreamingSocket>();
+                    expect (socket->connect ("127.0.0.1", server.getBoundPort()));
+                    expect (reactor.addConnection (std::move (socket), std::make_unique<CountingConnection> (numLost)));
+                }
+            }
+
+            expectEquals (numLost.load(), 10);
+        }
+    }
+};
+
+static SocketReactorTests socketReactorTests;
+
+#endif
+#endif
+
+} // namespace juce
@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Services many TCP connections using a small, fixed number of threads.
+
+    Rather than needing a thread for each connection, as InterprocessConnectionServer
+    does, a SocketReactor keeps its sockets in non-blocking mode, and each of its
+    threads waits for any of its sockets to become ready, then reads or writes
+    whatever it can. On Linux and Android this uses epoll; on other platforms it
+    falls back to poll(), which is slower when there are many connections.
+
+    Each connection is represented by a Connection object, which you subclass to
+    receive its data. A connection is served by one of the reactor's threads for its
+    whole life, so the callbacks for a connection are never made concurrently, but
+    different connections may be called on different threads at the same time.
+
+    @code
+    struct EchoConnection  : public SocketReactor::Connection
+    {
+        void dataReceived (const void* data, size_t numBytes) override
+        {
+            send (data, numBytes);
+        }
+    };
+
+    SocketReactor reactor (2);
+    reactor.beginListening (8000, [] { return std::make_unique<EchoConnection>(); });
+    @endcode
+
+    @see StreamingSocket, InterprocessConnectionServer
+
+    @tags{Core}
+*/
+class JUCE_API  SocketReactor  final
+{
+    class EventLoop;
+
+public:
+    //==============================================================================
+    /** Creates a reactor, and starts the given number of threads to service its
+        connections.
+    */
+    explicit SocketReactor (int numThreads = 1);
+
+    /** Destructor.
+
+        This stops listening, and closes all the connections, calling their
+        Connection::connectionLost() methods.
+    */
+    ~SocketReactor();
+
+    //==============================================================================
+    /**
+        One of the connections that's being serviced by a SocketReactor.
+
+        Subclass this to receive data, and give it to the reactor with
+        SocketReactor::addConnection(), or return it from the factory function that's
+        passed to SocketReactor::beginListening(). The reactor owns its connections,
+        and deletes each one after calling its connectionLost() method.
+
+        The send() and disconnect() methods can be called from any thread, but as the
+        connection may be deleted at any time after connectionLost() is called, another
+        thread must only use a connection that it knows is still alive. The usual way to
+        do this is to keep a list of connections that's updated under a lock by
+        connectionMade() and connectionLost().
+
+        @tags{Core}
+    */
+    class JUCE_API  Connection
+    {
+    public:
+        /** Creates a connection object, which isn't attached to a socket until it's given
+            to a SocketReactor.
+        */
+        Connection();
+
+        /** Destructor. */
+        virtual ~Connection();
+
+        //==============================================================================
+        /** Sends some data to the other end.
+
+            This never blocks: whatever the socket can't accept straight away is kept,
+            and written by the reactor as soon as there's room. Data is always sent in the
+            order in which it's passed to this method.
+
+            @returns  false if the connection has been closed
+            @see getNumBytesWaitingToBeSent
+        */
+        bool send (const void* data, size_t numBytes);
+
+        /** Returns the number of bytes that have been passed to send(), but not yet
+            written to the socket.
+
+            As send() never blocks, a peer that isn't reading can make this grow without
+            limit, so you may want to stop sending, or disconnect, if it gets too large.
+        */
+        size_t getNumBytesWaitingToBeSent() const;
+
+        /** Closes the connection.
+
+            Whatever data is waiting to be sent is written, as far as this can be done
+            without blocking, and then the socket is shut down. The reactor will then call
+            connectionLost() and delete this object.
+        */
+        void disconnect();
+
+        /** True if the connection is open. */
+        bool isConnected() const noexcept;
+
+        /** Returns the name of the host at the other end, or an empty string if the
+            connection hasn't been added to a reactor.
+        */
+        String getHostName() const;
+
+        //==============================================================================
+        /** Called on the reactor's thread when the connection has been added to it,
+            before any data is received.
+        */
+        virtual void connectionMade() {}
+
+        /** Called on the reactor's thread when some data arrives.
+
+            There's no framing: the data is delivered in whatever chunks the socket
+            returns it in.
+        */
+        virtual void dataReceived (const void* data, size_t numBytes) = 0;
+
+        /** Called on the reactor's thread when the connection has been closed, either by
+            the other end, by disconnect(), or because the reactor is being deleted.
+
+            The connection is deleted as soon as this returns.
+        */
+        virtual void connectionLost() {}
+
+    private:
+        //==============================================================================
+        friend class SocketReactor;
+
+        std::unique_ptr<StreamingSocket> socket;
+        EventLoop* eventLoop = nullptr;
+        CriticalSection writeLock;
+        MemoryBlock pendingOutput;
+        size_t pendingOutputStart = 0;   // the bytes before this have already been written
+        bool waitingToWrite = false, closed = false;
+        std::atomic<bool> connected { false };
+
+        bool flushPendingOutput();
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Connection)
+    };
+
+    //==============================================================================
+    /** A function that creates a Connection object for a new incoming connection. */
+    using ConnectionFactory = std::function<std::unique_ptr<Connection>()>;
+
+    /** Starts listening on the given port, and calls the factory function to create
+        a Connection for each client that connects.
+
+        The factory function is called on one of the reactor's threads. If it returns
+        nullptr, the client is disconnected.
+
+        @param portNumber       the port to listen on, or 0 to let the OS choose one
+        @param createConnection the function to call for each new connection
+        @param bindAddress      the address of the interface to listen on, or an empty
+                                string to listen on all of them
+
+        @returns  true if the port was opened
+        @see stopListening, getBoundPort
+    */
+    bool beginListening (int portNumber, ConnectionFactory createConnection, const String& bindAddress = {});
+
+    /** Stops listening for new connections. Existing connections are left open. */
+    void stopListening();
+
+    /** Returns the port that the reactor is listening on, or -1 if it isn't listening. */
+    int getBoundPort() const;
+
+    /** Adds a connected socket to the reactor.
+
+        This is useful for outgoing connections, made with StreamingSocket::connect().
+        The socket is put into non-blocking mode, and the connection is assigned to one
+        of the reactor's threads, which calls its connectionMade() method.
+
+        @returns  false if the socket isn't connected, in which case the connection is
+                  deleted without any of its callbacks being made
+    */
+    bool addConnection (std::unique_ptr<StreamingSocket> connectedSocket, std::unique_ptr<Connection> connection);
+
+    /** Returns the number of connections that are currently open. */
+    int getNumConnections() const noexcept;
+
+    /** Returns the number of threads that are servicing the connections. */
+    int getNumThreads() const noexcept;
+
+private:
+    //==============================================================================
+    class Poller;
+
+    OwnedArray<EventLoop> eventLoops;
+    std::atomic<uint32> nextEventLoop { 0 };
+    std::atomic<int> numConnections { 0 };
+
+    CriticalSection listenerLock;
+    std::unique_ptr<StreamingSocket> listener;
+    ConnectionFactory connectionFactory;
+
+    void acceptConnections();
+    void assignConnection (std::unique_ptr<Connection>);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SocketReactor)
+};
+
+} // namespace juce
@@ -0,0 +1,426 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+// Fills a ring of chunks on the background thread. The chunks in
+// [firstChunk, firstChunk + numReadyChunks) hold consecutive data starting at or
+// before the stream's position, and the one after them is the only one that the
+// background thread ever writes to.
+class ReadAheadInputStream::Reader final : private TimeSliceClient
+{
+public:
+    Reader (InputStream* sourceStream, bool deleteSource, TimeSliceThread* threadToUse, int chunkSizeToUse, int numChunksToUse)
+        : source (sourceStream, deleteSource),
+          totalLength (source->getTotalLength()),
+          chunkSize (jmax (1, chunkSizeToUse)),
+          chunks ((size_t) jmax (1, numChunksToUse))
+    {
+        sourcePosition = nextReadPosition = source->getPosition();
+
+        for (auto& chunk : chunks)
+            chunk.data.malloc (chunkSize);
+
+        if (auto* fileStream = dynamic_cast<FileInputStream*> (source.get()))
+            fileStream->hintSequentialAccess();
+
+        if (threadToUse == nullptr)
+        {
+            ownedThread = std::make_unique<TimeSliceThread> ("ReadAheadInputStream");
+            ownedThread->startThread();
+            threadToUse = ownedThread.get();
+        }
+
+        thread = threadToUse;
+        thread->addTimeSliceClient (this);
+    }
+
+    ~Reader() override
+    {
+        thread->removeTimeSliceClient (this);
+    }
+
+    int64 getStartPosition() const noexcept     { return sourcePosition; }
+    int64 getTotalLength() const noexcept       { return totalLength; }
+
+    int read (int64 position, char* dest, int numBytes)
+    {
+        const ScopedLock sl (lock);
+        int numRead = 0;
+        double waitStartTime = 0;
+
+        while (numRead < numBytes)
+        {
+            if (numReadyChunks > 0)
+            {
+                auto& chunk = chunks[(size_t) firstChunk];
+                const auto offset = (int) (position + numRead - chunk.position);
+                jassert (isPositiveAndBelow (offset, chunk.size));
+
+                const auto num = jmin (numBytes - numRead, chunk.size - offset);
+                memcpy (dest + numRead, chunk.data + offset, (size_t) num);
+                numRead += num;
+
+                if (offset + num == chunk.size)
+                    releaseFirstChunk();
+            }
+            else if (reachedEnd)
+            {
+                break;
+            }
+            else
+            {
+                if (waitStartTime == 0)
+                {
+                    waitStartTime = Time::getMillisecondCounterHiRes();
+                    ++statistics.numWaits;
+                }
+
+                const ScopedUnlock su (lock);
+
+                // (the thread is nudged again in case it went to sleep just as a chunk was released)
+                thread->moveToFrontOfQueue (this);
+                dataArrived.wait (20);
+            }
+        }
+
+        if (waitStartTime != 0)
+            statistics.totalWaitTimeMs += Time::getMillisecondCounterHiRes() - waitStartTime;
+
+        return numRead;
+    }
+
+    void seek (int64 newPosition)
+    {
+        const ScopedLock sl (lock);
+
+        const auto readyStart = numReadyChunks > 0 ? chunks[(size_t) firstChunk].position : nextReadPosition;
+
+        if (newPosition >= readyStart && newPosition <= nextReadPosition)
+        {
+            // The new position is in (or just after) the data that's been read, so the
+            // read-ahead can carry on from where it is
+            while (numReadyChunks > 0 && chunks[(size_t) firstChunk].position + chunks[(size_t) firstChunk].size <= newPosition)
+            {
+                releaseFirstChunk();
+                ++statistics.numChunksDiscarded;
+            }
+
+            return;
+        }
+
+        statistics.numChunksDiscarded += numReadyChunks;
+        numReadyChunks = 0;
+        nextReadPosition = newPosition;
+        reachedEnd = false;
+        ++generation;
+        thread->moveToFrontOfQueue (this);
+    }
+
+    bool isExhausted (int64 position) const
+    {
+        if (totalLength >= 0)
+            return position >= totalLength;
+
+        const ScopedLock sl (lock);
+        return reachedEnd && numReadyChunks == 0;
+    }
+
+    Statistics getStatistics() const
+    {
+        const ScopedLock sl (lock);
+        return statistics;
+    }
+
+private:
+    struct Chunk
+    {
+        HeapBlock<char> data;
+        int64 position = 0;
+        int size = 0;
+    };
+
+    OptionalScopedPointer<InputStream> source;
+    const int64 totalLength;
+    const int chunkSize;
+    int64 sourcePosition = 0;
+
+    CriticalSection lock;
+    WaitableEvent dataArrived;
+    std::vector<Chunk> chunks;
+    int firstChunk = 0, numReadyChunks = 0, generation = 0;
+    int64 nextReadPosition = 0;
+    bool reachedEnd = false;
+    Statistics statistics;
+
+    std::unique_ptr<TimeSliceThread> ownedThread;
+    TimeSliceThread* thread = nullptr;
+
+    bool isFull() const noexcept    { return reachedEnd || numReadyChunks == (int) chunks.size(); }
+
+    void releaseFirstChunk()
+    {
+        firstChunk = (firstChunk + 1) % (int) chunks.size();
+        --numReadyChunks;
+        thread->moveToFrontOfQueue (this);
+    }
+
+    int useTimeSlice() override
+    {
+        constexpr int idleTimeMs = 100;
+        int64 readPosition;
+        int readGeneration;
+        Chunk* chunk;
+
+        {
+            const ScopedLock sl (lock);
+
+            if (isFull())
+                return idleTimeMs;
+
+            chunk = &chunks[(size_t) ((firstChunk + numReadyChunks) % (int) chunks.size())];
+            readPosition = nextReadPosition;
+            readGeneration = generation;
+        }
+
+        int size = 0;
+        bool isEnd = readPosition != sourcePosition && ! source->setPosition (readPosition);
+
+        while (! isEnd && size < chunkSize)
+        {
+            const auto num = source->read (chunk->data + size, chunkSize - size);
+
+            if (num <= 0)
+                isEnd = true;
+            else
+                size += num;
+        }
+
+        sourcePosition = source->getPosition();
+
+        const ScopedLock sl (lock);
+
+        if (size > 0)
+        {
+            statistics.numBytesReadFromSource += size;
+            ++statistics.numChunksRead;
+        }
+
+        if (readGeneration != generation)
+        {
+            // A seek happened while this chunk was being read
+            if (size > 0)
+                ++statistics.numChunksDiscarded;
+
+            return 0;
+        }
+
+        if (size > 0)
+        {
+            chunk->position = readPosition;
+            chunk->size = size;
+            ++numReadyChunks;
+            nextReadPosition += size;
+        }
+
+        reachedEnd = isEnd;
+        dataArrived.signal();
+
+        return isFull() ? idleTimeMs : 0;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Reader)
+};
+
+//==============================================================================
+ReadAheadInputStream::ReadAheadInputStream (InputStream* sourceStream, bool deleteSourceWhenDestroyed,
+                                            TimeSliceThread* threadToUse, int chunkSize, int numChunks)
+    : reader (std::make_unique<Reader> (sourceStream, deleteSourceWhenDestroyed, threadToUse, chunkSize, numChunks)),
+      position (reader->getStartPosition())
+{
+}
+
+ReadAheadInputStream::ReadAheadInputStream (InputStream& sourceStream, TimeSliceThread* threadToUse,
+                                            int chunkSize, int numChunks)
+    : ReadAheadInputStream (&sourceStream, false, threadToUse, chunkSize, numChunks)
+{
+}
+
+ReadAheadInputStream::~ReadAheadInputStream() = default;
+
+ReadAheadInputStream::Statistics ReadAheadInputStream::getStatistics() const
+{
+    return reader->getStatistics();
+}
+
+int64 ReadAheadInputStream::getTotalLength()
+{
+    return reader->getTotalLength();
+}
+
+int64 ReadAheadInputStream::getPosition()
+{
+    return position;
+}
+
+bool ReadAheadInputStream::setPosition (int64 newPosition)
+{
+    position = jmax ((int64) 0, newPosition);
+    reader->seek (position);
+    return true;
+}
+
+int ReadAheadInputStream::read (void* destBuffer, int maxBytesToRead)
+{
+    // The buffer should never be null, and a negative size is probably a
+    // sign that something is broken!
+    jassert (destBuffer != nullptr && maxBytesToRead >= 0);
+
+    const auto numRead = reader->read (position, static_cast<char*> (destBuffer), maxBytesToRead);
+    position += numRead;
+    return numRead;
+}
+
+bool ReadAheadInputStream::isExhausted()
+{
+    return reader->isExhausted (position);
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct ReadAheadInputStreamTests final : public UnitTest
+{
+    ReadAheadInputStreamTests()
+        : UnitTest ("ReadAheadInputStream", UnitTestCategories::streams)
+    {}
+
+    static MemoryBlock createTestData (Random& r, int size)
+    {
+        MemoryBlock data ((size_t) size);
+        r.fillBitsRandomly (data.getData(), data.getSize());
+        return data;
+    }
+
+    void checkSequentialRead (InputStream& stream, const MemoryBlock& data, Random& r)
+    {
+        MemoryBlock result;
+        HeapBlock<char> buffer (5000);
+
+        while (! stream.isExhausted())
+        {
+            const auto num = stream.read (buffer, r.nextInt (5000));
+            result.append (buffer, (size_t) num);
+        }
+
+        expect (result == data);
+        expectEquals (stream.getPosition(), (int64) data.getSize());
+        expectEquals (stream.read (buffer, 10), 0);
+    }
+
+    void checkRandomAccess (InputStream& stream, const MemoryBlock& data, Random& r)
+    {
+        HeapBlock<char> buffer (5000);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            // (mostly short skips forwards and backwards, with a few longer jumps)
+            const auto pos = r.nextInt (4) == 0 ? r.nextInt ((int) data.getSize())
+                                                : jlimit (0, (int) data.getSize(), (int) stream.getPosition() + r.nextInt ({ -2000, 3000 }));
+            expect (stream.setPosition (pos));
+
+            const auto numWanted = r.nextInt (5000);
+            const auto num = stream.read (buffer, numWanted);
+            expectEquals (num, jmin (numWanted, (int) data.getSize() - pos));
+            expect (memcmp (buffer, data.begin() + pos, (size_t) num) == 0);
+            expectEquals (stream.getPosition(), (int64) (pos + num));
+        }
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+        const auto data = createTestData (r, 100000);
+
+        beginTest ("Sequential read");
+        {
+            ReadAheadInputStream stream (new MemoryInputStream (data, false), true, nullptr, 4096, 3);
+            expectEquals (stream.getTotalLength(), (int64) data.getSize());
+            checkSequentialRead (stream, data, r);
+
+            const auto stats = stream.getStatistics();
+            expectEquals (stats.numBytesReadFromSource, (int64) data.getSize());
+            expectEquals (stats.numChunksRead, (int) (data.getSize() + 4095) / 4096);
+            expectEquals (stats.numChunksDiscarded, 0);
+        }
+
+        beginTest ("Random access");
+        {
+            MemoryInputStream source (data, false);
+            ReadAheadInputStream stream (source, nullptr, 1000, 4);
+            checkRandomAccess (stream, data, r);
+
+            expect (stream.setPosition (0));
+            checkSequentialRead (stream, data, r);
+        }
+
+        beginTest ("File source with a shared thread");
+        {
+            TemporaryFile tempFile;
+            expect (tempFile.getFile().replaceWithData (data.getData(), data.getSize()));
+
+            TimeSliceThread thread ("ReadAhead test");
+            thread.startThread();
+
+            {
+                ReadAheadInputStream stream1 (tempFile.getFile().createInputStream().release(), true, &thread, 2048, 2);
+                ReadAheadInputStream stream2 (tempFile.getFile().createInputStream().release(), true, &thread, 3000, 5);
+
+                checkSequentialRead (stream1, data, r);
+                checkRandomAccess (stream2, data, r);
+            }
+
+            expectEquals (thread.getNumClients(), 0);
+        }
+    }
+};
+
+static ReadAheadInputStreamTests readAheadInputStreamTests;
+
+#endif
+
+} // namespace juce
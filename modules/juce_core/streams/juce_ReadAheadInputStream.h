@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class TimeSliceThread;
+
+//==============================================================================
+/**
+    Wraps another input stream, and reads ahead of the current position on a
+    background thread, so that the data is usually ready by the time it's needed.
+
+    This is useful when a large file is being processed from start to end (e.g. when
+    decoding or scanning audio), because the time spent waiting for the disk then
+    overlaps with the time spent processing the data, instead of being added to it.
+
+    The source is read in chunks of a fixed size, and up to a given number of chunks
+    are kept ready ahead of the read position. Reading or skipping forward within the
+    chunks that have been read doesn't touch the source, but seeking outside them
+    discards them and restarts the read-ahead from the new position.
+
+    Once it's been passed to this object, the source stream must only be used by the
+    background thread. If the source is a FileInputStream, the OS is also told that it
+    will be read sequentially.
+
+    @see BufferedInputStream, FileInputStream::hintSequentialAccess
+
+    @tags{Core}
+*/
+class JUCE_API  ReadAheadInputStream  : public InputStream
+{
+public:
+    //==============================================================================
+    /** Creates a ReadAheadInputStream from an input source.
+
+        @param sourceStream                 the source stream to read from
+        @param deleteSourceWhenDestroyed    whether the sourceStream that is passed in should be
+                                            deleted by this object when it is itself deleted.
+        @param threadToUse                  a thread to do the reading on. This must have been
+                                            started, and can be shared with other clients. If it's
+                                            nullptr, the stream creates a thread of its own.
+        @param chunkSize                    the number of bytes to read from the source at a time
+        @param numChunks                    the number of chunks to keep ready ahead of the
+                                            read position
+    */
+    ReadAheadInputStream (InputStream* sourceStream,
+                          bool deleteSourceWhenDestroyed,
+                          TimeSliceThread* threadToUse = nullptr,
+                          int chunkSize = 256 * 1024,
+                          int numChunks = 4);
+
+    /** Creates a ReadAheadInputStream from an input source.
+
+        @param sourceStream     the source stream to read from - the source stream must not
+                                be deleted until this object has been destroyed.
+        @param threadToUse      a thread to do the reading on, or nullptr to create one
+        @param chunkSize        the number of bytes to read from the source at a time
+        @param numChunks        the number of chunks to keep ready ahead of the read position
+    */
+    ReadAheadInputStream (InputStream& sourceStream,
+                          TimeSliceThread* threadToUse = nullptr,
+                          int chunkSize = 256 * 1024,
+                          int numChunks = 4);
+
+    /** Destructor.
+
+        This may also delete the source stream, if that option was chosen when the
+        stream was created.
+    */
+    ~ReadAheadInputStream() override;
+
+    //==============================================================================
+    /** Some counters describing how well the read-ahead has been keeping up. */
+    struct Statistics
+    {
+        int64 numBytesReadFromSource = 0;   /**< The total amount of data read from the source. */
+        int numChunksRead = 0;              /**< The number of chunks read from the source. */
+        int numChunksDiscarded = 0;         /**< The number of chunks that were read, but skipped by a seek. */
+        int numWaits = 0;                   /**< The number of reads that had to wait for data to arrive. */
+        double totalWaitTimeMs = 0;         /**< The total time spent waiting for data to arrive. */
+    };
+
+    /** Returns the statistics for this stream so far. */
+    Statistics getStatistics() const;
+
+    //==============================================================================
+    int64 getTotalLength() override;
+    int64 getPosition() override;
+    bool setPosition (int64 newPosition) override;
+    int read (void* destBuffer, int maxBytesToRead) override;
+    bool isExhausted() override;
+
+private:
+    //==============================================================================
+    class Reader;
+    std::unique_ptr<Reader> reader;
+    int64 position = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReadAheadInputStream)
+};
+
+} // namespace juce
@@ -122,6 +122,19 @@ public:
     /** Returns this identifier as a StringRef. */
     operator StringRef() const noexcept                                 { return name; }
 
+    /** Returns a hash code for this identifier. This is a very fast operation.
+
+        Because identifiers are pooled, the hash is derived from the address of the shared
+        string rather than its characters. It's the same for all identifiers with the same
+        name while any of them exist, but it's not the same as the String's hash, and it'll
+        vary between runs of the program.
+    */
+    size_t hash() const noexcept
+    {
+        auto address = (uint64) (pointer_sized_uint) name.getCharPointer().getAddress();
+        return (size_t) ((address ^ (address >> 29)) * 0x9e3779b97f4a7c15ull);
+    }
+
     /** Returns true if this Identifier is not null */
     bool isValid() const noexcept                                       { return name.isNotEmpty(); }
 
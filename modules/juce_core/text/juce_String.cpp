@@ -790,7 +790,16 @@ String& String::operator+= (const String& other)
 
 String& String::operator+= (StringRef other)
 {
-    return operator+= (String (other));
+    auto* bufferStart = text.getAddress();
+    auto* bufferEnd = addBytesToPointer (bufferStart, (int) StringHolderUtils::getAllocatedNumBytes (text));
+
+    // If the other text lives inside this string's buffer, appending might reallocate it
+    // from under our feet, so it needs to be copied first
+    if (other.text.getAddress() >= bufferStart && other.text.getAddress() < bufferEnd)
+        return operator+= (String (other));
+
+    appendCharPointer (other.text);
+    return *this;
 }
 
 String& String::operator+= (char ch)
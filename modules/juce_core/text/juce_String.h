@@ -1372,6 +1372,8 @@ private:
     //==============================================================================
     CharPointerType text;
 
+    friend class StringBuilder;
+
     //==============================================================================
     struct PreallocationBytes
     {
@@ -0,0 +1,246 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+StringBuilder& StringBuilder::append (const String& text)
+{
+    if (text.isNotEmpty())
+    {
+        auto& piece = addPiece();
+        piece.retainedText = text;
+        piece.start = text.getCharPointer().getAddress();
+        piece.numBytes = text.getByteOffsetOfEnd();
+        totalNumBytes += piece.numBytes;
+    }
+
+    return *this;
+}
+
+StringBuilder& StringBuilder::append (StringRef text)
+{
+   #if JUCE_STRING_UTF_TYPE != 8
+    // In this mode, a StringRef holds a temporary copy of a literal, so it has to be retained
+    return append (text.stringCopy.isNotEmpty() ? text.stringCopy : String (text.text));
+   #else
+    addText (text.text.getAddress(), text.text.sizeInBytes() - sizeof (CharType));
+    return *this;
+   #endif
+}
+
+StringBuilder& StringBuilder::append (juce_wchar character)
+{
+    using CharPointerType = String::CharPointerType;
+    auto numBytes = CharPointerType::getBytesRequiredFor (character);
+
+    if (character == 0)
+        return *this;
+
+    if (numFormattedChars * sizeof (CharType) + numBytes > sizeof (formattedText))
+        return append (String::charToString (character));
+
+    auto* start = formattedText + numFormattedChars;
+    CharPointerType dest (start);
+    dest.write (character);
+    numFormattedChars += numBytes / sizeof (CharType);
+
+    addText (start, numBytes);
+    return *this;
+}
+
+template <typename IntegerType>
+StringBuilder& StringBuilder::appendInteger (IntegerType number)
+{
+    char buffer[NumberToStringConverters::charsNeededForInt];
+    auto* end = buffer + numElementsInArray (buffer);
+    auto* start = NumberToStringConverters::numberToString (end, number);
+
+    // (the converter writes a null terminator at end - 1)
+    addFormattedText (start, end - 1);
+    return *this;
+}
+
+StringBuilder& StringBuilder::append (int number)               { return appendInteger (number); }
+StringBuilder& StringBuilder::append (unsigned int number)      { return appendInteger (number); }
+StringBuilder& StringBuilder::append (long number)              { return appendInteger (number); }
+StringBuilder& StringBuilder::append (unsigned long number)     { return appendInteger (number); }
+StringBuilder& StringBuilder::append (int64 number)             { return appendInteger (number); }
+StringBuilder& StringBuilder::append (uint64 number)            { return appendInteger (number); }
+
+void StringBuilder::clear()
+{
+    for (int i = 0; i < jmin (numPieces, (int) numInlinePieces); ++i)
+        inlinePieces[i] = {};
+
+    extraPieces.clearQuick();
+    numPieces = 0;
+    totalNumBytes = 0;
+    numFormattedChars = 0;
+}
+
+String StringBuilder::toString() const
+{
+    if (totalNumBytes == 0)
+        return {};
+
+    // A single String can just be shared rather than copied
+    if (numPieces == 1 && inlinePieces[0].retainedText.isNotEmpty())
+        return inlinePieces[0].retainedText;
+
+    String result (String::PreallocationBytes { totalNumBytes });
+    auto* dest = reinterpret_cast<char*> (result.text.getAddress());
+
+    for (int i = 0; i < numPieces; ++i)
+    {
+        auto& piece = i < numInlinePieces ? inlinePieces[i]
+                                          : extraPieces.getReference (i - numInlinePieces);
+
+        memcpy (dest, piece.start, piece.numBytes);
+        dest += piece.numBytes;
+    }
+
+    String::CharPointerType (unalignedPointerCast<CharType*> (dest)).writeNull();
+    return result;
+}
+
+StringBuilder::Piece& StringBuilder::addPiece()
+{
+    if (numPieces < numInlinePieces)
+        return inlinePieces[numPieces++];
+
+    ++numPieces;
+    extraPieces.add ({});
+    return extraPieces.getReference (extraPieces.size() - 1);
+}
+
+void StringBuilder::addText (const CharType* start, size_t numBytes)
+{
+    if (numBytes == 0)
+        return;
+
+    auto& piece = addPiece();
+    piece.start = start;
+    piece.numBytes = numBytes;
+    totalNumBytes += numBytes;
+}
+
+void StringBuilder::addFormattedText (const char* asciiStart, const char* asciiEnd)
+{
+    auto numChars = (size_t) (asciiEnd - asciiStart);
+
+    if (numFormattedChars + numChars > (size_t) numInlineChars)
+    {
+        append (String (asciiStart, numChars));
+        return;
+    }
+
+    auto* start = formattedText + numFormattedChars;
+
+    // ASCII characters have the same code units in every UTF encoding
+    for (size_t i = 0; i < numChars; ++i)
+        start[i] = (CharType) asciiStart[i];
+
+    numFormattedChars += numChars;
+    addText (start, numChars * sizeof (CharType));
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringBuilderTests final : public UnitTest
+{
+public:
+    StringBuilderTests()
+        : UnitTest ("StringBuilder", UnitTestCategories::text)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Pieces are concatenated in order");
+        {
+            const String paramName ("Gain");
+            auto text = (StringBuilder() << paramName << ": " << -12 << " dB, " << 'x' << (juce_wchar) 0x20ac
+                                         << (int64) -9000000000LL << (uint64) 18446744073709551615ULL << 3.5).toString();
+
+            expectEquals (text, paramName + ": " + String (-12) + " dB, x" + String::charToString (0x20ac)
+                                  + String ((int64) -9000000000LL) + String ((uint64) 18446744073709551615ULL) + String (3.5));
+        }
+
+        beginTest ("Empty builders produce empty strings");
+        {
+            StringBuilder builder;
+            expect (builder.isEmpty());
+            expect (builder.toString().isEmpty());
+
+            builder << "" << String() << StringRef();
+            expect (builder.isEmpty());
+        }
+
+        beginTest ("A single String is shared");
+        {
+            const String original ("shared text");
+            StringBuilder builder;
+            builder << original;
+            expect (builder.toString().getCharPointer() == original.getCharPointer());
+        }
+
+        beginTest ("Many pieces overflow the inline storage");
+        {
+            StringBuilder builder;
+            String expected;
+
+            for (int i = 0; i < 200; ++i)
+            {
+                builder << i << ",";
+                expected << i << ",";
+            }
+
+            expectEquals ((int) builder.getNumBytes(), (int) expected.getNumBytesAsUTF8());
+            expectEquals (builder.toString(), expected);
+
+            builder.clear();
+            expect (builder.isEmpty());
+            builder << "again";
+            expectEquals (builder.toString(), String ("again"));
+        }
+    }
+};
+
+static StringBuilderTests stringBuilderTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Assembles a String from a sequence of pieces, using a single allocation.
+
+    Building a string with operator+ or += can allocate and copy the text once for
+    every piece that's added. A StringBuilder instead collects the pieces, and when you
+    call toString() it adds up their lengths and writes them all into one new String.
+
+    For a handful of pieces the builder keeps everything in its own fixed storage, so
+    apart from the final String it doesn't allocate either.
+
+    @code
+    auto label = (StringBuilder() << name << ": " << value << " dB").toString();
+    @endcode
+
+    Text that's added as a StringRef or a string literal isn't copied, so it must still
+    be valid when toString() is called. Strings are retained by reference-count, and
+    numbers and characters are formatted straight away, so they don't have this issue.
+
+    @see String
+
+    @tags{Core}
+*/
+class JUCE_API StringBuilder final
+{
+public:
+    //==============================================================================
+    /** Creates an empty builder. */
+    StringBuilder() noexcept = default;
+
+    /** Destructor. */
+    ~StringBuilder() = default;
+
+    //==============================================================================
+    /** Appends a String. */
+    StringBuilder& append (const String& text);
+
+    /** Appends some text without copying it.
+        The text must remain valid until toString() has been called.
+    */
+    StringBuilder& append (StringRef text);
+
+    /** Appends a string literal without copying it. */
+    StringBuilder& append (const char* text)                { return append (StringRef (text)); }
+
+    /** Appends a character. */
+    StringBuilder& append (juce_wchar character);
+
+    /** Appends a character. */
+    StringBuilder& append (char character)                  { return append ((juce_wchar) (uint8) character); }
+
+    /** Appends the decimal representation of an integer. */
+    StringBuilder& append (int number);
+    /** Appends the decimal representation of an integer. */
+    StringBuilder& append (unsigned int number);
+    /** Appends the decimal representation of an integer. */
+    StringBuilder& append (long number);
+    /** Appends the decimal representation of an integer. */
+    StringBuilder& append (unsigned long number);
+    /** Appends the decimal representation of an integer. */
+    StringBuilder& append (int64 number);
+    /** Appends the decimal representation of an integer. */
+    StringBuilder& append (uint64 number);
+
+    /** Appends a floating-point number, formatted in the same way as String (double). */
+    StringBuilder& append (double number)                   { return append (String (number)); }
+
+    /** Appends a floating-point number, formatted in the same way as String (float). */
+    StringBuilder& append (float number)                    { return append (String (number)); }
+
+    /** Appends anything that can be passed to one of the append() methods. */
+    template <typename Type>
+    StringBuilder& operator<< (const Type& value)           { return append (value); }
+
+    //==============================================================================
+    /** Returns the number of bytes that the text will occupy, excluding the terminator. */
+    size_t getNumBytes() const noexcept                     { return totalNumBytes; }
+
+    /** Returns true if nothing has been appended. */
+    bool isEmpty() const noexcept                           { return totalNumBytes == 0; }
+
+    /** Removes all the pieces that have been appended. */
+    void clear();
+
+    /** Creates a String containing all the pieces that have been appended. */
+    String toString() const;
+
+private:
+    //==============================================================================
+    using CharType = String::CharPointerType::CharType;
+
+    struct Piece
+    {
+        String retainedText;
+        const CharType* start = nullptr;
+        size_t numBytes = 0;
+    };
+
+    enum
+    {
+        numInlinePieces = 16,
+        numInlineChars  = 128
+    };
+
+    Piece inlinePieces[numInlinePieces];
+    Array<Piece> extraPieces;
+    int numPieces = 0;
+    size_t totalNumBytes = 0;
+
+    CharType formattedText[numInlineChars];
+    size_t numFormattedChars = 0;
+
+    Piece& addPiece();
+    void addText (const CharType*, size_t numBytes);
+    void addFormattedText (const char* asciiStart, const char* asciiEnd);
+    template <typename IntegerType> StringBuilder& appendInteger (IntegerType);
+
+    JUCE_DECLARE_NON_COPYABLE (StringBuilder)
+};
+
+} // namespace juce
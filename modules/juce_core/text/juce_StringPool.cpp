@@ -38,75 +38,110 @@ namespace juce
 static const int minNumberOfStringsForGarbageCollection = 300;
 static const uint32 garbageCollectionInterval = 30000;
 
-
-StringPool::StringPool() noexcept  : lastGarbageCollectionTime (0) {}
-
-struct StartEndString
+//==============================================================================
+/*  Each pooled string is stored with its hash, so that the tables never need to
+    re-hash the text when they grow, and a lookup only compares characters when the
+    full 64-bit hashes already match.
+*/
+struct StringPool::PooledString
 {
-    StartEndString (String::CharPointerType s, String::CharPointerType e) noexcept : start (s), end (e) {}
-    operator String() const   { return String (start, end); }
+    String text;
+    uint64 hash;
 
-    String::CharPointerType start, end;
+    bool operator== (const PooledString& other) const noexcept
+    {
+        return text.getCharPointer() == other.text.getCharPointer();
+    }
 };
 
-static int compareStrings (const String& s1, const String& s2) noexcept     { return s1.compare (s2); }
-static int compareStrings (CharPointer_UTF8 s1, const String& s2) noexcept  { return s1.compare (s2.getCharPointer()); }
-
-static int compareStrings (const StartEndString& string1, const String& string2) noexcept
+template <typename CharPointer>
+struct PooledStringKey
 {
-    String::CharPointerType s1 (string1.start), s2 (string2.getCharPointer());
+    PooledStringKey (CharPointer s, CharPointer e) noexcept  : start (s), end (s)
+    {
+        // Every overload of getPooledString() hashes its text here, so the same characters
+        // always give the same hash, whatever form they were passed in
+        auto t = start;
 
-    for (;;)
+        while (t != e && ! t.isEmpty())
+            hash = 101 * hash + (uint64) t.getAndAdvance();
+
+        end = t;
+    }
+
+    bool operator== (const StringPool::PooledString& pooled) const noexcept
     {
-        const int c1 = s1 < string1.end ? (int) s1.getAndAdvance() : 0;
-        const int c2 = (int) s2.getAndAdvance();
-        const int diff = c1 - c2;
+        if (pooled.hash != hash)
+            return false;
 
-        if (diff != 0)  return diff < 0 ? -1 : 1;
-        if (c1 == 0)    break;
+        auto s = pooled.text.getCharPointer();
+
+        for (auto t = start; t != end;)
+            if (s.getAndAdvance() != t.getAndAdvance())
+                return false;
+
+        return s.isEmpty();
     }
 
-    return 0;
+    CharPointer start, end;
+    uint64 hash = 0;
+};
+
+template <typename CharPointer>
+static bool operator== (const StringPool::PooledString& pooled, const PooledStringKey<CharPointer>& key) noexcept
+{
+    return key == pooled;
 }
 
-template <typename NewStringType>
-static String addPooledString (Array<String>& strings, const NewStringType& newString)
+struct PooledStringHashFunctions
 {
-    int start = 0;
-    int end = strings.size();
+    static uint64 generateHash (const StringPool::PooledString& s) noexcept      { return s.hash; }
 
-    while (start < end)
-    {
-        const String& startString = strings.getReference (start);
-        const int startComp = compareStrings (newString, startString);
+    template <typename CharPointer>
+    static uint64 generateHash (const PooledStringKey<CharPointer>& k) noexcept  { return k.hash; }
+};
 
-        if (startComp == 0)
-            return startString;
+//==============================================================================
+struct StringPool::Shard
+{
+    CriticalSection lock;
+    FlatHashSet<PooledString, PooledStringHashFunctions> strings;
+    uint32 lastGarbageCollectionTime = 0;
 
-        const int halfway = (start + end) / 2;
+    void garbageCollect()
+    {
+        strings.removeIf ([] (const PooledString& s) { return s.text.getReferenceCount() == 1; });
+        lastGarbageCollectionTime = Time::getApproximateMillisecondCounter();
+    }
 
-        if (halfway == start)
-        {
-            if (startComp > 0)
-                ++start;
+    void garbageCollectIfNeeded()
+    {
+        if (strings.size() > minNumberOfStringsForGarbageCollection / (int) numShards
+             && Time::getApproximateMillisecondCounter() > lastGarbageCollectionTime + garbageCollectionInterval)
+            garbageCollect();
+    }
+};
 
-            break;
-        }
+StringPool::StringPool()  : shards (new Shard[numShards]) {}
+StringPool::~StringPool() = default;
 
-        const String& halfwayString = strings.getReference (halfway);
-        const int halfwayComp = compareStrings (newString, halfwayString);
+template <typename CharPointer>
+String StringPool::getPooledString (CharPointer start, CharPointer end, const String* original)
+{
+    const PooledStringKey<CharPointer> key (start, end);
 
-        if (halfwayComp == 0)
-            return halfwayString;
+    // The low bits pick the shard, as the tables use the high bits to pick their slots
+    auto& shard = shards[(size_t) ((key.hash ^ (key.hash >> 32)) % numShards)];
 
-        if (halfwayComp > 0)
-            start = halfway;
-        else
-            end = halfway;
-    }
+    const ScopedLock sl (shard.lock);
+    shard.garbageCollectIfNeeded();
+
+    if (auto* existing = shard.strings.find (key))
+        return existing->text;
 
-    strings.insert (start, newString);
-    return strings.getReference (start);
+    PooledString newString { original != nullptr ? *original : String (key.start, key.end), key.hash };
+    shard.strings.add (newString);
+    return newString.text;
 }
 
 String StringPool::getPooledString (const char* const newString)
@@ -114,9 +149,7 @@ String StringPool::getPooledString (const char* const newString)
     if (newString == nullptr || *newString == 0)
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, CharPointer_UTF8 (newString));
+    return getPooledString (CharPointer_UTF8 (newString), CharPointer_UTF8 (nullptr), nullptr);
 }
 
 String StringPool::getPooledString (String::CharPointerType start, String::CharPointerType end)
@@ -124,9 +157,7 @@ String StringPool::getPooledString (String::CharPointerType start, String::CharP
     if (start.isEmpty() || start == end)
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, StartEndString (start, end));
+    return getPooledString (start, end, nullptr);
 }
 
 String StringPool::getPooledString (StringRef newString)
@@ -134,9 +165,7 @@ String StringPool::getPooledString (StringRef newString)
     if (newString.isEmpty())
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, newString.text);
+    return getPooledString (newString.text, String::CharPointerType (nullptr), nullptr);
 }
 
 String StringPool::getPooledString (const String& newString)
@@ -144,27 +173,29 @@ String StringPool::getPooledString (const String& newString)
     if (newString.isEmpty())
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, newString);
+    return getPooledString (newString.getCharPointer(), String::CharPointerType (nullptr), &newString);
 }
 
-void StringPool::garbageCollectIfNeeded()
+void StringPool::garbageCollect()
 {
-    if (strings.size() > minNumberOfStringsForGarbageCollection
-         && Time::getApproximateMillisecondCounter() > lastGarbageCollectionTime + garbageCollectionInterval)
-        garbageCollect();
+    for (size_t i = 0; i < numShards; ++i)
+    {
+        const ScopedLock sl (shards[i].lock);
+        shards[i].garbageCollect();
+    }
 }
 
-void StringPool::garbageCollect()
+int StringPool::size() const
 {
-    const ScopedLock sl (lock);
+    int total = 0;
 
-    for (int i = strings.size(); --i >= 0;)
-        if (strings.getReference (i).getReferenceCount() == 1)
-            strings.remove (i);
+    for (size_t i = 0; i < numShards; ++i)
+    {
+        const ScopedLock sl (shards[i].lock);
+        total += shards[i].strings.size();
+    }
 
-    lastGarbageCollectionTime = Time::getApproximateMillisecondCounter();
+    return total;
 }
 
 StringPool& StringPool::getGlobalPool() noexcept
@@ -173,4 +204,85 @@ StringPool& StringPool::getGlobalPool() noexcept
     return pool;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringPoolTests final : public UnitTest
+{
+public:
+    StringPoolTests()
+        : UnitTest ("StringPool", UnitTestCategories::text)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("All the ways of requesting a string return the same pooled copy");
+        {
+            StringPool pool;
+            auto pooled = pool.getPooledString ("pooled-string");
+            const String text ("pooled-string-with-suffix");
+            auto start = text.getCharPointer();
+
+            expect (pool.getPooledString (String ("pooled-string")).getCharPointer() == pooled.getCharPointer());
+            expect (pool.getPooledString (StringRef ("pooled-string")).getCharPointer() == pooled.getCharPointer());
+            expect (pool.getPooledString (start, start + 13).getCharPointer() == pooled.getCharPointer());
+            expect (pool.getPooledString (start, start + 14).getCharPointer() != pooled.getCharPointer());
+            expectEquals (pool.getPooledString (start, start + 14), String ("pooled-string-"));
+            expect (pool.getPooledString (String()).isEmpty());
+        }
+
+        beginTest ("Unreferenced strings are garbage-collected");
+        {
+            StringPool pool;
+            pool.getPooledString (String ("transient") + "-text");
+            auto kept = pool.getPooledString ("kept");
+            expectEquals (pool.size(), 2);
+
+            pool.garbageCollect();
+            expectEquals (pool.size(), 1);
+            expect (pool.getPooledString ("kept").getCharPointer() == kept.getCharPointer());
+            expectEquals (pool.size(), 1);
+
+            kept = {};
+            pool.garbageCollect();
+            expectEquals (pool.size(), 0);
+        }
+
+        beginTest ("Concurrent requests agree on the pooled copies");
+        {
+            StringPool pool;
+            constexpr int numThreads = 4, numStrings = 2000;
+            std::vector<std::vector<String>> results (numThreads);
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < numThreads; ++t)
+            {
+                threads.emplace_back ([&pool, &results, t]
+                {
+                    for (int i = 0; i < numStrings; ++i)
+                        results[(size_t) t].push_back (pool.getPooledString ("string" + String ((i * (t + 1)) % numStrings)));
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            for (int i = 0; i < numStrings; ++i)
+            {
+                auto expected = pool.getPooledString ("string" + String (i)).getCharPointer();
+
+                for (int t = 0; t < numThreads; ++t)
+                    for (int j = 0; j < numStrings; ++j)
+                        if ((j * (t + 1)) % numStrings == i)
+                            expect (results[(size_t) t][(size_t) j].getCharPointer() == expected);
+            }
+        }
+    }
+};
+
+static StringPoolTests stringPoolTests;
+
+#endif
+
 } // namespace juce
@@ -46,6 +46,9 @@ namespace juce
     compare two pooled strings for equality, as you can simply compare their pointers. It
     also cuts down on storage if you're using many copies of the same string.
 
+    The pool is a set of hash tables, so looking up a string takes roughly constant time
+    however many strings it contains, and it's safe to use from multiple threads.
+
     @tags{Core}
 */
 class JUCE_API  StringPool
@@ -53,7 +56,10 @@ class JUCE_API  StringPool
 public:
     //==============================================================================
     /** Creates an empty pool. */
-    StringPool() noexcept;
+    StringPool();
+
+    /** Destructor. */
+    ~StringPool();
 
     //==============================================================================
     /** Returns a pointer to a shared copy of the string that is passed in.
@@ -83,15 +89,24 @@ public:
     */
     void garbageCollect();
 
+    /** Returns the number of strings that the pool currently holds. */
+    int size() const;
+
     /** Returns a shared global pool which is used for things like Identifiers, XML parsing. */
     static StringPool& getGlobalPool() noexcept;
 
-private:
-    Array<String> strings;
-    CriticalSection lock;
-    uint32 lastGarbageCollectionTime;
+    /** @internal */
+    struct PooledString;
 
-    void garbageCollectIfNeeded();
+private:
+    // The strings are split between several independently-locked hash tables, so that
+    // threads creating Identifiers at the same time rarely contend for the same lock
+    struct Shard;
+    static constexpr size_t numShards = 32;
+    std::unique_ptr<Shard[]> shards;
+
+    template <typename CharPointer>
+    String getPooledString (CharPointer, CharPointer, const String*);
 
     JUCE_DECLARE_NON_COPYABLE (StringPool)
 };
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct CRC32Tables
+{
+    constexpr CRC32Tables()
+    {
+        for (uint32 i = 0; i < 256; ++i)
+        {
+            auto crc = i;
+
+            for (int j = 0; j < 8; ++j)
+                crc = (crc & 1) != 0 ? (0xedb88320 ^ (crc >> 1)) : (crc >> 1);
+
+            tables[0][i] = crc;
+        }
+
+        // Each table continues the one before it by another byte of zeros
+        for (int t = 1; t < 8; ++t)
+            for (int i = 0; i < 256; ++i)
+                tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xff];
+    }
+
+    uint32 tables[8][256] {};
+};
+
+static constexpr CRC32Tables crc32Tables;
+
+//==============================================================================
+CRC32::CRC32 (const void* data, size_t numBytes) noexcept
+{
+    update (data, numBytes);
+}
+
+void CRC32::update (const void* data, size_t numBytes) noexcept
+{
+    auto& t = crc32Tables.tables;
+    auto* bytes = static_cast<const uint8*> (data);
+    auto crc = ~checksum;
+
+    for (; numBytes >= 8; numBytes -= 8)
+    {
+        auto low  = ByteOrder::littleEndianInt (bytes) ^ crc;
+        auto high = ByteOrder::littleEndianInt (bytes + 4);
+        bytes += 8;
+
+        crc = t[7][low & 0xff]  ^ t[6][(low >> 8) & 0xff]  ^ t[5][(low >> 16) & 0xff]  ^ t[4][low >> 24]
+            ^ t[3][high & 0xff] ^ t[2][(high >> 8) & 0xff] ^ t[1][(high >> 16) & 0xff] ^ t[0][high >> 24];
+    }
+
+    for (; numBytes > 0; --numBytes)
+        crc = (crc >> 8) ^ t[0][(crc ^ *bytes++) & 0xff];
+
+    checksum = ~crc;
+}
+
+uint32 CRC32::combine (uint32 firstChecksum, uint32 secondChecksum, int64 secondLength) noexcept
+{
+    using namespace zlibNamespace;
+
+    // z_off_t is only 32 bits on some platforms. Combining with a checksum of zero just shifts
+    // the first checksum along by that many bytes, so longer lengths can be applied in steps.
+    constexpr int64 maxStep = 0x40000000;
+    auto crc = (uLong) firstChecksum;
+
+    for (; secondLength > maxStep; secondLength -= maxStep)
+        crc = crc32_combine (crc, 0, (z_off_t) maxStep);
+
+    return (uint32) crc32_combine (crc, secondChecksum, (z_off_t) secondLength);
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class CRC32Tests final : public UnitTest
+{
+public:
+    CRC32Tests()
+        : UnitTest ("CRC32", UnitTestCategories::compression)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Known values");
+        {
+            expectEquals ((int64) CRC32().getChecksum(), (int64) 0);
+            expectEquals ((int64) CRC32 ("123456789", 9).getChecksum(), (int64) 0xcbf43926);
+            expectEquals ((int64) CRC32 ("The quick brown fox jumps over the lazy dog", 43).getChecksum(), (int64) 0x414fa339);
+        }
+
+        beginTest ("Matches zlib");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 50; ++i)
+            {
+                MemoryBlock data ((size_t) r.nextInt (5000));
+                r.fillBitsRandomly (data.getData(), data.getSize());
+                auto offset = (size_t) r.nextInt (jmax (1, (int) data.getSize()));
+                auto* bytes = static_cast<const uint8*> (data.getData()) + offset;
+                auto numBytes = data.getSize() - offset;
+
+                CRC32 crc;
+                crc.update (bytes, numBytes / 3);
+                crc.update (bytes + numBytes / 3, numBytes - numBytes / 3);
+
+                auto expected = zlibNamespace::crc32 (0, bytes, (unsigned int) numBytes);
+                expectEquals ((int64) crc.getChecksum(), (int64) expected);
+                expectEquals ((int64) CRC32 (bytes, numBytes).getChecksum(), (int64) expected);
+
+                auto first = CRC32 (bytes, numBytes / 2).getChecksum();
+                auto second = CRC32 (bytes + numBytes / 2, numBytes - numBytes / 2).getChecksum();
+                expectEquals ((int64) CRC32::combine (first, second, (int64) (numBytes - numBytes / 2)), (int64) expected);
+            }
+        }
+
+        beginTest ("Combining with lengths beyond 32 bits");
+        {
+            const uint32 first = 0x12345678, second = 0x9abcdef0;
+
+            // Shifting in separate steps that all fit in 32 bits must give the same result
+            auto expected = first;
+
+            for (int i = 0; i < 6; ++i)
+                expected = CRC32::combine (expected, 0, 0x7fffffff);
+
+            expected = CRC32::combine (expected, second, 1000);
+
+            expectEquals ((int64) CRC32::combine (first, second, (int64) 0x7fffffff * 6 + 1000), (int64) expected);
+            expectEquals ((int64) CRC32::combine (first, second, 0), (int64) first);
+        }
+    }
+};
+
+static CRC32Tests crc32Tests;
+
+#endif
+
+} // namespace juce
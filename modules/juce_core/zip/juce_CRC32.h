@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Calculates the CRC-32 checksum used by the zip, gzip and png formats.
+
+    The checksum is updated eight bytes at a time using the "slicing-by-8"
+    method, which is several times faster than the byte-wise version.
+
+    @code
+    CRC32 crc;
+    crc.update (firstBlock, firstBlockSize);
+    crc.update (secondBlock, secondBlockSize);
+    auto checksum = crc.getChecksum();
+    @endcode
+
+    @tags{Core}
+*/
+class JUCE_API  CRC32
+{
+public:
+    /** Creates a checksum of an empty block of data. */
+    CRC32() noexcept = default;
+
+    /** Creates a checksum of a block of data. */
+    CRC32 (const void* data, size_t numBytes) noexcept;
+
+    /** Adds some more data to the checksum. */
+    void update (const void* data, size_t numBytes) noexcept;
+
+    /** Returns the checksum of all the data that has been added so far. */
+    uint32 getChecksum() const noexcept      { return checksum; }
+
+    /** Returns the checksum of two consecutive blocks of data, given the checksum of
+        each block and the length of the second one.
+
+        This lets separate parts of a stream be checksummed on different threads.
+    */
+    static uint32 combine (uint32 firstChecksum, uint32 secondChecksum, int64 secondLength) noexcept;
+
+private:
+    uint32 checksum = 0;
+};
+
+} // namespace juce
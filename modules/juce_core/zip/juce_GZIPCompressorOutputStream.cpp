@@ -125,16 +125,242 @@ private:
 };
 
 //==============================================================================
-GZIPCompressorOutputStream::GZIPCompressorOutputStream (OutputStream& s, int compressionLevel, int windowBits)
-   : GZIPCompressorOutputStream (&s, compressionLevel, false, windowBits)
+// Compresses the data in blocks on a thread pool, in the same way as pigz. Each block
+// is compressed as raw deflate data primed with the end of the previous block, and
+// ends on a byte boundary, so the blocks can simply be joined together.
+class GZIPCompressorOutputStream::ParallelCompressorHelper
+{
+public:
+    ParallelCompressorHelper (int compressionLevel, int windowBits, int numThreads)
+        : compLevel ((compressionLevel < 0 || compressionLevel > 9) ? -1 : compressionLevel),
+          format (windowBits < 0 ? Format::raw : (windowBits > 15 ? Format::gzip : Format::zlib)),
+          windowSizeBits (windowBits == 0 ? MAX_WBITS : (windowBits < 0 ? -windowBits : (windowBits & 15))),
+          maxNumBlocksQueued (numThreads * 2),
+          pool (numThreads)
+    {
+        checksum = format == Format::zlib ? 1 : 0;
+    }
+
+    ~ParallelCompressorHelper()
+    {
+        pool.removeAllJobs (false, -1);
+    }
+
+    bool write (const uint8* data, size_t dataSize, OutputStream& out)
+    {
+        // When you call flush() on a gzip stream, the stream is closed, and you can
+        // no longer continue to write data to it!
+        jassert (! finished);
+
+        while (dataSize > 0)
+        {
+            if (currentInput.isEmpty())
+                currentInput.setSize ((size_t) blockSize);
+
+            auto numToCopy = jmin (dataSize, (size_t) blockSize - numInputBytes);
+            currentInput.copyFrom (data, (int) numInputBytes, numToCopy);
+            numInputBytes += numToCopy;
+            data += numToCopy;
+            dataSize -= numToCopy;
+
+            if (numInputBytes == (size_t) blockSize && ! startBlock (false, out))
+                return false;
+        }
+
+        return true;
+    }
+
+    void finish (OutputStream& out)
+    {
+        if (finished)
+            return;
+
+        finished = true;
+        auto ok = startBlock (true, out);
+
+        while (ok && ! blocks.isEmpty())
+            ok = writeNextBlock (out);
+
+        if (! ok)
+            return;
+
+        if (format == Format::gzip)
+        {
+            out.writeInt ((int) checksum);
+            out.writeInt ((int) (uint32) totalInputSize);
+        }
+        else if (format == Format::zlib)
+        {
+            out.writeIntBigEndian ((int) checksum);
+        }
+    }
+
+private:
+    enum { blockSize = 128 * 1024 };
+    enum class Format { raw, zlib, gzip };
+
+    struct Block
+    {
+        MemoryBlock input, dictionary, output;
+        uint32 checksum = 0;
+        bool isLast = false, succeeded = false;
+        WaitableEvent finished;
+    };
+
+    const int compLevel;
+    const Format format;
+    const int windowSizeBits, maxNumBlocksQueued;
+    MemoryBlock currentInput, nextDictionary;
+    size_t numInputBytes = 0;
+    OwnedArray<Block> blocks;
+    uint32 checksum = 0;
+    int64 totalInputSize = 0;
+    bool headerWritten = false, finished = false;
+    ThreadPool pool;
+
+    bool startBlock (bool isLast, OutputStream& out)
+    {
+        if (blocks.size() >= maxNumBlocksQueued && ! writeNextBlock (out))
+            return false;
+
+        auto* block = blocks.add (new Block());
+        block->isLast = isLast;
+        block->dictionary.swapWith (nextDictionary);
+
+        auto dictionarySize = jmin (numInputBytes, (size_t) 1 << windowSizeBits);
+        nextDictionary.replaceAll (addBytesToPointer (currentInput.getData(), numInputBytes - dictionarySize), dictionarySize);
+        block->input.swapWith (currentInput);
+        block->input.setSize (numInputBytes);
+        numInputBytes = 0;
+
+        pool.addJob ([this, block]
+        {
+            block->succeeded = compressBlock (*block);
+            block->finished.signal();
+        });
+
+        return true;
+    }
+
+    bool writeNextBlock (OutputStream& out)
+    {
+        using namespace zlibNamespace;
+        std::unique_ptr<Block> block (blocks.removeAndReturn (0));
+        block->finished.wait();
+
+        if (! (block->succeeded && writeHeader (out) && out.write (block->output.getData(), block->output.getSize())))
+            return false;
+
+        auto inputSize = (int64) block->input.getSize();
+
+        if (format == Format::gzip)
+            checksum = CRC32::combine (checksum, block->checksum, inputSize);
+        else if (format == Format::zlib)
+            checksum = (uint32) adler32_combine (checksum, block->checksum, (z_off_t) inputSize);
+
+        totalInputSize += inputSize;
+        return true;
+    }
+
+    bool writeHeader (OutputStream& out)
+    {
+        if (std::exchange (headerWritten, true))
+            return true;
+
+        if (format == Format::gzip)
+        {
+            const uint8 header[] = { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, 0, 0xff };
+            return out.write (header, sizeof (header));
+        }
+
+        if (format == Format::zlib)
+        {
+            // (the same flags that zlib itself would write for this level)
+            auto level = compLevel < 0 ? 6 : compLevel;
+            auto levelFlags = level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3));
+            auto header = (((windowSizeBits - 8) << 4 | Z_DEFLATED) << 8) | (levelFlags << 6);
+            header += 31 - header % 31;
+            return out.writeShortBigEndian ((short) header);
+        }
+
+        return true;
+    }
+
+    bool compressBlock (Block& block) const
+    {
+        using namespace zlibNamespace;
+
+        if (format == Format::gzip)
+            block.checksum = CRC32 (block.input.getData(), block.input.getSize()).getChecksum();
+        else if (format == Format::zlib)
+            block.checksum = (uint32) adler32 (1, static_cast<const Bytef*> (block.input.getData()), (z_uInt) block.input.getSize());
+
+        z_stream stream;
+        zerostruct (stream);
+
+        if (deflateInit2 (&stream, compLevel, Z_DEFLATED, -windowSizeBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            return false;
+
+        if (block.dictionary.getSize() > 0)
+            deflateSetDictionary (&stream, static_cast<const Bytef*> (block.dictionary.getData()), (z_uInt) block.dictionary.getSize());
+
+        // (the extra bytes leave room for the empty block that a sync flush adds)
+        block.output.setSize (deflateBound (&stream, (uLong) block.input.getSize()) + 16);
+
+        stream.next_in   = static_cast<Bytef*> (block.input.getData());
+        stream.avail_in  = (z_uInt) block.input.getSize();
+        stream.next_out  = static_cast<Bytef*> (block.output.getData());
+        stream.avail_out = (z_uInt) block.output.getSize();
+
+        auto flushMode = block.isLast ? Z_FINISH : Z_SYNC_FLUSH;
+        auto succeeded = false;
+
+        for (;;)
+        {
+            auto result = deflate (&stream, flushMode);
+
+            if (result == Z_STREAM_END || (result == Z_OK && flushMode == Z_SYNC_FLUSH && stream.avail_out > 0))
+            {
+                succeeded = true;
+                break;
+            }
+
+            if ((result != Z_OK && result != Z_BUF_ERROR) || stream.avail_out > 0)
+                break;
+
+            auto numDone = block.output.getSize();
+            block.output.setSize (numDone * 2);
+            stream.next_out  = static_cast<Bytef*> (block.output.getData()) + numDone;
+            stream.avail_out = (z_uInt) numDone;
+        }
+
+        block.output.setSize (stream.total_out);
+        deflateEnd (&stream);
+        return succeeded;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ParallelCompressorHelper)
+};
+
+//==============================================================================
+GZIPCompressorOutputStream::GZIPCompressorOutputStream (OutputStream& s, int compressionLevel, int windowBits, int numThreads)
+   : GZIPCompressorOutputStream (&s, compressionLevel, false, windowBits, numThreads)
 {
 }
 
-GZIPCompressorOutputStream::GZIPCompressorOutputStream (OutputStream* out, int compressionLevel, bool deleteDestStream, int windowBits)
-   : destStream (out, deleteDestStream),
-     helper (new GZIPCompressorHelper (compressionLevel, windowBits))
+GZIPCompressorOutputStream::GZIPCompressorOutputStream (OutputStream* out, int compressionLevel, bool deleteDestStream,
+                                                        int windowBits, int numThreads)
+   : destStream (out, deleteDestStream)
 {
     jassert (out != nullptr);
+
+    if (numThreads <= 0)
+        numThreads = SystemStats::getNumCpus();
+
+    if (numThreads > 1)
+        parallelHelper.reset (new ParallelCompressorHelper (compressionLevel, windowBits, numThreads));
+    else
+        helper.reset (new GZIPCompressorHelper (compressionLevel, windowBits));
 }
 
 GZIPCompressorOutputStream::~GZIPCompressorOutputStream()
@@ -144,7 +370,11 @@ GZIPCompressorOutputStream::~GZIPCompressorOutputStream()
 
 void GZIPCompressorOutputStream::flush()
 {
-    helper->finish (*destStream);
+    if (parallelHelper != nullptr)
+        parallelHelper->finish (*destStream);
+    else
+        helper->finish (*destStream);
+
     destStream->flush();
 }
 
@@ -152,6 +382,9 @@ bool GZIPCompressorOutputStream::write (const void* destBuffer, size_t howMany)
 {
     jassert (destBuffer != nullptr && (ssize_t) howMany >= 0);
 
+    if (parallelHelper != nullptr)
+        return parallelHelper->write (static_cast<const uint8*> (destBuffer), howMany, *destStream);
+
     return helper->write (static_cast<const uint8*> (destBuffer), howMany, *destStream);
 }
 
@@ -216,6 +449,46 @@ struct GZIPTests final : public UnitTest
                                 original.getData(),
                                 original.getDataSize()) == 0);
         }
+
+        beginTest ("Multithreaded");
+
+        const std::pair<int, GZIPDecompressorInputStream::Format> formats[] =
+        {
+            { 0,                                                GZIPDecompressorInputStream::zlibFormat },
+            { GZIPCompressorOutputStream::windowBitsGZIP,       GZIPDecompressorInputStream::gzipFormat },
+            { GZIPCompressorOutputStream::windowBitsRaw,        GZIPDecompressorInputStream::deflateFormat }
+        };
+
+        for (auto [windowBits, format] : formats)
+        {
+            for (auto numBytes : { 0, 1000, 128 * 1024, rng.nextInt (600000) })
+            {
+                MemoryOutputStream original, compressed, uncompressed;
+
+                for (int i = 0; i < numBytes; ++i)
+                    original.writeByte ((char) (rng.nextInt (8) == 0 ? rng.nextInt (256) : 'a' + (i % 13)));
+
+                {
+                    GZIPCompressorOutputStream zipper (compressed, rng.nextInt (10), windowBits, 3);
+
+                    for (size_t pos = 0; pos < original.getDataSize();)
+                    {
+                        auto numToWrite = jmin (original.getDataSize() - pos, (size_t) rng.nextInt (70000) + 1);
+                        zipper.write (addBytesToPointer (original.getData(), pos), numToWrite);
+                        pos += numToWrite;
+                    }
+                }
+
+                {
+                    MemoryInputStream compressedInput (compressed.getData(), compressed.getDataSize(), false);
+                    GZIPDecompressorInputStream unzipper (&compressedInput, false, format);
+
+                    uncompressed << unzipper;
+                }
+
+                expect (original.getMemoryBlock() == uncompressed.getMemoryBlock());
+            }
+        }
     }
 };
 
@@ -43,6 +43,12 @@ namespace juce
     the gzip data is closed - this means that no more data can be written to
     it, and any subsequent attempts to call write() will cause an assertion.
 
+    If more than one thread is requested, the data is split into blocks which are
+    compressed in parallel, each one using the end of the previous block as its
+    dictionary. The output is still a single standard stream in the requested format,
+    although it won't be byte-for-byte identical to the single-threaded output, and
+    it's slightly larger.
+
     @see GZIPDecompressorInputStream
 
     @tags{Core}
@@ -60,10 +66,13 @@ public:
         @param windowBits                       this is used internally to change the window size used
                                                 by zlib - leave it as 0 unless you specifically need to set
                                                 its value for some reason
+        @param numThreads                       the number of threads to compress on, or 0 to use one
+                                                per CPU core
     */
     GZIPCompressorOutputStream (OutputStream& destStream,
                                 int compressionLevel = -1,
-                                int windowBits = 0);
+                                int windowBits = 0,
+                                int numThreads = 1);
 
     /** Creates a compression stream.
         @param destStream                       the stream into which the compressed data will be written.
@@ -77,11 +86,14 @@ public:
         @param windowBits                       this is used internally to change the window size used
                                                 by zlib - leave it as 0 unless you specifically need to set
                                                 its value for some reason
+        @param numThreads                       the number of threads to compress on, or 0 to use one
+                                                per CPU core
     */
     GZIPCompressorOutputStream (OutputStream* destStream,
                                 int compressionLevel = -1,
                                 bool deleteDestStreamWhenDestroyed = false,
-                                int windowBits = 0);
+                                int windowBits = 0,
+                                int numThreads = 1);
 
     /** Destructor. */
     ~GZIPCompressorOutputStream() override;
@@ -112,7 +124,9 @@ private:
     OptionalScopedPointer<OutputStream> destStream;
 
     class GZIPCompressorHelper;
+    class ParallelCompressorHelper;
     std::unique_ptr<GZIPCompressorHelper> helper;
+    std::unique_ptr<ParallelCompressorHelper> parallelHelper;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GZIPCompressorOutputStream)
 };
@@ -170,8 +170,7 @@ struct ZipFile::ZipInputStream final : public InputStream
         char buffer[30];
 
         if (inputStream != nullptr
-             && inputStream->setPosition (zei.streamOffset)
-             && inputStream->read (buffer, 30) == 30
+             && readFromSource (zei.streamOffset, buffer, 30) == 30
              && ByteOrder::littleEndianInt (buffer) == 0x04034b50)
         {
             headerSize = 30 + ByteOrder::littleEndianShort (buffer + 26)
@@ -202,19 +201,7 @@ struct ZipFile::ZipInputStream final : public InputStream
         if (inputStream == nullptr)
             return 0;
 
-        int num;
-
-        if (inputStream == file.inputStream)
-        {
-            const ScopedLock sl (file.lock);
-            inputStream->setPosition (pos + zipEntryHolder.streamOffset + headerSize);
-            num = inputStream->read (buffer, howMany);
-        }
-        else
-        {
-            inputStream->setPosition (pos + zipEntryHolder.streamOffset + headerSize);
-            num = inputStream->read (buffer, howMany);
-        }
+        auto num = readFromSource (pos + zipEntryHolder.streamOffset + headerSize, buffer, howMany);
 
         pos += num;
         return num;
@@ -244,6 +231,23 @@ private:
     InputStream* inputStream;
     std::unique_ptr<InputStream> streamToDelete;
 
+    int readFromSource (int64 sourcePosition, void* buffer, int howMany)
+    {
+        auto readBlock = [&]
+        {
+            inputStream->setPosition (sourcePosition);
+            return inputStream->read (buffer, howMany);
+        };
+
+        if (inputStream == file.inputStream)
+        {
+            const ScopedLock sl (file.lock);
+            return readBlock();
+        }
+
+        return readBlock();
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZipInputStream)
 };
 
@@ -265,7 +269,18 @@ ZipFile::ZipFile (InputStream& stream)  : inputStream (&stream)
 
 ZipFile::ZipFile (const File& file)  : inputSource (new FileInputSource (file))
 {
-    init();
+    // Mapping the file lets the central directory be parsed in place, rather than copied
+    MemoryMappedFile mappedFile (file, MemoryMappedFile::readOnly);
+
+    if (mappedFile.getData() != nullptr)
+    {
+        MemoryInputStream mappedStream (mappedFile.getData(), mappedFile.getSize(), false);
+        init (mappedStream);
+    }
+    else
+    {
+        init();
+    }
 }
 
 ZipFile::ZipFile (InputSource* source)  : inputSource (source)
@@ -373,43 +388,70 @@ void ZipFile::init()
     }
 
     if (in != nullptr)
+        init (*in);
+}
+
+void ZipFile::init (InputStream& in)
+{
+    int numEntries = 0;
+    auto centralDirectoryPos = findCentralDirectoryFileHeader (in, numEntries);
+
+    if (centralDirectoryPos < 0 || centralDirectoryPos >= in.getTotalLength())
+        return;
+
+    auto size = (size_t) (in.getTotalLength() - centralDirectoryPos);
+    const char* headerData = nullptr;
+    MemoryBlock headerCopy;
+
+    if (auto* memoryStream = dynamic_cast<MemoryInputStream*> (&in))
     {
-        int numEntries = 0;
-        auto centralDirectoryPos = findCentralDirectoryFileHeader (*in, numEntries);
+        headerData = static_cast<const char*> (memoryStream->getData()) + centralDirectoryPos;
+    }
+    else
+    {
+        in.setPosition (centralDirectoryPos);
 
-        if (centralDirectoryPos >= 0 && centralDirectoryPos < in->getTotalLength())
-        {
-            auto size = (size_t) (in->getTotalLength() - centralDirectoryPos);
+        if (in.readIntoMemoryBlock (headerCopy, (ssize_t) size) != size)
+            return;
 
-            in->setPosition (centralDirectoryPos);
-            MemoryBlock headerData;
+        headerData = static_cast<const char*> (headerCopy.getData());
+    }
 
-            if (in->readIntoMemoryBlock (headerData, (ssize_t) size) == size)
-            {
-                size_t pos = 0;
+    size_t pos = 0;
 
-                for (int i = 0; i < numEntries; ++i)
-                {
-                    if (pos + 46 > size)
-                        break;
+    for (int i = 0; i < numEntries; ++i)
+    {
+        if (pos + 46 > size)
+            break;
 
-                    auto* buffer = static_cast<const char*> (headerData.getData()) + pos;
-                    auto fileNameLen = readUnalignedLittleEndianShort (buffer + 28u);
+        auto* buffer = headerData + pos;
+        auto fileNameLen = readUnalignedLittleEndianShort (buffer + 28u);
 
-                    if (pos + 46 + fileNameLen > size)
-                        break;
+        if (pos + 46 + fileNameLen > size)
+            break;
 
-                    entries.add (new ZipEntryHolder (buffer, fileNameLen));
+        entries.add (new ZipEntryHolder (buffer, fileNameLen));
 
-                    pos += 46u + fileNameLen
-                            + readUnalignedLittleEndianShort (buffer + 30u)
-                            + readUnalignedLittleEndianShort (buffer + 32u);
-                }
-            }
-        }
+        pos += 46u + fileNameLen
+                + readUnalignedLittleEndianShort (buffer + 30u)
+                + readUnalignedLittleEndianShort (buffer + 32u);
     }
 }
 
+static String getEntryPath (const ZipFile::ZipEntry& entry)
+{
+   #if JUCE_WINDOWS
+    return entry.filename;
+   #else
+    return entry.filename.replaceCharacter ('\\', '/');
+   #endif
+}
+
+static bool isDirectoryPath (const String& entryPath)
+{
+    return entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\');
+}
+
 Result ZipFile::uncompressTo (const File& targetDirectory,
                               const bool shouldOverwriteFiles)
 {
@@ -424,6 +466,108 @@ Result ZipFile::uncompressTo (const File& targetDirectory,
     return Result::ok();
 }
 
+Result ZipFile::uncompressTo (const File& targetDirectory,
+                              OverwriteFiles overwriteFiles,
+                              FollowSymlinks followSymlinks,
+                              int numThreads)
+{
+    if (numThreads <= 0)
+        numThreads = SystemStats::getNumCpus();
+
+    // Directories and links are made before anything else, so that the symlink checks for
+    // the other entries can see them. Entries that share a target are left until the end,
+    // where they're extracted one at a time in their original order.
+    auto getTargetKey = [&] (const String& entryPath)
+    {
+        auto path = targetDirectory.getChildFile (entryPath).getFullPathName();
+        return File::areFileNamesCaseSensitive() ? path : path.toLowerCase();
+    };
+
+    FlatHashMap<String, int> numEntriesForTarget;
+
+    for (auto* zei : entries)
+        ++numEntriesForTarget.getReference (getTargetKey (getEntryPath (zei->entry)));
+
+    Array<int> firstEntries, parallelEntries, lastEntries;
+
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        auto& entry = entries.getUnchecked (i)->entry;
+        auto entryPath = getEntryPath (entry);
+
+        if (numEntriesForTarget[getTargetKey (entryPath)] > 1)
+            lastEntries.add (i);
+        else if (entry.isSymbolicLink || isDirectoryPath (entryPath))
+            firstEntries.add (i);
+        else
+            parallelEntries.add (i);
+    }
+
+    auto uncompressEntries = [&] (const Array<int>& indexes)
+    {
+        for (auto i : indexes)
+        {
+            auto result = uncompressEntry (i, targetDirectory, overwriteFiles, followSymlinks);
+
+            if (result.failed())
+                return result;
+        }
+
+        return Result::ok();
+    };
+
+    auto result = uncompressEntries (firstEntries);
+
+    if (result.failed())
+        return result;
+
+    if (numThreads > 1 && parallelEntries.size() > 1)
+    {
+        Array<Result> results;
+        results.insertMultiple (0, Result::ok(), parallelEntries.size());
+        std::atomic<int> nextEntry { 0 };
+        std::atomic<bool> anyFailed { false };
+
+        auto uncompressNextEntries = [&]
+        {
+            while (! anyFailed)
+            {
+                auto i = nextEntry++;
+
+                if (i >= parallelEntries.size())
+                    break;
+
+                auto& r = results.getReference (i);
+                r = uncompressEntry (parallelEntries.getUnchecked (i), targetDirectory, overwriteFiles, followSymlinks);
+
+                if (r.failed())
+                    anyFailed = true;
+            }
+        };
+
+        ThreadPool pool (jmin (numThreads, parallelEntries.size()) - 1);
+
+        for (int i = pool.getNumThreads(); --i >= 0;)
+            pool.addJob (uncompressNextEntries);
+
+        uncompressNextEntries();
+        pool.removeAllJobs (false, -1);
+
+        for (auto& r : results)
+            if (r.failed())
+                return r;
+    }
+    else
+    {
+        result = uncompressEntries (parallelEntries);
+
+        if (result.failed())
+            return result;
+    }
+
+    return uncompressEntries (lastEntries);
+}
+
 Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool shouldOverwriteFiles)
 {
     return uncompressEntry (index,
@@ -435,12 +579,7 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, bool sh
 Result ZipFile::uncompressEntry (int index, const File& targetDirectory, OverwriteFiles overwriteFiles, FollowSymlinks followSymlinks)
 {
     auto* zei = entries.getUnchecked (index);
-
-   #if JUCE_WINDOWS
-    auto entryPath = zei->entry.filename;
-   #else
-    auto entryPath = zei->entry.filename.replaceCharacter ('\\', '/');
-   #endif
+    auto entryPath = getEntryPath (zei->entry);
 
     if (entryPath.isEmpty())
         return Result::ok();
@@ -450,7 +589,7 @@ Result ZipFile::uncompressEntry (int index, const File& targetDirectory, Overwri
     if (! targetFile.isAChildOf (targetDirectory))
         return Result::fail ("Entry " + entryPath + " is outside the target directory");
 
-    if (entryPath.endsWithChar ('/') || entryPath.endsWithChar ('\\'))
+    if (isDirectoryPath (entryPath))
         return targetFile.createDirectory(); // (entry is a directory, not a file)
 
     std::unique_ptr<InputStream> in (createStreamForEntry (index));
@@ -508,9 +647,11 @@ struct ZipFile::Builder::Item
         symbolicLink = (file.exists() && file.isSymbolicLink());
     }
 
-    bool writeData (OutputStream& target, const int64 overallStartPosition)
+    bool compressData()
     {
-        MemoryOutputStream compressedData ((size_t) file.getSize());
+        // The block grows with the compressed output, rather than being sized for the source,
+        // as several items may be waiting to be written at once
+        MemoryOutputStream out (compressedData, false);
 
         if (symbolicLink)
         {
@@ -518,30 +659,58 @@ struct ZipFile::Builder::Item
 
             uncompressedSize = relativePath.length();
 
-            checksum = zlibNamespace::crc32 (0, (uint8_t*) relativePath.toRawUTF8(), (unsigned int) uncompressedSize);
-            compressedData << relativePath;
+            checksum = CRC32 (relativePath.toRawUTF8(), (size_t) uncompressedSize).getChecksum();
+            out << relativePath;
         }
         else if (compressionLevel > 0)
         {
-            GZIPCompressorOutputStream compressor (compressedData, compressionLevel,
+            GZIPCompressorOutputStream compressor (out, compressionLevel,
                                                    GZIPCompressorOutputStream::windowBitsRaw);
             if (! writeSource (compressor))
                 return false;
         }
         else
         {
-            if (! writeSource (compressedData))
+            if (! writeSource (out))
                 return false;
         }
 
-        compressedSize = (int64) compressedData.getDataSize();
+        compressedSize = (int64) out.getDataSize();
+        return true;
+    }
+
+    // Used when the builder is compressing several items at once
+    void compressDataOnBackgroundThread()
+    {
+        compressionSucceeded = compressData();
+        compressionFinished.signal();
+    }
+
+    bool waitForCompressedData()
+    {
+        compressionFinished.wait();
+        return compressionSucceeded;
+    }
+
+    // When a write is abandoned, any results that weren't written must be thrown away,
+    // or a later write could take them for those of its own compression job
+    void discardCompressedData()
+    {
+        compressionFinished.reset();
+        compressionSucceeded = false;
+        compressedData.reset();
+    }
+
+    bool writeData (OutputStream& target, const int64 overallStartPosition)
+    {
         headerStart = target.getPosition() - overallStartPosition;
 
         target.writeInt (0x04034b50);
         writeFlagsAndSizes (target);
-        target << storedPathname
-               << compressedData;
+        target << storedPathname;
+        target.write (compressedData.getData(), (size_t) compressedSize);
 
+        compressedData.reset();
         return true;
     }
 
@@ -567,8 +736,11 @@ private:
     Time fileTime;
     int64 compressedSize = 0, uncompressedSize = 0, headerStart = 0;
     int compressionLevel = 0;
-    unsigned long checksum = 0;
+    uint32 checksum = 0;
     bool symbolicLink = false;
+    MemoryBlock compressedData;
+    WaitableEvent compressionFinished;
+    bool compressionSucceeded = false;
 
     static void writeTimeAndDate (OutputStream& target, Time t)
     {
@@ -586,7 +758,7 @@ private:
                 return false;
         }
 
-        checksum = 0;
+        CRC32 crc;
         uncompressedSize = 0;
         const int bufferSize = 4096;
         HeapBlock<unsigned char> buffer (bufferSize);
@@ -598,11 +770,12 @@ private:
             if (bytesRead < 0)
                 return false;
 
-            checksum = zlibNamespace::crc32 (checksum, buffer, (unsigned int) bytesRead);
+            crc.update (buffer, (size_t) bytesRead);
             target.write (buffer, (size_t) bytesRead);
             uncompressedSize += bytesRead;
         }
 
+        checksum = crc.getChecksum();
         stream.reset();
         return true;
     }
@@ -643,15 +816,63 @@ void ZipFile::Builder::addEntry (InputStream* stream, int compression, const Str
 
 bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress) const
 {
+    return writeToStream (target, progress, 1);
+}
+
+bool ZipFile::Builder::writeToStream (OutputStream& target, double* const progress, int numThreads) const
+{
+    if (numThreads <= 0)
+        numThreads = SystemStats::getNumCpus();
+
+    std::unique_ptr<ThreadPool> pool;
+
+    if (numThreads > 1 && items.size() > 1)
+        pool = std::make_unique<ThreadPool> (jmin (numThreads, items.size()));
+
+    // Items are compressed a little way ahead of the one being written, which keeps the
+    // threads busy without holding too much compressed data in memory
+    const auto maxNumItemsAhead = numThreads * 2;
+    int numItemsQueued = 0;
     auto fileStart = target.getPosition();
 
-    for (int i = 0; i < items.size(); ++i)
+    auto writeItems = [&]
     {
-        if (progress != nullptr)
-            *progress = (i + 0.5) / items.size();
+        for (int i = 0; i < items.size(); ++i)
+        {
+            if (progress != nullptr)
+                *progress = (i + 0.5) / items.size();
 
-        if (! items.getUnchecked (i)->writeData (target, fileStart))
-            return false;
+            auto* item = items.getUnchecked (i);
+
+            if (pool != nullptr)
+            {
+                for (; numItemsQueued < jmin (items.size(), i + maxNumItemsAhead); ++numItemsQueued)
+                    pool->addJob ([itemToCompress = items.getUnchecked (numItemsQueued)] { itemToCompress->compressDataOnBackgroundThread(); });
+
+                if (! item->waitForCompressedData())
+                    return false;
+            }
+            else if (! item->compressData())
+            {
+                return false;
+            }
+
+            if (! item->writeData (target, fileStart))
+                return false;
+        }
+
+        return true;
+    };
+
+    if (! writeItems())
+    {
+        if (pool != nullptr)
+            pool->removeAllJobs (false, -1);
+
+        for (auto* item : items)
+            item->discardCompressedData();
+
+        return false;
     }
 
     auto directoryStart = target.getPosition();
@@ -773,6 +994,133 @@ struct ZIPTests final : public UnitTest
 
         beginTest ("ZipSlip");
         runZipSlipTest();
+
+        beginTest ("Multithreaded builder");
+        auto contents = createTestContents (getRandom());
+        auto singleThreadedData = createZipMemoryBlock (contents, 1);
+        auto multiThreadedData = createZipMemoryBlock (contents, 4);
+        expect (singleThreadedData == multiThreadedData);
+
+        beginTest ("Multithreaded extraction");
+        TemporaryFile zipFile;
+        zipFile.getFile().replaceWithData (multiThreadedData.getData(), multiThreadedData.getSize());
+        ZipFile mappedZip (zipFile.getFile());
+        expectEquals (mappedZip.getNumEntries(), (int) contents.size());
+
+        TemporaryFile tmpDir;
+        auto result = mappedZip.uncompressTo (tmpDir.getFile(), ZipFile::OverwriteFiles::yes, ZipFile::FollowSymlinks::no, 4);
+        expect (result.wasOk(), result.getErrorMessage());
+
+        std::map<String, MemoryBlock> expectedFiles;
+
+        for (auto& [entryName, entryData] : contents)
+            expectedFiles[entryName] = entryData;
+
+        for (auto& [entryName, entryData] : expectedFiles)
+        {
+            MemoryBlock extracted;
+            expect (tmpDir.getFile().getChildFile (entryName).loadFileAsData (extracted));
+            expect (extracted == entryData, entryName);
+        }
+
+        beginTest ("Multithreaded builder can be retried after a failed write");
+        runRetryTest (contents);
+    }
+
+    void runRetryTest (const std::vector<std::pair<String, MemoryBlock>>& contents)
+    {
+        TemporaryFile sourceDir;
+        sourceDir.getFile().createDirectory();
+
+        ZipFile::Builder builder;
+        std::vector<std::pair<String, MemoryBlock>> expected;
+
+        for (size_t i = 0; i < 16; ++i)
+        {
+            auto source = sourceDir.getFile().getChildFile ("source" + String ((int) i));
+            const auto& data = contents[i].second;
+
+            // This one doesn't exist yet, so the first write fails part-way through
+            if (i != 2)
+                source.replaceWithData (data.getData(), data.getSize());
+
+            builder.addFile (source, 6);
+            expected.emplace_back (source.getFileName(), data);
+        }
+
+        MemoryOutputStream failedOutput;
+        expect (! builder.writeToStream (failedOutput, nullptr, 4));
+
+        const auto& missingData = expected[2].second;
+        sourceDir.getFile().getChildFile (expected[2].first).replaceWithData (missingData.getData(), missingData.getSize());
+
+        MemoryBlock zipData;
+
+        {
+            MemoryOutputStream mo (zipData, false);
+            expect (builder.writeToStream (mo, nullptr, 4));
+        }
+
+        MemoryInputStream mi (zipData, false);
+        ZipFile zip (mi);
+        expectEquals (zip.getNumEntries(), (int) expected.size());
+
+        for (auto& [entryName, entryData] : expected)
+        {
+            if (auto* entry = zip.getEntry (entryName))
+            {
+                std::unique_ptr<InputStream> input (zip.createStreamForEntry (*entry));
+                MemoryBlock extracted;
+
+                if (input != nullptr)
+                    input->readIntoMemoryBlock (extracted);
+
+                expect (extracted == entryData, entryName);
+            }
+            else
+            {
+                expect (false, entryName);
+            }
+        }
+    }
+
+    static std::vector<std::pair<String, MemoryBlock>> createTestContents (Random r)
+    {
+        std::vector<std::pair<String, MemoryBlock>> contents;
+
+        for (int i = 0; i < 40; ++i)
+        {
+            MemoryBlock data;
+            MemoryOutputStream mo (data, false);
+            auto numWords = r.nextInt (i % 4 == 0 ? 20000 : 200);
+
+            for (int j = 0; j < numWords; ++j)
+                mo << (i % 2 == 0 ? String (r.nextInt (1000)) : String::charToString ((juce_wchar) ('a' + r.nextInt (26)))) << ' ';
+
+            mo.flush();
+            contents.emplace_back ("folder" + String (i % 3) + "/sub/file" + String (i), data);
+        }
+
+        // Later entries with the same name should replace earlier ones
+        contents.emplace_back ("folder0/sub/file0", MemoryBlock ("replaced", 8));
+        return contents;
+    }
+
+    static MemoryBlock createZipMemoryBlock (const std::vector<std::pair<String, MemoryBlock>>& contents, int numThreads)
+    {
+        ZipFile::Builder builder;
+        const Time fileTime (2020, 1, 2, 3, 4, 6);
+        int level = 0;
+
+        for (auto& [entryName, entryData] : contents)
+            builder.addEntry (new MemoryInputStream (entryData, false), level++ % 10, entryName, fileTime);
+
+        MemoryBlock zipData;
+        MemoryOutputStream mo (zipData, false);
+        builder.writeToStream (mo, nullptr, numThreads);
+        mo.flush();
+
+        return zipData;
     }
 };
 
@@ -211,6 +211,29 @@ public:
                             OverwriteFiles overwriteFiles,
                             FollowSymlinks followSymlinks);
 
+    /** Uncompresses all of the files in the zip file, using several threads.
+
+        This expands the entries in the same way as uncompressTo(), but decompresses
+        several of them at once.
+
+        Directories and symbolic links are created first, and entries which share a
+        target file are extracted last in their original order, so the end result is
+        the same as extracting the entries one at a time. If the ZipFile was created
+        from a File or InputSource, each thread reads from its own stream; if it uses
+        an InputStream supplied by the caller, reads from it are serialised.
+
+        @param targetDirectory      the root folder to uncompress to
+        @param overwriteFiles       whether to overwrite existing files with similarly-named ones
+        @param followSymlinks       whether to follow symlinks inside the target directory
+        @param numThreads           the number of threads to use, including the calling one; if
+                                    this is 0, one thread per CPU core is used
+        @returns success if all the entries are uncompressed, or the first failure
+    */
+    Result uncompressTo (const File& targetDirectory,
+                         OverwriteFiles overwriteFiles,
+                         FollowSymlinks followSymlinks,
+                         int numThreads);
+
     //==============================================================================
     /** Used to create a new zip file.
 
@@ -258,6 +281,15 @@ public:
         */
         bool writeToStream (OutputStream& target, double* progress) const;
 
+        /** Generates the zip file, compressing several entries at once.
+
+            This writes exactly the same data as the other writeToStream() method, but the
+            entries are compressed on a pool of numThreads threads (or one per CPU core if
+            numThreads is 0) while the calling thread writes them to the target in order.
+            Only a couple of compressed entries per thread are held in memory at a time.
+        */
+        bool writeToStream (OutputStream& target, double* progress, int numThreads) const;
+
         //==============================================================================
     private:
         struct Item;
@@ -283,13 +315,14 @@ private:
         OpenStreamCounter() = default;
         ~OpenStreamCounter();
 
-        int numOpenStreams = 0;
+        std::atomic<int> numOpenStreams { 0 };
     };
 
     OpenStreamCounter streamCounter;
    #endif
 
     void init();
+    void init (InputStream&);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZipFile)
 };
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE framework.
+   Copyright (c) Raw Material Software Limited
+
+   JUCE is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the JUCE framework, or combining the
+   JUCE framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the JUCE End User Licence
+   Agreement, and all incorporated terms including the JUCE Privacy Policy and
+   the JUCE Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the JUCE
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the JUCE framework.
+
+   JUCE End User Licence Agreement: https://juce.com/legal/juce-8-licence/
+   JUCE Privacy Policy: https://juce.com/juce-privacy-policy
+   JUCE Website Terms of Service: https://juce.com/juce-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE JUCE FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce::HashingHelpers
+{
+
+// Large files are mapped a section at a time, to avoid using up the address space
+constexpr int64 mappedSectionSize = 64 * 1024 * 1024;
+
+constexpr int readBufferSize = 64 * 1024;
+
+/*  Passes the contents of a stream to a callback in large chunks, until the stream is
+    exhausted or the given number of bytes has been read.
+*/
+template <typename Callback>
+static void processStream (InputStream& input, int64 numBytesToRead, Callback&& callback)
+{
+    if (numBytesToRead < 0)
+        numBytesToRead = std::numeric_limits<int64>::max();
+
+    HeapBlock<char> buffer;
+
+    while (numBytesToRead > 0)
+    {
+        if (buffer == nullptr)
+            buffer.malloc (readBufferSize);
+
+        const auto bytesRead = input.read (buffer, (int) jmin (numBytesToRead, (int64) readBufferSize));
+
+        if (bytesRead <= 0)
+            break;
+
+        callback (buffer.get(), (size_t) bytesRead);
+        numBytesToRead -= bytesRead;
+    }
+}
+
+/*  Memory-maps a file, a section at a time, and passes its contents to a callback.
+    Returns false if any of it couldn't be mapped.
+
+    The file's size is checked after each section is mapped, but if it's truncated
+    while a section is being processed, this process will crash, which is why this is
+    only used by the fromMemoryMappedFile() methods, and never for a stream.
+*/
+template <typename Callback>
+static bool processMappedFile (const File& file, Callback&& callback)
+{
+    const auto size = file.getSize();
+
+    // (an empty file can't be mapped)
+    if (size == 0)
+        return file.existsAsFile();
+
+    for (int64 pos = 0; pos < size;)
+    {
+        const MemoryMappedFile mapped (file, { pos, jmin (size, pos + mappedSectionSize) }, MemoryMappedFile::readOnly);
+
+        if (mapped.getData() == nullptr)
+            return false;
+
+        // (the start of the mapping may have been rounded down to a page boundary)
+        const auto numBytes = jmin (size, mapped.getRange().getEnd()) - pos;
+
+        if (numBytes <= 0 || file.getSize() < pos + numBytes)
+            return false;
+
+        callback (addBytesToPointer (mapped.getData(), pos - mapped.getRange().getStart()), (size_t) numBytes);
+        pos += numBytes;
+    }
+
+    return true;
+}
+
+} // namespace juce::HashingHelpers
@@ -235,24 +235,28 @@ MD5::MD5 (const File& file)
         processStream (fin, -1);
 }
 
-void MD5::processStream (InputStream& input, int64 numBytesToRead)
+MD5 MD5::fromMemoryMappedFile (const File& file)
 {
+    MD5 m;
     MD5Generator generator;
 
-    if (numBytesToRead < 0)
-        numBytesToRead = std::numeric_limits<int64>::max();
+    if (HashingHelpers::processMappedFile (file, [&generator] (const void* data, size_t numBytes)
+                                           {
+                                               generator.processBlock (data, numBytes);
+                                           }))
+        generator.finish (m.result);
 
-    while (numBytesToRead > 0)
-    {
-        uint8_t tempBuffer[512];
-        auto bytesRead = input.read (tempBuffer, (int) jmin (numBytesToRead, (int64) sizeof (tempBuffer)));
+    return m;
+}
 
-        if (bytesRead <= 0)
-            break;
+void MD5::processStream (InputStream& input, int64 numBytesToRead)
+{
+    MD5Generator generator;
 
-        numBytesToRead -= bytesRead;
-        generator.processBlock (tempBuffer, (size_t) bytesRead);
-    }
+    HashingHelpers::processStream (input, numBytesToRead, [&generator] (const void* data, size_t numBytes)
+    {
+        generator.processBlock (data, numBytes);
+    });
 
     generator.finish (result);
 }
@@ -107,6 +107,16 @@ public:
     */
     static MD5 fromUTF32 (StringRef);
 
+    /** Creates a checksum for a file by memory-mapping it, rather than reading it
+        through a buffer.
+
+        Only use this for files that can't be changed while they're being read: if the
+        file is truncated during this call, this process will crash. If the file can't
+        be mapped, the checksum will be left uninitialised (i.e. full of zeros).
+        @see SHA256::fromMemoryMappedFile
+    */
+    static MD5 fromMemoryMappedFile (const File& file);
+
     //==============================================================================
     bool operator== (const MD5&) const noexcept;
     bool operator!= (const MD5&) const noexcept;
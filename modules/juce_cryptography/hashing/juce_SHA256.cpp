@@ -32,120 +32,349 @@
   ==============================================================================
 */
 
+#if JUCE_INTEL && (JUCE_GCC || JUCE_CLANG || JUCE_MSVC)
+ #define JUCE_SHA256_USE_INTEL_INTRINSICS 1
+#endif
+
+#if JUCE_ARM && JUCE_64BIT
+ #if defined (__ARM_FEATURE_SHA2) || defined (__ARM_FEATURE_CRYPTO)
+  #define JUCE_SHA256_USE_ARM_CRYPTO 1
+  #define JUCE_SHA256_ARM_CRYPTO_ALWAYS_AVAILABLE 1
+ #elif JUCE_GCC && (JUCE_LINUX || JUCE_ANDROID)
+  #define JUCE_SHA256_USE_ARM_CRYPTO 1
+ #endif
+#endif
+
+#if JUCE_MSVC
+ #define JUCE_SHA256_TARGET(features)
+#else
+ #define JUCE_SHA256_TARGET(features) __attribute__ ((target (features)))
+#endif
+
 namespace juce
 {
 
 struct SHA256Processor
 {
-    // expects 64 bytes of data
-    void processFullBlock (const void* data) noexcept
+    using BlockFunction = void (*) (uint32_t* state, const uint8_t* data, size_t numBlocks);
+
+    void process (const void* data, size_t numBytes) noexcept
     {
-        const uint32_t constants[] =
+        auto d = static_cast<const uint8_t*> (data);
+        length += numBytes;
+
+        if (bufferSize > 0)
         {
-            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
-        };
+            const auto numToCopy = jmin (numBytes, sizeof (buffer) - bufferSize);
+            memcpy (buffer + bufferSize, d, numToCopy);
+            bufferSize += numToCopy;
+            d += numToCopy;
+            numBytes -= numToCopy;
 
-        uint32_t block[16], s[8];
-        memcpy (s, state, sizeof (s));
+            if (bufferSize < sizeof (buffer))
+                return;
 
-        auto d = static_cast<const uint8_t*> (data);
+            processBlocks (state, buffer, 1);
+            bufferSize = 0;
+        }
+
+        const auto numBlocks = numBytes / 64;
+
+        if (numBlocks > 0)
+            processBlocks (state, d, numBlocks);
+
+        bufferSize = numBytes - numBlocks * 64;
+        memcpy (buffer, d + numBlocks * 64, bufferSize);
+    }
+
+    void finish (uint8_t* result) noexcept
+    {
+        uint8_t finalBlocks[128];
+        processBlocks (state, finalBlocks, createFinalBlocks (buffer, bufferSize, length, finalBlocks));
+        copyResult (state, result);
+    }
+
+    void processStream (InputStream& input, int64_t numBytesToRead, uint8_t* result)
+    {
+        HashingHelpers::processStream (input, numBytesToRead, [this] (const void* data, size_t numBytes)
+        {
+            process (data, numBytes);
+        });
+
+        finish (result);
+    }
+
+    bool processMappedFile (const File& file, uint8_t* result)
+    {
+        if (! HashingHelpers::processMappedFile (file, [this] (const void* data, size_t numBytes)
+                                                 {
+                                                     process (data, numBytes);
+                                                 }))
+            return false;
+
+        finish (result);
+        return true;
+    }
+
+    //==============================================================================
+    // Fills finalBlocks with the last (numBytes < 64) bytes of the message, followed by
+    // the padding and length, and returns the number of 64-byte blocks that this needs.
+    static size_t createFinalBlocks (const uint8_t* data, size_t numBytes, uint64_t totalLength, uint8_t (&finalBlocks)[128]) noexcept
+    {
+        jassert (numBytes < 64);
+
+        const auto numBlocks = numBytes < 56 ? (size_t) 1 : (size_t) 2;
+        const auto lengthInBits = totalLength * 8;
+
+        memcpy (finalBlocks, data, numBytes);
+        finalBlocks[numBytes] = 128; // append a '1' bit
+        memset (finalBlocks + numBytes + 1, 0, numBlocks * 64 - 8 - (numBytes + 1)); // pad with zeros..
+
+        for (int i = 0; i < 8; ++i)
+            finalBlocks[numBlocks * 64 - 1 - (size_t) i] = (uint8_t) (lengthInBits >> (i * 8)); // append the length.
+
+        return numBlocks;
+    }
 
-        for (auto& b : block)
+    static void copyResult (const uint32_t* s, uint8_t* result) noexcept
+    {
+        for (int i = 0; i < 8; ++i)
         {
-            b = (uint32_t (d[0]) << 24) | (uint32_t (d[1]) << 16) | (uint32_t (d[2]) << 8) | d[3];
-            d += 4;
+            *result++ = (uint8_t) (s[i] >> 24);
+            *result++ = (uint8_t) (s[i] >> 16);
+            *result++ = (uint8_t) (s[i] >> 8);
+            *result++ = (uint8_t) s[i];
         }
+    }
+
+    static void processBlocks (uint32_t* s, const uint8_t* data, size_t numBlocks) noexcept
+    {
+        static const auto blockFunction = getBestBlockFunction();
+        blockFunction (s, data, numBlocks);
+    }
+
+    //==============================================================================
+    static BlockFunction getBestBlockFunction() noexcept
+    {
+       #if JUCE_SHA256_USE_INTEL_INTRINSICS
+        if (hasSHAExtensions())
+            return processBlocksSHA;
+       #endif
+
+       #if JUCE_SHA256_USE_ARM_CRYPTO
+        if (hasARMCryptoExtensions())
+            return processBlocksARM;
+       #endif
+
+        return processBlocksScalar;
+    }
 
-        auto convolve = [&] (uint32_t i, uint32_t j)
+    static void processBlocksScalar (uint32_t* state, const uint8_t* d, size_t numBlocks) noexcept
+    {
+        for (; numBlocks > 0; --numBlocks)
         {
-            s[(7 - i) & 7] += S1 (s[(4 - i) & 7]) + ch (s[(4 - i) & 7], s[(5 - i) & 7], s[(6 - i) & 7]) + constants[i + j]
-                                 + (j != 0 ? (block[i & 15] += s1 (block[(i - 2) & 15]) + block[(i - 7) & 15] + s0 (block[(i - 15) & 15]))
-                                           : block[i]);
-            s[(3 - i) & 7] += s[(7 - i) & 7];
-            s[(7 - i) & 7] += S0 (s[(0 - i) & 7]) + maj (s[(0 - i) & 7], s[(1 - i) & 7], s[(2 - i) & 7]);
-        };
+            uint32_t block[16], s[8];
+            memcpy (s, state, sizeof (s));
 
-        for (uint32_t j = 0; j < 64; j += 16)
-            for (uint32_t i = 0; i < 16; ++i)
-                convolve (i, j);
+            for (auto& b : block)
+            {
+                b = (uint32_t (d[0]) << 24) | (uint32_t (d[1]) << 16) | (uint32_t (d[2]) << 8) | d[3];
+                d += 4;
+            }
 
-        for (int i = 0; i < 8; ++i)
-            state[i] += s[i];
+            auto convolve = [&] (uint32_t i, uint32_t j)
+            {
+                s[(7 - i) & 7] += S1 (s[(4 - i) & 7]) + ch (s[(4 - i) & 7], s[(5 - i) & 7], s[(6 - i) & 7]) + roundConstants[i + j]
+                                     + (j != 0 ? (block[i & 15] += s1 (block[(i - 2) & 15]) + block[(i - 7) & 15] + s0 (block[(i - 15) & 15]))
+                                               : block[i]);
+                s[(3 - i) & 7] += s[(7 - i) & 7];
+                s[(7 - i) & 7] += S0 (s[(0 - i) & 7]) + maj (s[(0 - i) & 7], s[(1 - i) & 7], s[(2 - i) & 7]);
+            };
+
+            for (uint32_t j = 0; j < 64; j += 16)
+                for (uint32_t i = 0; i < 16; ++i)
+                    convolve (i, j);
 
-        length += 64;
+            for (int i = 0; i < 8; ++i)
+                state[i] += s[i];
+        }
     }
 
-    void processFinalBlock (const void* data, uint32_t numBytes) noexcept
+   #if JUCE_SHA256_USE_INTEL_INTRINSICS
+    static bool hasSHAExtensions() noexcept
     {
-        jassert (numBytes < 64);
+        if (! (SystemStats::hasSSE41() && SystemStats::hasSSSE3()))
+            return false;
 
-        length += numBytes;
-        length *= 8; // (the length is stored as a count of bits, not bytes)
+       #if JUCE_MSVC
+        int info[4] = {};
+        __cpuid (info, 0);
 
-        uint8_t finalBlocks[128];
+        if (info[0] < 7)
+            return false;
 
-        memcpy (finalBlocks, data, numBytes);
-        finalBlocks[numBytes++] = 128; // append a '1' bit
+        __cpuidex (info, 7, 0);
+        const auto ebx = (unsigned int) info[1];
+       #else
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+        if (! __get_cpuid_count (7, 0, &eax, &ebx, &ecx, &edx))
+            return false;
+       #endif
+
+        return (ebx & (1u << 29)) != 0;
+    }
 
-        while (numBytes != 56 && numBytes < 64 + 56)
-            finalBlocks[numBytes++] = 0; // pad with zeros..
+    template <int i>
+    JUCE_SHA256_TARGET ("sha,sse4.1")
+    static forcedinline void doFourRoundsSHA (__m128i& abef, __m128i& cdgh, __m128i (&msg)[4]) noexcept
+    {
+        const auto wk = _mm_add_epi32 (msg[i & 3], _mm_load_si128 ((const __m128i*) (roundConstants + 4 * i)));
+        cdgh = _mm_sha256rnds2_epu32 (cdgh, abef, wk);
 
-        for (int i = 8; --i >= 0;)
-            finalBlocks[numBytes++] = (uint8_t) (length >> (i * 8)); // append the length.
+        if constexpr (i >= 3 && i < 15)
+        {
+            auto& next = msg[(i + 1) & 3];
+            next = _mm_sha256msg2_epu32 (_mm_add_epi32 (next, _mm_alignr_epi8 (msg[i & 3], msg[(i - 1) & 3], 4)), msg[i & 3]);
+        }
 
-        jassert (numBytes == 64 || numBytes == 128);
+        abef = _mm_sha256rnds2_epu32 (abef, cdgh, _mm_shuffle_epi32 (wk, 0x0e));
 
-        processFullBlock (finalBlocks);
+        if constexpr (i >= 1 && i < 13)
+            msg[(i - 1) & 3] = _mm_sha256msg1_epu32 (msg[(i - 1) & 3], msg[i & 3]);
+    }
 
-        if (numBytes > 64)
-            processFullBlock (finalBlocks + 64);
+    // (the rounds are unrolled like this so that the message words can stay in registers)
+    template <size_t... i>
+    JUCE_SHA256_TARGET ("sha,sse4.1")
+    static forcedinline void doFourRoundsSHA (__m128i& abef, __m128i& cdgh, __m128i (&msg)[4], std::index_sequence<i...>) noexcept
+    {
+        (doFourRoundsSHA<(int) i> (abef, cdgh, msg), ...);
     }
 
-    void copyResult (uint8_t* result) const noexcept
+    // Uses the x86 SHA extensions, which do two rounds per instruction. The state is
+    // kept in the ABEF/CDGH register layout that the instructions expect.
+    JUCE_SHA256_TARGET ("sha,sse4.1")
+    static void processBlocksSHA (uint32_t* state, const uint8_t* data, size_t numBlocks) noexcept
     {
-        for (auto s : state)
+        const auto byteSwapMask = _mm_set_epi64x (0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+
+        auto cdab = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i*) state), 0xb1);
+        auto cdgh = _mm_shuffle_epi32 (_mm_loadu_si128 ((const __m128i*) (state + 4)), 0x1b);
+        auto abef = _mm_alignr_epi8 (cdab, cdgh, 8);
+        cdgh = _mm_blend_epi16 (cdgh, cdab, 0xf0);
+
+        for (; numBlocks > 0; --numBlocks, data += 64)
         {
-            *result++ = (uint8_t) (s >> 24);
-            *result++ = (uint8_t) (s >> 16);
-            *result++ = (uint8_t) (s >> 8);
-            *result++ = (uint8_t) s;
+            const auto abefStart = abef, cdghStart = cdgh;
+            __m128i msg[4];
+
+            for (int i = 0; i < 4; ++i)
+                msg[i] = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i*) (data + 16 * i)), byteSwapMask);
+
+            doFourRoundsSHA (abef, cdgh, msg, std::make_index_sequence<16>());
+
+            abef = _mm_add_epi32 (abef, abefStart);
+            cdgh = _mm_add_epi32 (cdgh, cdghStart);
         }
+
+        const auto feba = _mm_shuffle_epi32 (abef, 0x1b);
+        const auto dchg = _mm_shuffle_epi32 (cdgh, 0xb1);
+
+        _mm_storeu_si128 ((__m128i*) state,       _mm_blend_epi16 (feba, dchg, 0xf0));
+        _mm_storeu_si128 ((__m128i*) (state + 4), _mm_alignr_epi8 (dchg, feba, 8));
     }
+   #endif
 
-    void processStream (InputStream& input, int64_t numBytesToRead, uint8_t* result)
+   #if JUCE_SHA256_USE_ARM_CRYPTO
+    static bool hasARMCryptoExtensions() noexcept
     {
-        if (numBytesToRead < 0)
-            numBytesToRead = std::numeric_limits<int64_t>::max();
+       #if JUCE_SHA256_ARM_CRYPTO_ALWAYS_AVAILABLE
+        return true;
+       #else
+        #ifndef HWCAP_SHA2
+         #define HWCAP_SHA2 (1 << 6)
+        #endif
 
-        for (;;)
+        return (getauxval (AT_HWCAP) & HWCAP_SHA2) != 0;
+       #endif
+    }
+
+    template <int i>
+   #if ! JUCE_SHA256_ARM_CRYPTO_ALWAYS_AVAILABLE
+    JUCE_SHA256_TARGET ("+crypto")
+   #endif
+    static forcedinline void doFourRoundsARM (uint32x4_t& abcd, uint32x4_t& efgh, uint32x4_t (&msg)[4]) noexcept
+    {
+        const auto wk = vaddq_u32 (msg[i & 3], vld1q_u32 (roundConstants + 4 * i));
+
+        if constexpr (i < 12)
+            msg[i & 3] = vsha256su1q_u32 (vsha256su0q_u32 (msg[i & 3], msg[(i + 1) & 3]), msg[(i + 2) & 3], msg[(i + 3) & 3]);
+
+        const auto abcdPrevious = abcd;
+        abcd = vsha256hq_u32 (abcd, efgh, wk);
+        efgh = vsha256h2q_u32 (efgh, abcdPrevious, wk);
+    }
+
+    template <size_t... i>
+   #if ! JUCE_SHA256_ARM_CRYPTO_ALWAYS_AVAILABLE
+    JUCE_SHA256_TARGET ("+crypto")
+   #endif
+    static forcedinline void doFourRoundsARM (uint32x4_t& abcd, uint32x4_t& efgh, uint32x4_t (&msg)[4], std::index_sequence<i...>) noexcept
+    {
+        (doFourRoundsARM<(int) i> (abcd, efgh, msg), ...);
+    }
+
+    // Uses the ARMv8 cryptography extensions, which do four rounds per instruction.
+   #if ! JUCE_SHA256_ARM_CRYPTO_ALWAYS_AVAILABLE
+    JUCE_SHA256_TARGET ("+crypto")
+   #endif
+    static void processBlocksARM (uint32_t* state, const uint8_t* data, size_t numBlocks) noexcept
+    {
+        auto abcd = vld1q_u32 (state);
+        auto efgh = vld1q_u32 (state + 4);
+
+        for (; numBlocks > 0; --numBlocks, data += 64)
         {
-            uint8_t buffer[64];
-            auto bytesRead = input.read (buffer, (int) jmin (numBytesToRead, (int64_t) sizeof (buffer)));
+            const auto abcdStart = abcd, efghStart = efgh;
+            uint32x4_t msg[4];
 
-            if (bytesRead < (int) sizeof (buffer))
-            {
-                processFinalBlock (buffer, (unsigned int) bytesRead);
-                break;
-            }
+            for (int i = 0; i < 4; ++i)
+                msg[i] = vreinterpretq_u32_u8 (vrev32q_u8 (vld1q_u8 (data + 16 * i)));
 
-            numBytesToRead -= (int64_t) sizeof (buffer);
-            processFullBlock (buffer);
+            doFourRoundsARM (abcd, efgh, msg, std::make_index_sequence<16>());
+
+            abcd = vaddq_u32 (abcd, abcdStart);
+            efgh = vaddq_u32 (efgh, efghStart);
         }
 
-        copyResult (result);
+        vst1q_u32 (state, abcd);
+        vst1q_u32 (state + 4, efgh);
     }
+   #endif
+
+    //==============================================================================
+    static constexpr uint32_t initialState[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                                  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+    alignas (16) static constexpr uint32_t roundConstants[64] =
+    {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
 
 private:
-    uint32_t state[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
-                          0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    uint32_t state[8] = { initialState[0], initialState[1], initialState[2], initialState[3],
+                          initialState[4], initialState[5], initialState[6], initialState[7] };
     uint64_t length = 0;
+    uint8_t buffer[64];
+    size_t bufferSize = 0;
 
     static uint32_t rotate (uint32_t x, uint32_t y) noexcept            { return (x >> y) | (x << (32 - y)); }
     static uint32_t ch  (uint32_t x, uint32_t y, uint32_t z) noexcept   { return z ^ ((y ^ z) & x); }
@@ -157,6 +386,380 @@ private:
     static uint32_t S1 (uint32_t x) noexcept     { return rotate (x, 6)  ^ rotate (x, 11) ^ rotate (x, 25); }
 };
 
+//==============================================================================
+// Hashes several independent messages at once, by running the same rounds on one block
+// from each message in the lanes of a SIMD register. When a message runs out of blocks,
+// its lane is given the next message in the list.
+struct SHA256MultiBufferProcessor
+{
+   #if JUCE_SHA256_USE_INTEL_INTRINSICS
+    static constexpr size_t numLanes = 8;
+
+    static bool isAvailable() noexcept
+    {
+        // The SHA extensions are quicker than running eight lanes of AVX2, so if they're
+        // available, it's better to use them to hash the messages one after another.
+        static const auto available = SystemStats::hasAVX2() && ! SHA256Processor::hasSHAExtensions();
+        return available;
+    }
+
+    template <int bits>
+    JUCE_SHA256_TARGET ("avx2")
+    static forcedinline __m256i rotate (__m256i x) noexcept    { return _mm256_or_si256 (_mm256_srli_epi32 (x, bits), _mm256_slli_epi32 (x, 32 - bits)); }
+
+    JUCE_SHA256_TARGET ("avx2")
+    static forcedinline __m256i add (__m256i a, __m256i b) noexcept   { return _mm256_add_epi32 (a, b); }
+
+    JUCE_SHA256_TARGET ("avx2")
+    static forcedinline __m256i loadWords (const uint8_t* const* blocks, int index) noexcept
+    {
+        auto word = [&] (int lane) { return (int) ByteOrder::bigEndianInt (blocks[lane] + 4 * index); };
+        return _mm256_setr_epi32 (word (0), word (1), word (2), word (3), word (4), word (5), word (6), word (7));
+    }
+
+    // This uses the same rotating indexes as the scalar code, so the working variables
+    // don't need to be moved along after each round.
+    template <int i>
+    JUCE_SHA256_TARGET ("avx2")
+    static forcedinline void doRound (__m256i (&v)[8], __m256i (&w)[16]) noexcept
+    {
+        if constexpr (i >= 16)
+        {
+            const auto w15 = w[(i - 15) & 15], w2 = w[(i - 2) & 15];
+            const auto s0 = _mm256_xor_si256 (_mm256_xor_si256 (rotate<7> (w15),  rotate<18> (w15)), _mm256_srli_epi32 (w15, 3));
+            const auto s1 = _mm256_xor_si256 (_mm256_xor_si256 (rotate<17> (w2), rotate<19> (w2)),  _mm256_srli_epi32 (w2, 10));
+            w[i & 15] = add (add (w[i & 15], s0), add (w[(i - 7) & 15], s1));
+        }
+
+        const auto a = v[(0 - i) & 7], b = v[(1 - i) & 7], c = v[(2 - i) & 7];
+        const auto e = v[(4 - i) & 7], f = v[(5 - i) & 7], g = v[(6 - i) & 7];
+        auto& d = v[(3 - i) & 7];
+        auto& h = v[(7 - i) & 7];
+
+        const auto S1 = _mm256_xor_si256 (_mm256_xor_si256 (rotate<6> (e), rotate<11> (e)), rotate<25> (e));
+        const auto ch = _mm256_xor_si256 (g, _mm256_and_si256 (e, _mm256_xor_si256 (f, g)));
+        const auto t1 = add (add (add (h, S1), add (ch, w[i & 15])), _mm256_set1_epi32 ((int) SHA256Processor::roundConstants[i]));
+
+        const auto S0 = _mm256_xor_si256 (_mm256_xor_si256 (rotate<2> (a), rotate<13> (a)), rotate<22> (a));
+        const auto maj = _mm256_xor_si256 (b, _mm256_and_si256 (_mm256_xor_si256 (b, c), _mm256_xor_si256 (a, b)));
+
+        d = add (d, t1);
+        h = add (t1, add (S0, maj));
+    }
+
+    template <size_t... i>
+    JUCE_SHA256_TARGET ("avx2")
+    static forcedinline void doRounds (__m256i (&v)[8], __m256i (&w)[16], std::index_sequence<i...>) noexcept
+    {
+        (doRound<(int) i> (v, w), ...);
+    }
+
+    // The state is stored with each of the eight words in a separate row, and each lane in a separate column.
+    JUCE_SHA256_TARGET ("avx2")
+    static void processBlocks (uint32_t (*state)[numLanes], const uint8_t* const* blocks) noexcept
+    {
+        __m256i w[16], v[8];
+
+        for (int i = 0; i < 16; ++i)
+            w[i] = loadWords (blocks, i);
+
+        for (int i = 0; i < 8; ++i)
+            v[i] = _mm256_load_si256 ((const __m256i*) state[i]);
+
+        doRounds (v, w, std::make_index_sequence<64>());
+
+        for (int i = 0; i < 8; ++i)
+            _mm256_store_si256 ((__m256i*) state[i], add (_mm256_load_si256 ((const __m256i*) state[i]), v[i]));
+    }
+
+    //==============================================================================
+    // Each lane is given its message in one or more parts, by a source that's asked
+    // for the next part whenever the lane has used up the previous one.
+    struct Lane
+    {
+        void start (size_t index) noexcept
+        {
+            inputIndex = index;
+            data = nullptr;
+            length = 0;
+            numBlocksLeft = numFinalBlocks = nextFinalBlock = 0;
+            active = true;
+        }
+
+        // The data must stay valid until the lane asks for more, and apart from the
+        // last part of the message, its size must be a multiple of the block size.
+        void addData (const uint8_t* newData, size_t numBytes, bool isLastPart) noexcept
+        {
+            jassert (isLastPart || (numBytes > 0 && numBytes % 64 == 0));
+
+            data = newData;
+            numBlocksLeft = numBytes / 64;
+            length += numBytes;
+
+            if (isLastPart)
+                numFinalBlocks = SHA256Processor::createFinalBlocks (data + numBlocksLeft * 64, numBytes % 64, length, finalBlocks);
+        }
+
+        bool needsData() const noexcept     { return numBlocksLeft == 0 && numFinalBlocks == 0; }
+
+        const uint8_t* getNextBlock() noexcept
+        {
+            if (numBlocksLeft == 0)
+                return finalBlocks + 64 * nextFinalBlock++;
+
+            --numBlocksLeft;
+            auto block = data;
+            data += 64;
+            return block;
+        }
+
+        bool isFinished() const noexcept    { return numBlocksLeft == 0 && numFinalBlocks > 0 && nextFinalBlock == numFinalBlocks; }
+
+        // Processes the rest of this lane's message on its own, without using the other lanes
+        template <typename GetMoreData>
+        void finishSingly (uint32_t* s, GetMoreData&& getMoreData)
+        {
+            for (;;)
+            {
+                SHA256Processor::processBlocks (s, data, numBlocksLeft);
+                numBlocksLeft = 0;
+
+                if (numFinalBlocks > 0)
+                    break;
+
+                getMoreData();
+            }
+
+            SHA256Processor::processBlocks (s, finalBlocks + 64 * nextFinalBlock, numFinalBlocks - nextFinalBlock);
+            nextFinalBlock = numFinalBlocks;
+        }
+
+        size_t inputIndex = 0;
+        const uint8_t* data = nullptr;
+        uint64_t length = 0;
+        size_t numBlocksLeft = 0, numFinalBlocks = 0, nextFinalBlock = 0;
+        uint8_t finalBlocks[128];
+        bool active = false;
+    };
+
+    // A Source has a size() method that returns the number of messages, an open() method that
+    // gives a lane the first part of the message it's been started with, or returns false if
+    // that message can't be read, and a readNext() method that gives a lane the next part.
+    template <typename Source>
+    static void processMessages (Source& source, uint8_t* const* results)
+    {
+        alignas (32) uint32_t state[8][numLanes];
+        Lane lanes[numLanes];
+        const auto numInputs = source.size();
+        size_t nextInput = 0;
+
+        auto copyLaneResult = [&] (size_t lane)
+        {
+            uint32_t s[8];
+
+            for (int i = 0; i < 8; ++i)
+                s[i] = state[i][lane];
+
+            lanes[lane].finishSingly (s, [&] { source.readNext (lane, lanes[lane]); });
+            SHA256Processor::copyResult (s, results[lanes[lane].inputIndex]);
+            lanes[lane].active = false;
+        };
+
+        auto startNextInput = [&] (size_t lane)
+        {
+            while (nextInput < numInputs)
+            {
+                const auto index = nextInput++;
+                lanes[lane].start (index);
+
+                if (source.open (lane, lanes[lane]))
+                {
+                    for (int i = 0; i < 8; ++i)
+                        state[i][lane] = SHA256Processor::initialState[i];
+
+                    return;
+                }
+
+                // (a message that can't be read is given an empty hash)
+                memset (results[index], 0, 32);
+                lanes[lane].active = false;
+            }
+        };
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+            startNextInput (lane);
+
+        static const uint8_t unusedBlock[64] = {};
+
+        for (;;)
+        {
+            size_t numActive = 0;
+
+            for (auto& lane : lanes)
+                if (lane.active)
+                    ++numActive;
+
+            // Once there's only one message left, it's quicker to finish it on its own
+            if (nextInput >= numInputs && numActive <= 1)
+            {
+                for (size_t lane = 0; lane < numLanes; ++lane)
+                    if (lanes[lane].active)
+                        copyLaneResult (lane);
+
+                break;
+            }
+
+            const uint8_t* blocks[numLanes];
+
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                if (lanes[lane].active && lanes[lane].needsData())
+                    source.readNext (lane, lanes[lane]);
+
+                blocks[lane] = lanes[lane].active ? lanes[lane].getNextBlock() : unusedBlock;
+            }
+
+            processBlocks (state, blocks);
+
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                if (lanes[lane].active && lanes[lane].isFinished())
+                {
+                    copyLaneResult (lane);
+                    startNextInput (lane);
+                }
+            }
+        }
+    }
+
+    static void process (Span<const Span<const std::byte>> inputs, uint8_t* const* results)
+    {
+        struct BlockSource
+        {
+            size_t size() const noexcept    { return blocks.size(); }
+
+            bool open (size_t, Lane& lane) const noexcept
+            {
+                const auto& block = blocks[lane.inputIndex];
+                lane.addData (reinterpret_cast<const uint8_t*> (block.data()), block.size(), true);
+                return true;
+            }
+
+            void readNext (size_t, Lane&) const noexcept    { jassertfalse; } // (each block is given to its lane in one part)
+
+            Span<const Span<const std::byte>> blocks;
+        };
+
+        BlockSource source { inputs };
+        processMessages (source, results);
+    }
+
+    // The files are read into a buffer for each lane, so that only a few of them need
+    // to be open at once, and large files don't need to be held in memory.
+    static void process (const Array<File>& files, uint8_t* const* results)
+    {
+        struct FileSource
+        {
+            explicit FileSource (const Array<File>& f) : files (f)
+            {
+                for (auto& b : buffers)
+                    b.malloc (HashingHelpers::readBufferSize);
+            }
+
+            size_t size() const noexcept    { return (size_t) files.size(); }
+
+            bool open (size_t laneIndex, Lane& lane)
+            {
+                auto& stream = streams[laneIndex];
+                stream = std::make_unique<FileInputStream> (files.getReference ((int) lane.inputIndex));
+
+                if (! stream->openedOk())
+                    return false;
+
+                stream->hintSequentialAccess();
+                readNext (laneIndex, lane);
+                return true;
+            }
+
+            void readNext (size_t laneIndex, Lane& lane)
+            {
+                auto& stream = *streams[laneIndex];
+                auto* buffer = buffers[laneIndex].get();
+                int numRead = 0;
+
+                // (the buffer has to be filled completely unless the end of the file has been reached)
+                while (numRead < HashingHelpers::readBufferSize)
+                {
+                    const auto n = stream.read (buffer + numRead, HashingHelpers::readBufferSize - numRead);
+
+                    if (n <= 0)
+                        break;
+
+                    numRead += n;
+                }
+
+                const auto isLastPart = numRead < HashingHelpers::readBufferSize;
+                lane.addData (buffer, (size_t) numRead, isLastPart);
+
+                if (isLastPart)
+                    streams[laneIndex].reset();
+            }
+
+            const Array<File>& files;
+            std::unique_ptr<FileInputStream> streams[numLanes];
+            HeapBlock<uint8_t> buffers[numLanes];
+        };
+
+        FileSource source (files);
+        processMessages (source, results);
+    }
+   #else
+    static bool isAvailable() noexcept   { return false; }
+    static void process (Span<const Span<const std::byte>>, uint8_t* const*) noexcept   { jassertfalse; }
+    static void process (const Array<File>&, uint8_t* const*) noexcept                   { jassertfalse; }
+   #endif
+
+    static void processAll (Span<const Span<const std::byte>> inputs, uint8_t* const* results)
+    {
+        if (inputs.size() > 1 && isAvailable())
+        {
+            process (inputs, results);
+            return;
+        }
+
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            SHA256Processor processor;
+            processor.process (inputs[i].data(), inputs[i].size());
+            processor.finish (results[i]);
+        }
+    }
+
+    static void processAll (const Array<File>& files, uint8_t* const* results)
+    {
+        if (files.size() > 1 && isAvailable())
+        {
+            process (files, results);
+            return;
+        }
+
+        for (int i = 0; i < files.size(); ++i)
+        {
+            FileInputStream fin (files.getReference (i));
+
+            if (fin.openedOk())
+            {
+                SHA256Processor processor;
+                processor.processStream (fin, -1, results[i]);
+            }
+            else
+            {
+                memset (results[i], 0, 32);
+            }
+        }
+    }
+};
+
 //==============================================================================
 SHA256::SHA256() = default;
 SHA256::~SHA256() = default;
@@ -194,6 +797,14 @@ SHA256::SHA256 (const File& file)
     }
 }
 
+SHA256 SHA256::fromMemoryMappedFile (const File& file)
+{
+    SHA256 hash;
+    SHA256Processor processor;
+    processor.processMappedFile (file, hash.result);
+    return hash;
+}
+
 SHA256::SHA256 (CharPointer_UTF8 utf8) noexcept
 {
     jassert (utf8.getAddress() != nullptr);
@@ -202,9 +813,37 @@ SHA256::SHA256 (CharPointer_UTF8 utf8) noexcept
 
 void SHA256::process (const void* data, size_t numBytes)
 {
-    MemoryInputStream m (data, numBytes, false);
     SHA256Processor processor;
-    processor.processStream (m, -1, result);
+    processor.process (data, numBytes);
+    processor.finish (result);
+}
+
+Array<SHA256> SHA256::calculateMultiple (Span<const Span<const std::byte>> blocks)
+{
+    Array<SHA256> hashes;
+    hashes.resize ((int) blocks.size());
+
+    std::vector<uint8_t*> results;
+
+    for (auto& h : hashes)
+        results.push_back (h.result);
+
+    SHA256MultiBufferProcessor::processAll (blocks, results.data());
+    return hashes;
+}
+
+Array<SHA256> SHA256::calculateMultiple (const Array<File>& files)
+{
+    Array<SHA256> hashes;
+    hashes.resize (files.size());
+
+    std::vector<uint8_t*> results;
+
+    for (auto& h : hashes)
+        results.push_back (h.result);
+
+    SHA256MultiBufferProcessor::processAll (files, results.data());
+    return hashes;
 }
 
 MemoryBlock SHA256::getRawData() const
@@ -251,13 +890,169 @@ public:
         }
     }
 
+    static MemoryBlock hashUsingScalarCode (const MemoryBlock& data)
+    {
+        uint32_t state[8];
+        memcpy (state, SHA256Processor::initialState, sizeof (state));
+
+        auto d = static_cast<const uint8_t*> (data.getData());
+        const auto numBlocks = data.getSize() / 64;
+        SHA256Processor::processBlocksScalar (state, d, numBlocks);
+
+        uint8_t finalBlocks[128];
+        SHA256Processor::processBlocksScalar (state, finalBlocks,
+                                              SHA256Processor::createFinalBlocks (d + numBlocks * 64, data.getSize() % 64,
+                                                                                  data.getSize(), finalBlocks));
+
+        MemoryBlock result (32);
+        SHA256Processor::copyResult (state, static_cast<uint8_t*> (result.getData()));
+        return result;
+    }
+
+    static MemoryBlock createRandomBlock (Random& r, size_t size)
+    {
+        MemoryBlock block (size);
+        r.fillBitsRandomly (block.getData(), size);
+        return block;
+    }
+
     void runTest() override
     {
         beginTest ("SHA256");
 
         test ("", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        test ("abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+        test ("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
         test ("The quick brown fox jumps over the lazy dog",  "d7a8fbb307d7809469ca9abcb0082e4f8d5651e46d3cdb762d02d0bf37c9e592");
         test ("The quick brown fox jumps over the lazy dog.", "ef537f25c895bfa782526529a9b63d97aa631564d5d789c2b765448c8635fb6c");
+
+        {
+            MemoryBlock million (1000000);
+            million.fillWith ('a');
+            expectEquals (SHA256 (million).toHexString(), String ("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+        }
+
+        auto r = getRandom();
+
+        beginTest ("Accelerated implementation matches scalar code");
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                const auto block = createRandomBlock (r, (size_t) (i < 150 ? i : r.nextInt (10000)));
+                const auto expected = hashUsingScalarCode (block);
+
+                expect (SHA256 (block).getRawData() == expected);
+
+                // feed the data through a stream that returns short reads
+                struct ShortReadStream final : public MemoryInputStream
+                {
+                    using MemoryInputStream::MemoryInputStream;
+                    int read (void* dest, int num) override  { return MemoryInputStream::read (dest, jmin (num, 37)); }
+                };
+
+                ShortReadStream stream (block, false);
+                expect (SHA256 (stream).getRawData() == expected);
+            }
+        }
+
+        beginTest ("Multiple blocks");
+        {
+            std::vector<MemoryBlock> blocks;
+
+            for (int i = 0; i < 43; ++i)
+                blocks.push_back (createRandomBlock (r, (size_t) (i % 5 == 0 ? r.nextInt (100000) : r.nextInt (300))));
+
+            std::vector<Span<const std::byte>> spans;
+
+            for (auto& b : blocks)
+                spans.emplace_back (static_cast<const std::byte*> (b.getData()), b.getSize());
+
+            const auto hashes = SHA256::calculateMultiple (spans);
+            expectEquals (hashes.size(), (int) blocks.size());
+
+            for (size_t i = 0; i < blocks.size(); ++i)
+                expect (hashes[(int) i].getRawData() == hashUsingScalarCode (blocks[i]));
+
+           #if JUCE_SHA256_USE_INTEL_INTRINSICS
+            // (check the multi-buffer code directly, because it's not used on machines with the SHA extensions)
+            if (SystemStats::hasAVX2())
+            {
+                std::vector<MemoryBlock> results (spans.size(), MemoryBlock (32));
+                std::vector<uint8_t*> resultPointers;
+
+                for (auto& result : results)
+                    resultPointers.push_back (static_cast<uint8_t*> (result.getData()));
+
+                SHA256MultiBufferProcessor::process (spans, resultPointers.data());
+
+                for (size_t i = 0; i < blocks.size(); ++i)
+                    expect (results[i] == hashes[(int) i].getRawData());
+            }
+           #endif
+        }
+
+        beginTest ("Files");
+        {
+            TemporaryFile tempFolder;
+            tempFolder.getFile().createDirectory();
+
+            Array<File> files;
+            std::vector<MemoryBlock> contents;
+
+            // (these include sizes that fill the multi-buffer code's read buffers exactly, and
+            // there are more files than lanes, so that some lanes are given more than one)
+            for (auto size : { 0, 1, 1000, 65536, 131072, 300000, 1234567, 7, 64, 100000, 65535, 65600 })
+            {
+                contents.push_back (createRandomBlock (r, (size_t) size));
+                files.add (tempFolder.getFile().getChildFile (String (size)));
+                files.getLast().create();
+                files.getLast().appendData (contents.back().getData(), contents.back().getSize());
+            }
+
+            files.add (tempFolder.getFile().getChildFile ("missing"));
+
+            const auto hashes = SHA256::calculateMultiple (files);
+
+            for (size_t i = 0; i < contents.size(); ++i)
+            {
+                const auto expected = hashUsingScalarCode (contents[i]);
+                expect (hashes[(int) i].getRawData() == expected);
+                expect (SHA256 (files[(int) i]).getRawData() == expected);
+                expect (SHA256::fromMemoryMappedFile (files[(int) i]).getRawData() == expected);
+                expect (MD5::fromMemoryMappedFile (files[(int) i]) == MD5 (files[(int) i]));
+                expect (Whirlpool::fromMemoryMappedFile (files[(int) i]) == Whirlpool (files[(int) i]));
+
+                // hash part of the file, starting part-way through
+                FileInputStream stream (files[(int) i]);
+                const auto start = jmin ((int64) 4097, stream.getTotalLength());
+                const auto length = (stream.getTotalLength() - start) / 2;
+                stream.setPosition (start);
+
+                expect (SHA256 (stream, length) == SHA256 (contents[i].begin() + start, (size_t) length));
+                expectEquals (stream.getPosition(), start + length);
+            }
+
+            expect (hashes.getLast() == SHA256());
+            expect (SHA256::fromMemoryMappedFile (files.getLast()) == SHA256());
+
+           #if JUCE_SHA256_USE_INTEL_INTRINSICS
+            if (SystemStats::hasAVX2())
+            {
+                std::vector<MemoryBlock> results ((size_t) files.size(), MemoryBlock (32));
+                std::vector<uint8_t*> resultPointers;
+
+                for (auto& result : results)
+                    resultPointers.push_back (static_cast<uint8_t*> (result.getData()));
+
+                SHA256MultiBufferProcessor::process (files, resultPointers.data());
+
+                for (int i = 0; i < files.size(); ++i)
+                    expect (results[(size_t) i] == hashes[i].getRawData());
+            }
+           #endif
+
+            tempFolder.getFile().deleteRecursively();
+        }
     }
 };
 
@@ -266,3 +1061,8 @@ static SHA256Tests sha256UnitTests;
 #endif
 
 } // namespace juce
+
+#undef JUCE_SHA256_USE_INTEL_INTRINSICS
+#undef JUCE_SHA256_USE_ARM_CRYPTO
+#undef JUCE_SHA256_ARM_CRYPTO_ALWAYS_AVAILABLE
+#undef JUCE_SHA256_TARGET
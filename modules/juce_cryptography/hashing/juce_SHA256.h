@@ -43,6 +43,10 @@ namespace juce
     calculates the SHA-256 hash of that data.
 
     You can retrieve the hash as a raw 32-byte block, or as a 64-digit hex string.
+
+    Where the CPU supports them, the hash is calculated using the x86 SHA extensions
+    or the ARMv8 cryptography extensions; these are detected at runtime.
+
     @see MD5
 
     @tags{Cryptography}
@@ -87,6 +91,20 @@ public:
     */
     explicit SHA256 (const File& file);
 
+    /** Generates the hash of a file's contents by memory-mapping it, instead of reading it
+        through a buffer as the constructor that takes a File does.
+
+        This avoids copying the file's data, so it can be quicker for large files, but it
+        must only be used on files that nothing else will modify while they're being hashed:
+        if another process truncates the file during this call, reading the pages that no
+        longer exist will crash this process (with a SIGBUS on POSIX systems, or an access
+        violation on Windows).
+
+        If the file can't be opened or mapped, the hash will be left uninitialised (i.e. full
+        of zeros).
+    */
+    static SHA256 fromMemoryMappedFile (const File& file);
+
     /** Creates a checksum from a UTF-8 buffer.
         E.g.
         @code SHA256 checksum (myString.toUTF8());
@@ -94,6 +112,24 @@ public:
     */
     explicit SHA256 (CharPointer_UTF8 utf8Text) noexcept;
 
+    //==============================================================================
+    /** Calculates the hashes of a set of independent blocks of data.
+
+        On CPUs that have AVX2 but not the SHA extensions, this hashes eight blocks at a
+        time using SIMD instructions, which is several times quicker than creating a
+        SHA256 for each one.
+        The array that is returned contains one hash for each block, in the same order.
+    */
+    static Array<SHA256> calculateMultiple (Span<const Span<const std::byte>> blocks);
+
+    /** Calculates the hashes of a set of files.
+
+        The files are read through a small buffer for each lane, and hashed in the same
+        way as calculateMultiple() does for blocks of data. If a file can't be opened,
+        its hash will be left uninitialised (i.e. full of zeros).
+    */
+    static Array<SHA256> calculateMultiple (const Array<File>& files);
+
     //==============================================================================
     /** Returns the hash as a 32-byte block of data. */
     MemoryBlock getRawData() const;
@@ -41,26 +41,30 @@ struct WhirlpoolProcessor
 
     void processStream (InputStream& input, int64_t numBytesToRead, uint8_t* result)
     {
-        if (numBytesToRead < 0)
-            numBytesToRead = std::numeric_limits<int64_t>::max();
-
-        for (;;)
+        HashingHelpers::processStream (input, numBytesToRead, [this] (const void* data, size_t numBytes)
         {
-            uint8_t data[64];
-            auto bytesRead = input.read (data, (int) jmin (numBytesToRead, (int64_t) sizeof (data)));
-
-            if (bytesRead < 0)
-                break;
+            add (static_cast<const uint8_t*> (data), numBytes);
+        });
 
-            add (data, bytesRead * 8);
+        finalize (result);
+    }
 
-            if (bytesRead < (int) sizeof (data))
-                break;
+    void process (const void* data, size_t numBytes, uint8_t* result) noexcept
+    {
+        add (static_cast<const uint8_t*> (data), numBytes);
+        finalize (result);
+    }
 
-            numBytesToRead -= (int64_t) sizeof (data);
-        }
+    bool processMappedFile (const File& file, uint8_t* result)
+    {
+        if (! HashingHelpers::processMappedFile (file, [this] (const void* data, size_t numBytes)
+                                                 {
+                                                     add (static_cast<const uint8_t*> (data), numBytes);
+                                                 }))
+            return false;
 
         finalize (result);
+        return true;
     }
 
     uint8_t bitLength[32] = {};
@@ -69,73 +73,39 @@ struct WhirlpoolProcessor
     uint64_t hash[8] = {};
 
 private:
-    void add (const uint8_t* source, int numBits) noexcept
+    void add (const uint8_t* source, size_t numBytes) noexcept
     {
-        int sourcePos = 0;                        // index of leftmost source uint8_t containing data (1 to 8 bits)
-        int sourceGap = (8 - (numBits & 7)) & 7;  // space on source[sourcePos]
-        int bufferRem = bufferBits & 7;           // occupied bits on buffer[bufferPos]
-
-        uint64_t value = (uint64_t) numBits, carry = 0;
-
-        for (int i = 32; --i >= 0 && (carry != 0 || value != 0);)
-        {
-            carry += bitLength[i] + ((uint32) value & 0xff);
-            bitLength[i] = (uint8_t) carry;
-            carry >>= 8;
-            value >>= 8;
-        }
+        addToBitLength ((uint64_t) numBytes * 8);
 
-        uint32 b = 0;
-
-        while (numBits > 8)
+        while (numBytes > 0)
         {
-            b = ((source[sourcePos] << sourceGap) & 0xff)
-                  | (uint32) ((source[sourcePos + 1] & 0xff) >> (8 - sourceGap));
-
-            buffer[bufferPos++] |= (uint8_t) (b >> bufferRem);
-            bufferBits += 8 - bufferRem;
-
-            if (bufferBits == 64 * 8)
+            const auto numToCopy = jmin (numBytes, (size_t) (64 - bufferPos));
+            memcpy (buffer + bufferPos, source, numToCopy);
+            source += numToCopy;
+            numBytes -= numToCopy;
+            bufferPos += (int) numToCopy;
+            bufferBits += (int) numToCopy * 8;
+
+            if (bufferPos == 64)
             {
                 processNextBuffer();
                 bufferBits = bufferPos = 0;
             }
-
-            buffer[bufferPos] = static_cast<uint8_t> (b << (8 - bufferRem));
-            bufferBits += bufferRem;
-
-            numBits -= 8;
-            ++sourcePos;
         }
 
-        if (numBits > 0)
-        {
-            b = (source[sourcePos] << sourceGap) & 0xff;
-            buffer[bufferPos] = static_cast<uint8_t> (buffer[bufferPos] | (b >> bufferRem));
-        }
-        else
-        {
-            b = 0;
-        }
-
-        if (bufferRem + numBits < 8)
-        {
-            bufferBits += numBits;
-        }
-        else
-        {
-            ++bufferPos;
-            bufferBits += 8 - bufferRem;
-            numBits    -= 8 - bufferRem;
+        buffer[bufferPos] = 0; // (finalize() expects the next byte of the buffer to be clear)
+    }
 
-            if (bufferBits == 64 * 8)
-            {
-                processNextBuffer();
-                bufferBits = bufferPos = 0;
-            }
+    void addToBitLength (uint64_t value) noexcept
+    {
+        uint64_t carry = 0;
 
-            buffer[bufferPos] = static_cast<uint8_t> (b << (8 - bufferRem));
-            bufferBits += numBits;
+        for (int i = 32; --i >= 0 && (carry != 0 || value != 0);)
+        {
+            carry += bitLength[i] + ((uint32) value & 0xff);
+            bitLength[i] = (uint8_t) carry;
+            carry >>= 8;
+            value >>= 8;
         }
     }
 
@@ -600,11 +570,18 @@ Whirlpool::Whirlpool (CharPointer_UTF8 utf8) noexcept
     process (utf8.getAddress(), utf8.sizeInBytes() - 1);
 }
 
+Whirlpool Whirlpool::fromMemoryMappedFile (const File& file)
+{
+    Whirlpool w;
+    WhirlpoolProcessor processor;
+    processor.processMappedFile (file, w.result);
+    return w;
+}
+
 void Whirlpool::process (const void* data, size_t numBytes)
 {
-    MemoryInputStream m (data, numBytes, false);
     WhirlpoolProcessor processor;
-    processor.processStream (m, -1, result);
+    processor.process (data, numBytes, result);
 }
 
 MemoryBlock Whirlpool::getRawData() const
@@ -93,6 +93,15 @@ public:
     */
     explicit Whirlpool (const File& file);
 
+    /** Generates the hash of a file by memory-mapping it, rather than reading it
+        through a buffer.
+
+        This has the same risk as SHA256::fromMemoryMappedFile(): if the file is
+        truncated while it's being hashed, this process will crash. If the file can't
+        be mapped, the hash will be left uninitialised (i.e. full of zeros).
+    */
+    static Whirlpool fromMemoryMappedFile (const File& file);
+
     /** Creates a checksum from a UTF-8 buffer.
         E.g.
         @code Whirlpool checksum (myString.toUTF8());
@@ -43,6 +43,28 @@
 
 #include "juce_cryptography.h"
 
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <cpuid.h>
+ #endif
+
+ #include <immintrin.h>
+#elif JUCE_ARM && JUCE_64BIT
+ #if JUCE_WINDOWS
+  #include <arm64_neon.h>
+ #else
+  #include <arm_neon.h>
+ #endif
+
+ #if JUCE_LINUX || JUCE_ANDROID
+  #include <sys/auxv.h>
+ #endif
+#endif
+
+#include "hashing/juce_HashingHelpers.h"
+
 #include "encryption/juce_BlowFish.cpp"
 #include "encryption/juce_Primes.cpp"
 #include "encryption/juce_RSAKey.cpp"
@@ -101,12 +101,15 @@ private:
 struct ChildProcessCoordinator::Connection final : public InterprocessConnection,
                                                    private ChildProcessPingThread
 {
-    Connection (ChildProcessCoordinator& m, const String& pipeName, int timeout)
+    Connection (ChildProcessCoordinator& m, const String& pipeName, int timeout, int sharedMemoryBufferSize)
         : InterprocessConnection (false, magicCoordWorkerConnectionHeader),
           ChildProcessPingThread (timeout),
           owner (m)
     {
-        createPipe (pipeName, timeoutMs);
+        if (sharedMemoryBufferSize > 0)
+            createSharedMemoryPipe (pipeName, sharedMemoryBufferSize, timeoutMs, true);
+        else
+            createPipe (pipeName, timeoutMs);
     }
 
     ~Connection() override
@@ -163,12 +166,35 @@ bool ChildProcessCoordinator::sendMessageToWorker (const MemoryBlock& mb)
     return false;
 }
 
+void ChildProcessCoordinator::setSharedMemoryBufferSize (int bufferSizeBytes)
+{
+    sharedMemoryBufferSize = jmax (0, bufferSizeBytes);
+}
+
 bool ChildProcessCoordinator::launchWorkerProcess (const File& executable, const String& commandLineUniqueID,
                                                    int timeoutMs, int streamFlags)
 {
     killWorkerProcess();
 
-    auto pipeName = "p" + String::toHexString (Random().nextInt64());
+    const auto pipeID = String::toHexString (Random().nextInt64());
+    timeoutMs = timeoutMs <= 0 ? defaultTimeoutMs : timeoutMs;
+
+    // A shared-memory pipe must exist before the worker starts, as it won't wait for it.
+    // If one can't be created (e.g. on Android, which has no named shared memory), this
+    // falls back to using a NamedPipe.
+    if (sharedMemoryBufferSize > 0)
+    {
+        connection.reset (new Connection (*this, "m" + pipeID, timeoutMs, sharedMemoryBufferSize));
+
+        if (! connection->isConnected())
+        {
+            DBG ("Couldn't create a shared memory pipe for the worker, so using a named pipe instead");
+            connection.reset();
+        }
+    }
+
+    // (the worker uses the first letter of the name to tell which kind of pipe to open)
+    const auto pipeName = (connection != nullptr ? "m" : "p") + pipeID;
 
     StringArray args;
     args.add (executable.getFullPathName());
@@ -189,7 +215,8 @@ bool ChildProcessCoordinator::launchWorkerProcess (const File& executable, const
 
     if (childProcess != nullptr)
     {
-        connection.reset (new Connection (*this, pipeName, timeoutMs <= 0 ? defaultTimeoutMs : timeoutMs));
+        if (connection == nullptr)
+            connection.reset (new Connection (*this, pipeName, timeoutMs, 0));
 
         if (connection->isConnected())
         {
@@ -197,10 +224,9 @@ bool ChildProcessCoordinator::launchWorkerProcess (const File& executable, const
             sendMessageToWorker ({ startMessage, specialMessageSize });
             return true;
         }
-
-        connection.reset();
     }
 
+    connection.reset();
     return false;
 }
 
@@ -225,7 +251,10 @@ struct ChildProcessWorker::Connection final : public InterprocessConnection,
           ChildProcessPingThread (timeout),
           owner (p)
     {
-        connectToPipe (pipeName, timeoutMs);
+        if (pipeName.startsWithChar ('m'))
+            connectToSharedMemoryPipe (pipeName, timeoutMs);
+        else
+            connectToPipe (pipeName, timeoutMs);
     }
 
     ~Connection() override
@@ -186,6 +186,16 @@ public:
                               int timeoutMs = 0,
                               int streamFlags = ChildProcess::wantStdOut | ChildProcess::wantStdErr);
 
+    /** Makes launchWorkerProcess() connect to the worker through a SharedMemoryPipe
+        with buffers of this size, rather than a NamedPipe. This makes sending lots of
+        messages much cheaper, and the worker doesn't need to do anything differently.
+
+        Passing 0 goes back to using a NamedPipe, which is the default. A NamedPipe is
+        also used if the shared memory can't be created, e.g. on Android, which doesn't
+        support it.
+    */
+    void setSharedMemoryBufferSize (int bufferSizeBytes);
+
     [[deprecated ("Replaced by launchWorkerProcess.")]]
     bool launchSlaveProcess (const File& executableToLaunch,
                              const String& commandLineUniqueID,
@@ -228,6 +238,7 @@ public:
 
 private:
     std::shared_ptr<ChildProcess> childProcess;
+    int sharedMemoryBufferSize = 0;
 
     struct Connection;
     std::unique_ptr<Connection> connection;
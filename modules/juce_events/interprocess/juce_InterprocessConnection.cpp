@@ -157,14 +157,50 @@ bool InterprocessConnection::createPipe (const String& pipeName, int timeoutMs,
     return false;
 }
 
+bool InterprocessConnection::createSharedMemoryPipe (const String& pipeName, int bufferSizeBytes,
+                                                     int sendMessageTimeoutMs, bool mustNotExist)
+{
+    disconnect();
+
+    auto newPipe = std::make_unique<SharedMemoryPipe>();
+
+    if (newPipe->createNewPipe (pipeName, bufferSizeBytes, mustNotExist))
+    {
+        const ScopedWriteLock sl (pipeAndSocketLock);
+        pipeReceiveMessageTimeout = sendMessageTimeoutMs;
+        initialiseWithSharedMemoryPipe (std::move (newPipe));
+        return true;
+    }
+
+    return false;
+}
+
+bool InterprocessConnection::connectToSharedMemoryPipe (const String& pipeName, int sendMessageTimeoutMs)
+{
+    disconnect();
+
+    auto newPipe = std::make_unique<SharedMemoryPipe>();
+
+    if (newPipe->openExisting (pipeName))
+    {
+        const ScopedWriteLock sl (pipeAndSocketLock);
+        pipeReceiveMessageTimeout = sendMessageTimeoutMs;
+        initialiseWithSharedMemoryPipe (std::move (newPipe));
+        return true;
+    }
+
+    return false;
+}
+
 void InterprocessConnection::disconnect (int timeoutMs, Notify notify)
 {
     thread->signalThreadShouldExit();
 
     {
         const ScopedReadLock sl (pipeAndSocketLock);
-        if (socket != nullptr)  socket->close();
-        if (pipe != nullptr)    pipe->close();
+        if (socket != nullptr)              socket->close();
+        if (pipe != nullptr)                pipe->close();
+        if (sharedMemoryPipe != nullptr)    sharedMemoryPipe->close();
     }
 
     thread->stopThread (timeoutMs);
@@ -182,6 +218,7 @@ void InterprocessConnection::deletePipeAndSocket()
     const ScopedWriteLock sl (pipeAndSocketLock);
     socket.reset();
     pipe.reset();
+    sharedMemoryPipe.reset();
 }
 
 bool InterprocessConnection::isConnected() const
@@ -189,7 +226,8 @@ bool InterprocessConnection::isConnected() const
     const ScopedReadLock sl (pipeAndSocketLock);
 
     return ((socket != nullptr && socket->isConnected())
-              || (pipe != nullptr && pipe->isOpen()))
+              || (pipe != nullptr && pipe->isOpen())
+              || (sharedMemoryPipe != nullptr && sharedMemoryPipe->isOpen()))
             && threadIsRunning;
 }
 
@@ -198,7 +236,7 @@ String InterprocessConnection::getConnectedHostName() const
     {
         const ScopedReadLock sl (pipeAndSocketLock);
 
-        if (pipe == nullptr && socket == nullptr)
+        if (pipe == nullptr && socket == nullptr && sharedMemoryPipe == nullptr)
             return {};
 
         if (socket != nullptr && ! socket->isLocal())
@@ -211,6 +249,14 @@ String InterprocessConnection::getConnectedHostName() const
 //==============================================================================
 bool InterprocessConnection::sendMessage (const MemoryBlock& message)
 {
+    {
+        // (a shared-memory pipe keeps messages separate itself, so needs no header)
+        const ScopedReadLock sl (pipeAndSocketLock);
+
+        if (sharedMemoryPipe != nullptr)
+            return sharedMemoryPipe->write (message.getData(), message.getSize(), pipeReceiveMessageTimeout);
+    }
+
     uint32 messageHeader[2] = { ByteOrder::swapIfBigEndian (magicMessageHeader),
                                 ByteOrder::swapIfBigEndian ((uint32) message.getSize()) };
 
@@ -245,18 +291,25 @@ void InterprocessConnection::initialise()
 
 void InterprocessConnection::initialiseWithSocket (std::unique_ptr<StreamingSocket> newSocket)
 {
-    jassert (socket == nullptr && pipe == nullptr);
+    jassert (socket == nullptr && pipe == nullptr && sharedMemoryPipe == nullptr);
     socket = std::move (newSocket);
     initialise();
 }
 
 void InterprocessConnection::initialiseWithPipe (std::unique_ptr<NamedPipe> newPipe)
 {
-    jassert (socket == nullptr && pipe == nullptr);
+    jassert (socket == nullptr && pipe == nullptr && sharedMemoryPipe == nullptr);
     pipe = std::move (newPipe);
     initialise();
 }
 
+void InterprocessConnection::initialiseWithSharedMemoryPipe (std::unique_ptr<SharedMemoryPipe> newPipe)
+{
+    jassert (socket == nullptr && pipe == nullptr && sharedMemoryPipe == nullptr);
+    sharedMemoryPipe = std::move (newPipe);
+    initialise();
+}
+
 //==============================================================================
 struct ConnectionStateMessage final : public MessageManager::MessageBase
 {
@@ -335,6 +388,21 @@ void InterprocessConnection::deliverDataInt (const MemoryBlock& data)
         messageReceived (data);
 }
 
+void InterprocessConnection::deliverDataInt (Span<const std::byte> data)
+{
+    jassert (callbackConnectionState);
+
+    if (useMessageThread)
+        (new DataDeliveryMessage (safeAction, MemoryBlock (data.data(), data.size())))->post();
+    else
+        messageViewReceived (data);
+}
+
+void InterprocessConnection::messageViewReceived (Span<const std::byte> message)
+{
+    messageReceived (MemoryBlock (message.data(), message.size()));
+}
+
 //==============================================================================
 int InterprocessConnection::readData (void* data, int num)
 {
@@ -428,6 +496,19 @@ void InterprocessConnection::runThread()
                 break;
             }
         }
+        else if (sharedMemoryPipe != nullptr)
+        {
+            const auto result = sharedMemoryPipe->read ([this] (Span<const std::byte> message) { deliverDataInt (message); }, 100);
+
+            if (result == SharedMemoryPipe::ReadResult::closed && ! thread->threadShouldExit())
+            {
+                deletePipeAndSocket();
+                connectionLostInt();
+                break;
+            }
+
+            continue;
+        }
         else
         {
             break;
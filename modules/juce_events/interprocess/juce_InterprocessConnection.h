@@ -42,15 +42,15 @@ class MemoryBlock;
 //==============================================================================
 /**
     Manages a simple two-way messaging connection to another process, using either
-    a socket or a named pipe as the transport medium.
+    a socket, a named pipe or a shared-memory pipe as the transport medium.
 
-    To connect to a waiting socket or an open pipe, use the connectToSocket() or
-    connectToPipe() methods. If this succeeds, messages can be sent to the other end,
-    and incoming messages will result in a callback via the messageReceived()
-    method.
+    To connect to a waiting socket or an open pipe, use the connectToSocket(),
+    connectToPipe() or connectToSharedMemoryPipe() methods. If this succeeds, messages
+    can be sent to the other end, and incoming messages will result in a callback via
+    the messageReceived() method.
 
     To open a pipe and wait for another client to connect to it, use the createPipe()
-    method.
+    or createSharedMemoryPipe() method.
 
     To act as a socket server and create connections for one or more client, see the
     InterprocessConnectionServer class.
@@ -132,6 +132,36 @@ public:
     */
     bool createPipe (const String& pipeName, int pipeReceiveMessageTimeoutMs, bool mustNotExist = false);
 
+    /** Tries to create a new SharedMemoryPipe for another process on the same machine
+        to connect to.
+
+        This is much faster than a named pipe for sending lots of messages. The other
+        process must use connectToSharedMemoryPipe() to connect to it.
+
+        @param pipeName         the name to use for the pipe - this should be unique to your app
+        @param bufferSizeBytes  the size of the buffer for each direction. Sending a message
+                                waits if the buffer is full.
+        @param sendMessageTimeoutMs  the longest time that sendMessage() will wait for space,
+                                or -1 to wait indefinitely
+        @param mustNotExist     if set to true, the method will fail if the pipe already exists
+        @returns true if the pipe was created. This always fails on Android, which doesn't
+                 support named shared memory, so there you'll need to fall back to using
+                 createPipe() or a socket instead.
+        @see SharedMemoryPipe
+    */
+    bool createSharedMemoryPipe (const String& pipeName, int bufferSizeBytes,
+                                 int sendMessageTimeoutMs, bool mustNotExist = false);
+
+    /** Tries to connect to a SharedMemoryPipe that another process has created with
+        createSharedMemoryPipe().
+
+        @param pipeName                 the name of the pipe
+        @param sendMessageTimeoutMs     the longest time that sendMessage() will wait for
+                                        space, or -1 to wait indefinitely
+        @returns true if it connects successfully.
+    */
+    bool connectToSharedMemoryPipe (const String& pipeName, int sendMessageTimeoutMs);
+
     /** Whether the disconnect call should trigger callbacks. */
     enum class Notify { no, yes };
 
@@ -154,6 +184,9 @@ public:
     /** Returns the pipe that this connection is using (or nullptr if it uses a socket). */
     NamedPipe* getPipe() const noexcept                         { return pipe.get(); }
 
+    /** Returns the shared-memory pipe that this connection is using, if it uses one. */
+    SharedMemoryPipe* getSharedMemoryPipe() const noexcept      { return sharedMemoryPipe.get(); }
+
     /** Returns the name of the machine at the other end of this connection.
         This may return an empty string if the name is unknown.
     */
@@ -200,12 +233,22 @@ public:
     */
     virtual void messageReceived (const MemoryBlock& message) = 0;
 
+    /** Called when a message arrives through a shared-memory pipe, if the connection
+        wasn't created with the callbacksOnMessageThread flag set.
+
+        The data is still in the pipe's buffer, and is only valid until this returns.
+        Overriding this lets you avoid copying it; the default implementation copies
+        it into a MemoryBlock and calls messageReceived().
+    */
+    virtual void messageViewReceived (Span<const std::byte> message);
+
 
 private:
     //==============================================================================
     ReadWriteLock pipeAndSocketLock;
     std::unique_ptr<StreamingSocket> socket;
     std::unique_ptr<NamedPipe> pipe;
+    std::unique_ptr<SharedMemoryPipe> sharedMemoryPipe;
     bool callbackConnectionState = false;
     const bool useMessageThread;
     const uint32 magicMessageHeader;
@@ -215,10 +258,12 @@ private:
     void initialise();
     void initialiseWithSocket (std::unique_ptr<StreamingSocket>);
     void initialiseWithPipe (std::unique_ptr<NamedPipe>);
+    void initialiseWithSharedMemoryPipe (std::unique_ptr<SharedMemoryPipe>);
     void deletePipeAndSocket();
     void connectionMadeInt();
     void connectionLostInt();
     void deliverDataInt (const MemoryBlock&);
+    void deliverDataInt (Span<const std::byte>);
     bool readNextMessage();
     int readData (void*, int);
 
@@ -37,7 +37,8 @@ namespace juce
 
 LowLevelGraphicsSoftwareRenderer::LowLevelGraphicsSoftwareRenderer (const Image& image)
     : RenderingHelpers::StackBasedLowLevelGraphicsContext<RenderingHelpers::SoftwareRendererSavedState>
-        (new RenderingHelpers::SoftwareRendererSavedState (image, image.getBounds()))
+        (new RenderingHelpers::SoftwareRendererSavedState (image, image.getBounds())),
+      target (image.getPixelData())
 {
     JUCE_TRACE_LOG_PAINT_CALL (etw::startGDIImage, getFrameId());
 }
@@ -45,15 +46,20 @@ LowLevelGraphicsSoftwareRenderer::LowLevelGraphicsSoftwareRenderer (const Image&
 LowLevelGraphicsSoftwareRenderer::LowLevelGraphicsSoftwareRenderer (const Image& image, Point<int> origin,
                                                                     const RectangleList<int>& initialClip)
     : RenderingHelpers::StackBasedLowLevelGraphicsContext<RenderingHelpers::SoftwareRendererSavedState>
-        (new RenderingHelpers::SoftwareRendererSavedState (image, initialClip, origin))
+        (new RenderingHelpers::SoftwareRendererSavedState (image, initialClip, origin)),
+      target (image.getPixelData())
 {
-
     JUCE_TRACE_EVENT_INT_RECT_LIST (etw::startGDIFrame, etw::softwareRendererKeyword, getFrameId(), initialClip);
 }
 
 LowLevelGraphicsSoftwareRenderer::~LowLevelGraphicsSoftwareRenderer()
 {
     JUCE_TRACE_LOG_PAINT_CALL (etw::endGDIFrame, getFrameId());
+
+    // Anything drawn from the image while we were still drawing into it may have cached a
+    // half-finished copy
+    if (target != nullptr)
+        target->discardReducedImages();
 }
 
 } // namespace juce
@@ -60,6 +60,8 @@ public:
     ~LowLevelGraphicsSoftwareRenderer() override;
 
 private:
+    const ImagePixelData::Ptr target;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowLevelGraphicsSoftwareRenderer)
 };
 
@@ -250,6 +250,12 @@ public:
 
     std::unique_ptr<ImageType> createType() const override { return sourceImage->createType(); }
 
+    /* writes made through the source image aren't reported to us, so a cached copy could go stale */
+    Image getReducedImage (int) override { return {}; }
+
+    /* our pixels belong to the source image, so it's the source's copies that are now out of date */
+    void discardReducedImages() override { sourceImage->discardReducedImages(); }
+
     /* as we always hold a reference to image, don't double count */
     int getSharedCount() const noexcept override { return getReferenceCount() + sourceImage->getSharedCount() - 1; }
 
@@ -276,6 +282,7 @@ ImagePixelData::~ImagePixelData()
 
 void ImagePixelData::sendDataChangeMessage()
 {
+    discardReducedImages();
     listeners.call ([this] (Listener& l) { l.imageDataChanged (this); });
 }
 
@@ -294,6 +301,98 @@ void ImagePixelData::applySingleChannelBoxBlurEffect ([[maybe_unused]] int radiu
     result = {};
 }
 
+template <int pixelStride>
+static void averagePixelBlocks (const Image::BitmapData& src, Image::BitmapData& dest)
+{
+    const auto lastX = src.width - 1;
+    const auto lastY = src.height - 1;
+
+    // Pixels on the right of an odd-width image have no neighbour to pair with
+    const auto numPairs = src.width / 2;
+
+    // Each channel is a single byte and ARGB is premultiplied, so the channels can all
+    // be averaged independently of each other
+    for (int y = 0; y < dest.height; ++y)
+    {
+        const auto* row0 = src.getLinePointer (y * 2);
+        const auto* row1 = src.getLinePointer (jmin (y * 2 + 1, lastY));
+        auto* out = dest.getLinePointer (y);
+
+        for (int x = 0; x < numPairs; ++x)
+        {
+            const auto* a = row0 + x * 2 * pixelStride;
+            const auto* b = row1 + x * 2 * pixelStride;
+
+            for (int c = 0; c < pixelStride; ++c)
+                out[x * pixelStride + c] = (uint8) ((a[c] + a[c + pixelStride] + b[c] + b[c + pixelStride] + 2) >> 2);
+        }
+
+        if (numPairs < dest.width)
+        {
+            const auto* a = row0 + lastX * pixelStride;
+            const auto* b = row1 + lastX * pixelStride;
+
+            for (int c = 0; c < pixelStride; ++c)
+                out[numPairs * pixelStride + c] = (uint8) ((a[c] + b[c] + 1) >> 1);
+        }
+    }
+}
+
+static Image createHalfSizeImage (const Image& source)
+{
+    const auto input = SoftwareImageType().convert (source);
+    Image result (input.getFormat(), (input.getWidth() + 1) / 2, (input.getHeight() + 1) / 2, false, SoftwareImageType());
+
+    const Image::BitmapData src (input, Image::BitmapData::readOnly);
+    Image::BitmapData dest (result, Image::BitmapData::writeOnly);
+
+    switch (src.pixelStride)
+    {
+        case 4:     averagePixelBlocks<4> (src, dest); break;
+        case 3:     averagePixelBlocks<3> (src, dest); break;
+        case 1:     averagePixelBlocks<1> (src, dest); break;
+        default:    jassertfalse; break;
+    }
+
+    return result;
+}
+
+Image ImagePixelData::getReducedImage (int level)
+{
+    jassert (getReferenceCount() > 0); // (This method can't be used on an unowned pointer, as it will end up self-deleting)
+
+    if (level <= 0)
+        return Image (*this);
+
+    const ScopedLock sl (reducedImageLock);
+
+    // (set before any copies are made, so that a discard which starts meanwhile can't miss them)
+    hasReducedImages = true;
+
+    while (reducedImages.size() < level)
+    {
+        auto previous = reducedImages.isEmpty() ? Image (*this) : reducedImages.getLast();
+
+        if (previous.getWidth() == 1 && previous.getHeight() == 1)
+            return previous;
+
+        reducedImages.add (createHalfSizeImage (previous));
+    }
+
+    return reducedImages[level - 1];
+}
+
+void ImagePixelData::discardReducedImages()
+{
+    // This happens after every write, so it needs to be cheap when there's nothing to discard
+    if (! hasReducedImages)
+        return;
+
+    const ScopedLock sl (reducedImageLock);
+    reducedImages.clear();
+    hasReducedImages = false;
+}
+
 //==============================================================================
 ImageType::ImageType() = default;
 ImageType::~ImageType() = default;
@@ -497,6 +596,26 @@ Image Image::rescaled (int newWidth, int newHeight, Graphics::ResamplingQuality
     return newImage;
 }
 
+static bool isSoftwareImage (const Image& image)
+{
+    return image.getPixelData()->createType()->getTypeID() == SoftwareImageType().getTypeID();
+}
+
+template <class DestPixelType, class SrcPixelType>
+static void convertLines (const Image::BitmapData& srcData, const Image::BitmapData& destData)
+{
+    jassert (srcData.pixelStride == (int) sizeof (SrcPixelType) && destData.pixelStride == (int) sizeof (DestPixelType));
+
+    for (int y = 0; y < destData.height; ++y)
+    {
+        auto src = reinterpret_cast<const SrcPixelType*> (srcData.getLinePointer (y));
+        auto dst = reinterpret_cast<DestPixelType*> (destData.getLinePointer (y));
+
+        for (int x = 0; x < destData.width; ++x)
+            dst[x].set (src[x]);
+    }
+}
+
 Image Image::convertedToFormat (PixelFormat newFormat) const
 {
     if (image == nullptr || newFormat == image->pixelFormat)
@@ -542,6 +661,18 @@ Image Image::convertedToFormat (PixelFormat newFormat) const
                 dst[x].set (src[x]);
         }
     }
+    else if (image->pixelFormat != SingleChannel && isSoftwareImage (*this) && isSoftwareImage (newImage))
+    {
+        // Converting between RGB and ARGB just means copying the premultiplied components, which
+        // gives the same result as drawing the image over black, without going via a renderer
+        const BitmapData destData (newImage, 0, 0, w, h, BitmapData::writeOnly);
+        const BitmapData srcData (*this, 0, 0, w, h);
+
+        if (newFormat == Image::RGB)
+            convertLines<PixelRGB, PixelARGB> (srcData, destData);
+        else
+            convertLines<PixelARGB, PixelRGB> (srcData, destData);
+    }
     else
     {
         if (hasAlphaChannel())
@@ -569,6 +700,9 @@ Image::BitmapData::BitmapData (Image& im, int x, int y, int w, int h, BitmapData
 
     im.image->initialiseBitmapData (*this, x, y, mode);
     jassert (data != nullptr && pixelStride > 0 && lineStride != 0);
+
+    if (mode != readOnly)
+        pixelDataBeingWritten = im.image;
 }
 
 Image::BitmapData::BitmapData (const Image& im, int x, int y, int w, int h)
@@ -591,10 +725,20 @@ Image::BitmapData::BitmapData (const Image& im, BitmapData::ReadWriteMode mode)
 
     im.image->initialiseBitmapData (*this, 0, 0, mode);
     jassert (data != nullptr && pixelStride > 0 && lineStride != 0);
+
+    if (mode != readOnly)
+        pixelDataBeingWritten = im.image;
 }
 
 Image::BitmapData::~BitmapData()
 {
+    // Reduced copies made while the pixels were being written may have picked up a half-finished
+    // image, so they're thrown away. Some image types only copy the written pixels back when their
+    // releaser is deleted, so that has to happen first.
+    dataReleaser.reset();
+
+    if (pixelDataBeingWritten != nullptr)
+        pixelDataBeingWritten->discardReducedImages();
 }
 
 Colour Image::BitmapData::getPixelColour (int x, int y) const noexcept
@@ -680,9 +824,28 @@ struct PixelIterator
     template <class PixelOperation>
     static void iterate (const Image::BitmapData& data, const PixelOperation& pixelOp)
     {
+        // When the pixels in each line are packed together, walking them as an array lets the
+        // compiler vectorise the operation
+        if (data.pixelStride == (int) sizeof (PixelType))
+        {
+            for (int y = 0; y < data.height; ++y)
+            {
+                auto* line = reinterpret_cast<PixelType*> (data.getLinePointer (y));
+
+                for (int x = 0; x < data.width; ++x)
+                    pixelOp (line[x]);
+            }
+
+            return;
+        }
+
         for (int y = 0; y < data.height; ++y)
-            for (int x = 0; x < data.width; ++x)
-                pixelOp (*reinterpret_cast<PixelType*> (data.getPixelPointer (x, y)));
+        {
+            auto* pixel = data.getLinePointer (y);
+
+            for (int x = 0; x < data.width; ++x, pixel += data.pixelStride)
+                pixelOp (*reinterpret_cast<PixelType*> (pixel));
+        }
     }
 };
 
@@ -952,4 +1115,116 @@ JUCE_END_IGNORE_DEPRECATION_WARNINGS
 
 #endif
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageReductionTests final : public UnitTest
+{
+public:
+    ImageReductionTests()
+        : UnitTest ("Image reduction", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Reduced images average each block of pixels");
+        {
+            Image image (Image::SingleChannel, 3, 3, true, SoftwareImageType());
+
+            {
+                Image::BitmapData data (image, Image::BitmapData::writeOnly);
+                const uint8 values[] = { 0, 40, 80, 120, 160, 200, 240, 20, 60 };
+
+                for (int i = 0; i < 9; ++i)
+                    *data.getPixelPointer (i % 3, i / 3) = values[i];
+            }
+
+            const auto reduced = image.getPixelData()->getReducedImage (1);
+            expect (reduced.getBounds() == Rectangle<int> (2, 2));
+
+            const Image::BitmapData data (reduced, Image::BitmapData::readOnly);
+            expectEquals ((int) *data.getPixelPointer (0, 0), 80);
+            expectEquals ((int) *data.getPixelPointer (1, 0), 140);
+            expectEquals ((int) *data.getPixelPointer (0, 1), 130);
+            expectEquals ((int) *data.getPixelPointer (1, 1), 60);
+
+            expect (image.getPixelData()->getReducedImage (5).getBounds() == Rectangle<int> (1, 1));
+        }
+
+        beginTest ("Reduced images are discarded when the image changes");
+        {
+            Image image (Image::ARGB, 64, 64, true, SoftwareImageType());
+            const auto before = image.getPixelData()->getReducedImage (2);
+            expect (before.getPixelAt (5, 5) == Colours::transparentBlack);
+
+            image.clear (image.getBounds(), Colours::red);
+            expect (image.getPixelData()->getReducedImage (2).getPixelAt (5, 5) == Colours::red);
+
+            expect (image.getClippedImage ({ 8, 8, 32, 32 }).getPixelData()->getReducedImage (1).isNull());
+        }
+
+        beginTest ("Reduced images made while the image is being written are discarded afterwards");
+        {
+            Image image (Image::ARGB, 64, 64, true, SoftwareImageType());
+            const auto reducedPixel = [&] { return image.getPixelData()->getReducedImage (1).getPixelAt (5, 5); };
+
+            {
+                Image::BitmapData data (image, Image::BitmapData::writeOnly);
+                expect (reducedPixel() == Colours::transparentBlack);
+
+                for (int y = 0; y < data.height; ++y)
+                    for (int x = 0; x < data.width; ++x)
+                        data.setPixelColour (x, y, Colours::red);
+            }
+
+            expect (reducedPixel() == Colours::red);
+
+            {
+                Graphics g (image);
+                expect (reducedPixel() == Colours::red);
+                g.fillAll (Colours::blue);
+            }
+
+            expect (reducedPixel() == Colours::blue);
+
+            {
+                auto clipped = image.getClippedImage ({ 0, 0, 32, 32 });
+                Image::BitmapData data (clipped, Image::BitmapData::readWrite);
+                expect (reducedPixel() == Colours::blue);
+
+                for (int y = 0; y < data.height; ++y)
+                    for (int x = 0; x < data.width; ++x)
+                        data.setPixelColour (x, y, Colours::green);
+            }
+
+            expect (reducedPixel() == Colours::green);
+        }
+
+        beginTest ("Shrinking an image by a large factor averages its pixels");
+        {
+            Image checkerboard (Image::RGB, 240, 240, false, SoftwareImageType());
+
+            for (int y = 0; y < checkerboard.getHeight(); ++y)
+                for (int x = 0; x < checkerboard.getWidth(); ++x)
+                    checkerboard.setPixelAt (x, y, ((x ^ y) & 1) != 0 ? Colours::white : Colours::black);
+
+            Image result (Image::RGB, 16, 16, true, SoftwareImageType());
+
+            {
+                Graphics g (result);
+                g.setImageResamplingQuality (Graphics::mediumResamplingQuality);
+                g.drawImageTransformed (checkerboard, AffineTransform::scale (1.0f / 15.0f));
+            }
+
+            for (int y = 0; y < result.getHeight(); ++y)
+                for (int x = 0; x < result.getWidth(); ++x)
+                    expectWithinAbsoluteError ((int) result.getPixelAt (x, y).getRed(), 128, 8);
+        }
+    }
+};
+
+static ImageReductionTests imageReductionTests;
+
+#endif
+
 } // namespace juce
@@ -377,6 +377,8 @@ public:
         std::unique_ptr<BitmapDataReleaser> dataReleaser;
 
     private:
+        ReferenceCountedObjectPtr<ImagePixelData> pixelDataBeingWritten;
+
         JUCE_DECLARE_NON_COPYABLE (BitmapData)
     };
 
@@ -498,6 +500,27 @@ public:
     */
     virtual void applySingleChannelBoxBlurEffect (int radius, Image& result);
 
+    /** Returns a copy of this image which has been halved in size the given number of times,
+        averaging each 2x2 block of pixels at every step.
+
+        The software renderer uses these reduced copies when drawing an image at a fraction of
+        its size, so that the result isn't aliased. Each level is created the first time it's
+        needed, and is then kept until the image data next changes.
+
+        A level of 0 returns the image itself. Implementations that can't tell when their pixels
+        change may return an invalid image, in which case the caller should use the original.
+    */
+    virtual Image getReducedImage (int level);
+
+    /** Throws away the copies made by getReducedImage().
+
+        This is called when a writable Image::BitmapData is released, and when a software
+        renderer that was drawing into the image is deleted. Other image types that cache
+        reduced copies must call it once a write into their pixels has finished, because a
+        copy made while the write was in progress will be out of date.
+    */
+    virtual void discardReducedImages();
+
     /** The pixel format of the image data. */
     const Image::PixelFormat pixelFormat;
     const int width, height;
@@ -522,6 +545,10 @@ public:
     void sendDataChangeMessage();
 
 private:
+    CriticalSection reducedImageLock;
+    Array<Image> reducedImages;
+    std::atomic<bool> hasReducedImages { false };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ImagePixelData)
 };
 
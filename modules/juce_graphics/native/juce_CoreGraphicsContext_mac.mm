@@ -101,6 +101,10 @@ public:
 
     std::unique_ptr<ImageType> createType() const override    { return std::make_unique<NativeImageType>(); }
 
+    // We can't tell when a CoreGraphicsContext has finished drawing into us, so a cached
+    // copy could be made from a half-drawn image
+    Image getReducedImage (int) override    { return {}; }
+
     //==============================================================================
     static CGImageRef getCachedImageRef (const Image& juceImage, CGColorSpaceRef colourSpace)
     {
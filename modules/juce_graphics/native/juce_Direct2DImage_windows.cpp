@@ -461,6 +461,7 @@ std::unique_ptr<LowLevelGraphicsContext> Direct2DPixelData::createLowLevelContex
             endFrame();
             readFromDirect2DBitmap (storedContext, storedTarget, backup);
             self->state = State::drawn;
+            self->discardReducedImages();
         }
 
         ComSmartPtr<ID2D1DeviceContext1> storedContext;
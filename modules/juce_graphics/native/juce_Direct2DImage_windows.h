@@ -173,6 +173,19 @@ public:
     void applyGaussianBlurEffect (float radius, Image& result) override;
     void applySingleChannelBoxBlurEffect (int radius, Image& result) override;
 
+    /*  Reduced copies are made from, and cached alongside, the software storage, which is
+        brought up to date whenever a Direct2D context finishes drawing.
+    */
+    Image getReducedImage (int level) override
+    {
+        return level > 0 ? backingData->getReducedImage (level) : ImagePixelData::getReducedImage (level);
+    }
+
+    void discardReducedImages() override
+    {
+        backingData->discardReducedImages();
+    }
+
     /*  This returns image data that is suitable for use when drawing with the provided context.
         This image data should be treated as a read-only view - making modifications directly
         through the Direct2D API will have unpredictable results.
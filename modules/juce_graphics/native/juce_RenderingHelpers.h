@@ -2463,6 +2463,28 @@ public:
     template <typename IteratorType>
     void renderImageTransformed (IteratorType& iter, const Image& src, int alpha, const AffineTransform& trans, Graphics::ResamplingQuality quality, bool tiledFill) const
     {
+        // Interpolating between neighbouring pixels can't account for the source pixels that get
+        // skipped when shrinking an image by more than half, so in that case sample from a
+        // suitably reduced copy of the image instead. (Tiled fills need the exact source size.)
+        if (! tiledFill && quality != Graphics::lowResamplingQuality)
+        {
+            if (const auto level = getReducedImageLevel (trans); level > 0)
+            {
+                const auto reduced = src.getPixelData()->getReducedImage (level);
+
+                if (reduced.isValid())
+                {
+                    const auto scaleToSource = AffineTransform::scale ((float) src.getWidth()  / (float) reduced.getWidth(),
+                                                                       (float) src.getHeight() / (float) reduced.getHeight());
+
+                    Image::BitmapData destData (image, Image::BitmapData::readWrite);
+                    const Image::BitmapData srcData (reduced, Image::BitmapData::readOnly);
+                    EdgeTableFillers::renderImageTransformed (iter, destData, srcData, alpha, scaleToSource.followedBy (trans), quality, false);
+                    return;
+                }
+            }
+        }
+
         Image::BitmapData destData (image, Image::BitmapData::readWrite);
         const Image::BitmapData srcData (src, Image::BitmapData::readOnly);
         EdgeTableFillers::renderImageTransformed (iter, destData, srcData, alpha, trans, quality, tiledFill);
@@ -2515,6 +2537,19 @@ public:
     Font font { FontOptions{} };
 
 private:
+    static int getReducedImageLevel (const AffineTransform& t) noexcept
+    {
+        // Halve the image for as long as it still covers at least as many pixels as it will be
+        // drawn across, along both of its axes
+        const auto scale = jmax (std::hypot (t.mat00, t.mat10), std::hypot (t.mat01, t.mat11));
+        int level = 0;
+
+        for (auto s = scale * 2.0f; s <= 1.0f && level < 16; s *= 2.0f)
+            ++level;
+
+        return level;
+    }
+
     SoftwareRendererSavedState& operator= (const SoftwareRendererSavedState&) = delete;
 };
 
@@ -47,7 +47,7 @@ struct FlexBoxLayoutCalculation
                        || fb.flexDirection == FlexBox::Direction::rowReverse),
           containerLineLength (getContainerSize (Axis::main))
     {
-        lineItems.calloc (numItems * numItems);
+        lineItems.calloc (numItems);
         lineInfo.calloc (numItems);
     }
 
@@ -74,7 +74,7 @@ struct FlexBoxLayoutCalculation
 
     struct RowInfo
     {
-        int numItems;
+        int firstItem, numItems;
         Coord crossSize, lineY, totalLength;
     };
 
@@ -87,11 +87,12 @@ struct FlexBoxLayoutCalculation
     int numberOfRows = 1;
     Coord containerCrossLength = 0;
 
+    // Each line holds a contiguous run of the items, so these are stored line after line
     HeapBlock<ItemWithState*> lineItems;
     HeapBlock<RowInfo> lineInfo;
     Array<ItemWithState> itemStates;
 
-    ItemWithState& getItem (int x, int y) const noexcept     { return *lineItems[y * numItems + x]; }
+    ItemWithState& getItem (int x, int y) const noexcept     { return *lineItems[lineInfo[y].firstItem + x]; }
 
     static bool isAuto (Coord value) noexcept
     {
@@ -198,7 +199,7 @@ struct FlexBoxLayoutCalculation
         else // if multi-line, group the flexbox items into multiple lines
         {
             auto currentLength = containerLineLength;
-            int column = 0, row = 0;
+            int column = 0, row = 0, index = 0;
             bool firstRow = true;
 
             for (auto& item : itemStates)
@@ -218,10 +219,11 @@ struct FlexBoxLayoutCalculation
                     column = 0;
                     currentLength = containerLineLength;
                     numberOfRows = jmax (numberOfRows, row + 1);
+                    lineInfo[row].firstItem = index;
                 }
 
                 currentLength -= flexitemLength;
-                lineItems[row * numItems + column] = &item;
+                lineItems[index++] = &item;
                 ++column;
                 lineInfo[row].numItems = jmax (lineInfo[row].numItems, column);
                 firstRow = false;
@@ -329,8 +331,7 @@ struct FlexBoxLayoutCalculation
         if (owner.alignContent == FlexBox::AlignContent::flexStart)
         {
             for (int row = 0; row < numberOfRows; ++row)
-                for (int row2 = row; row2 < numberOfRows; ++row2)
-                    lineInfo[row].lineY = row == 0 ? 0 : lineInfo[row - 1].lineY + lineInfo[row - 1].crossSize;
+                lineInfo[row].lineY = row == 0 ? 0 : lineInfo[row - 1].lineY + lineInfo[row - 1].crossSize;
         }
         else if (owner.alignContent == FlexBox::AlignContent::flexEnd)
         {
@@ -984,22 +984,23 @@ struct Grid::Helpers
             {
                 auto& array = tracksInDirection.items;
 
-                for (int index = 0; index < array.size(); ++index)
+                // Gather the largest single-track item for every track in one pass, rather
+                // than rescanning all of the placements for each auto track
+                std::vector<float> largestItemSizes ((size_t) array.size(), 0.0f);
+
+                for (const auto& element : placements)
                 {
-                    if (array.getReference (index).isAuto())
-                    {
-                        const auto combiner = [&] (const auto acc, const auto& element)
-                        {
-                            const auto item = getItem (element.second);
-                            const auto isNotSpan = std::abs (item.end - item.start) <= 1;
-                            return isNotSpan && item.start == index + 1 - tracksInDirection.numImplicitLeading
-                                   ? std::max (acc, getItemSize (*element.first))
-                                   : acc;
-                        };
-
-                        array.getReference (index).size = std::accumulate (placements.begin(), placements.end(), 0.0f, combiner);
-                    }
+                    const auto item = getItem (element.second);
+                    const auto isNotSpan = std::abs (item.end - item.start) <= 1;
+                    const auto index = item.start - 1 + tracksInDirection.numImplicitLeading;
+
+                    if (isNotSpan && isPositiveAndBelow (index, array.size()))
+                        largestItemSizes[(size_t) index] = std::max (largestItemSizes[(size_t) index], getItemSize (*element.first));
                 }
+
+                for (int index = 0; index < array.size(); ++index)
+                    if (array.getReference (index).isAuto())
+                        array.getReference (index).size = largestItemSizes[(size_t) index];
             };
 
             setSizes (tracks.rows,
@@ -443,14 +443,27 @@ private:
         void dispatchDeferredRepaints()
         {
             XWindowSystem::getInstance()->processPendingPaintsForWindow (peer.windowH);
-
-            if (XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH) > 0)
-                return;
+            updateFramesInFlight();
 
             if (! regionsNeedingRepaint.isEmpty())
+            {
+                // When painting takes longer than a frame, leave the message thread at least as long
+                // again to deal with input and timers before painting the next one. Any areas
+                // invalidated in the meantime just get merged into that next frame.
+                const auto now = Time::getMillisecondCounterHiRes();
+
+                if (lastPaintDuration > peer.vBlankManager.getTimerInterval()
+                     && now < lastPaintEndTime + lastPaintDuration)
+                    return;
+
                 performAnyPendingRepaintsNow();
-            else if (Time::getApproximateMillisecondCounter() > lastTimeImageUsed + 3000)
-                image = Image();
+
+                lastPaintEndTime = Time::getMillisecondCounterHiRes();
+                lastPaintDuration = lastPaintEndTime - now;
+            }
+            else if (framesInFlight.isEmpty() && Time::getApproximateMillisecondCounter() > lastTimeImageUsed + 3000)
+                for (auto& b : buffers)
+                    b = Image();
         }
 
         void repaint (Rectangle<int> area)
@@ -460,16 +473,25 @@ private:
 
         void performAnyPendingRepaintsNow()
         {
-            if (XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH) > 0)
+            updateFramesInFlight();
+
+            // The X server reads XShm images asynchronously, so we can't draw into one until all of
+            // its blits have completed. Keeping a second image lets us paint the next frame while
+            // the server is still busy with the previous one.
+            const auto bufferIndex = getFreeBufferIndex();
+
+            if (bufferIndex < 0)
                 return;
 
+            auto& image = buffers[(size_t) bufferIndex];
+
             auto originalRepaintRegion = regionsNeedingRepaint;
             regionsNeedingRepaint.clear();
             auto totalArea = originalRepaintRegion.getBounds();
 
             if (! totalArea.isEmpty())
             {
-                const auto wasImageNull = image.isNull();
+                const auto wasImageNull = std::all_of (std::begin (buffers), std::end (buffers), [] (const Image& b) { return b.isNull(); });
 
                 if (wasImageNull || image.getWidth() < totalArea.getWidth()
                      || image.getHeight() < totalArea.getHeight())
@@ -510,18 +532,69 @@ private:
                     peer.handlePaint (*context);
                 }
 
+                const auto blitStartTime = Time::getMillisecondCounterHiRes();
+
                 for (auto& i : originalRepaintRegion)
                    XWindowSystem::getInstance()->blitToWindow (peer.windowH, image, i, totalArea);
+
+                peer.addFramePresentTime (Time::getMillisecondCounterHiRes() - blitStartTime);
+
+                const auto numPending = XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH);
+
+                if (numPending > numPaintsPending)
+                    framesInFlight.add ({ bufferIndex, numPending - numPaintsPending });
+
+                numPaintsPending = numPending;
             }
 
             lastTimeImageUsed = Time::getApproximateMillisecondCounter();
         }
 
     private:
+        struct FrameInFlight
+        {
+            int bufferIndex, numBlits;
+        };
+
+        // The server completes blits in the order they were sent, so any that have finished since
+        // we last checked must belong to the oldest frames
+        void updateFramesInFlight()
+        {
+            const auto numPending = XWindowSystem::getInstance()->getNumPaintsPendingForWindow (peer.windowH);
+            auto numCompleted = numPaintsPending - numPending;
+            numPaintsPending = numPending;
+
+            while (numCompleted > 0 && ! framesInFlight.isEmpty())
+            {
+                auto& oldest = framesInFlight.getReference (0);
+                const auto numFinished = jmin (numCompleted, oldest.numBlits);
+                oldest.numBlits -= numFinished;
+                numCompleted -= numFinished;
+
+                if (oldest.numBlits == 0)
+                    framesInFlight.remove (0);
+            }
+
+            if (numPending == 0)
+                framesInFlight.clearQuick();
+        }
+
+        int getFreeBufferIndex() const
+        {
+            for (int i = 0; i < (int) std::size (buffers); ++i)
+                if (std::none_of (framesInFlight.begin(), framesInFlight.end(), [i] (const FrameInFlight& f) { return f.bufferIndex == i; }))
+                    return i;
+
+            return -1;
+        }
+
         LinuxComponentPeer& peer;
         const bool isSemiTransparentWindow;
-        Image image;
+        Image buffers[2];
+        Array<FrameInFlight> framesInFlight;
+        int numPaintsPending = 0;
         uint32 lastTimeImageUsed = 0;
+        double lastPaintEndTime = 0, lastPaintDuration = 0;
         RectangleList<int> regionsNeedingRepaint;
 
         bool useARGBImagesForRendering = XWindowSystem::getInstance()->canUseARGBImages();
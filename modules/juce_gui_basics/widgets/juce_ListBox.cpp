@@ -305,6 +305,86 @@ private:
 };
 
 
+//==============================================================================
+/*  Holds the heights of the rows in a Fenwick tree, so that both the position of a row and the
+    row at a given position can be found in O(log n) time, and changing the height of one row
+    doesn't mean updating the positions of all the rows below it.
+*/
+class ListBox::RowHeightIndex
+{
+public:
+    void setHeights (std::vector<int> newHeights)
+    {
+        heights = std::move (newHeights);
+        sums.assign (heights.size() + 1, 0);
+
+        for (size_t i = 1; i < sums.size(); ++i)
+        {
+            sums[i] += heights[i - 1];
+
+            const auto parent = i + lowestBit (i);
+
+            if (parent < sums.size())
+                sums[parent] += sums[i];
+        }
+    }
+
+    int getNumRows() const noexcept                 { return (int) heights.size(); }
+    int getHeight (int row) const noexcept          { return heights[(size_t) row]; }
+    int getTotalHeight() const noexcept             { return getPosition (getNumRows()); }
+
+    void setHeight (int row, int newHeight) noexcept
+    {
+        const auto delta = newHeight - std::exchange (heights[(size_t) row], newHeight);
+
+        for (auto i = (size_t) row + 1; i < sums.size(); i += lowestBit (i))
+            sums[i] += delta;
+    }
+
+    /** Returns the total height of the rows above this one. */
+    int getPosition (int row) const noexcept
+    {
+        int total = 0;
+
+        for (auto i = (size_t) row; i > 0; i -= lowestBit (i))
+            total += sums[i];
+
+        return total;
+    }
+
+    /** Returns the row that contains a position, or getNumRows() if it's below the last row. */
+    int getRowContaining (int y) const noexcept
+    {
+        size_t row = 0;
+
+        for (auto step = highestBitBelow (sums.size()); step > 0; step >>= 1)
+        {
+            if (row + step < sums.size() && sums[row + step] <= y)
+            {
+                row += step;
+                y -= sums[row];
+            }
+        }
+
+        return (int) row;
+    }
+
+private:
+    static size_t lowestBit (size_t i) noexcept         { return i & (~i + 1); }
+
+    static size_t highestBitBelow (size_t size) noexcept
+    {
+        size_t bit = 1;
+
+        while (bit * 2 < size)
+            bit *= 2;
+
+        return bit;
+    }
+
+    std::vector<int> heights, sums;
+};
+
 //==============================================================================
 class ListBox::ListViewport final : public Viewport,
                                     private Timer
@@ -371,7 +451,7 @@ public:
         auto newX = content.getX();
         auto newY = content.getY();
         auto newW = jmax (owner.minimumRowWidth, getMaximumVisibleWidth());
-        auto newH = owner.totalItems * owner.getRowHeight();
+        auto newH = owner.getTotalHeightOfRows();
 
         if (newY + newH < getMaximumVisibleHeight() && newH > getMaximumVisibleHeight())
             newY = getMaximumVisibleHeight() - newH;
@@ -393,8 +473,18 @@ public:
             auto y = getViewPositionY();
             auto w = content.getWidth();
 
-            const auto numNeeded = (size_t) (4 + getMaximumVisibleHeight() / rowH);
-            rows.resize (jmin (numNeeded, rows.size()));
+            firstIndex = owner.getRowAtPosition (y);
+            firstWholeIndex = owner.getPositionOfRow (firstIndex) < y ? firstIndex + 1 : firstIndex;
+            lastWholeIndex = owner.getRowAtPosition (y + getMaximumVisibleHeight() - 1);
+
+            const auto variableHeights = owner.areVariableRowHeightsEnabled();
+            const auto numNeeded = (size_t) (4 + (variableHeights ? jmax (0, lastWholeIndex - firstIndex)
+                                                                  : getMaximumVisibleHeight() / rowH));
+
+            // When the row heights vary, the number of rows on screen changes as the list
+            // scrolls, so hang on to some spare components rather than recreating them
+            if (rows.size() > numNeeded * (variableHeights ? 2 : 1))
+                rows.resize (numNeeded);
 
             while (numNeeded > rows.size())
             {
@@ -402,24 +492,24 @@ public:
                 content.addAndMakeVisible (*rows.back());
             }
 
-            firstIndex = y / rowH;
-            firstWholeIndex = (y + rowH - 1) / rowH;
-            lastWholeIndex = (y + getMaximumVisibleHeight() - 1) / rowH;
-
             const auto startIndex = getIndexOfFirstVisibleRow();
             const auto lastIndex = startIndex + (int) rows.size();
 
-            for (auto row = startIndex; row < lastIndex; ++row)
+            for (auto row = startIndex, rowY = owner.getPositionOfRow (startIndex); row < lastIndex; ++row)
             {
+                const auto rowHeight = owner.getHeightOfRow (row);
+
                 if (auto* rowComp = getComponentForRowIfOnscreen (row))
                 {
-                    rowComp->setBounds (0, row * rowH, w, rowH);
+                    rowComp->setBounds (0, rowY, w, rowHeight);
                     rowComp->update (row, owner.isRowSelected (row));
                 }
                 else
                 {
                     jassertfalse;
                 }
+
+                rowY += rowHeight;
             }
         }
 
@@ -431,14 +521,14 @@ public:
                                               owner.headerComponent->getHeight());
     }
 
-    void selectRow (const int row, const int rowH, const bool dontScroll,
+    void selectRow (const int row, const bool dontScroll,
                     const int lastSelectedRow, const int totalRows, const bool isMouseClick)
     {
         hasUpdated = false;
 
         if (row < firstWholeIndex && ! dontScroll)
         {
-            setViewPosition (getViewPositionX(), row * rowH);
+            setViewPosition (getViewPositionX(), owner.getPositionOfRow (row));
         }
         else if (row >= lastWholeIndex && ! dontScroll)
         {
@@ -449,12 +539,12 @@ public:
                  && ! isMouseClick)
             {
                 setViewPosition (getViewPositionX(),
-                                 jlimit (0, jmax (0, totalRows - rowsOnScreen), row) * rowH);
+                                 owner.getPositionOfRow (jlimit (0, jmax (0, totalRows - rowsOnScreen), row)));
             }
             else
             {
                 setViewPosition (getViewPositionX(),
-                                 jmax (0, (row  + 1) * rowH - getMaximumVisibleHeight()));
+                                 jmax (0, owner.getPositionOfRow (row + 1) - getMaximumVisibleHeight()));
             }
         }
 
@@ -462,16 +552,16 @@ public:
             updateContents();
     }
 
-    void scrollToEnsureRowIsOnscreen (const int row, const int rowH)
+    void scrollToEnsureRowIsOnscreen (const int row)
     {
         if (row < firstWholeIndex)
         {
-            setViewPosition (getViewPositionX(), row * rowH);
+            setViewPosition (getViewPositionX(), owner.getPositionOfRow (row));
         }
         else if (row >= lastWholeIndex)
         {
             setViewPosition (getViewPositionX(),
-                             jmax (0, (row  + 1) * rowH - getMaximumVisibleHeight()));
+                             jmax (0, owner.getPositionOfRow (row + 1) - getMaximumVisibleHeight()));
         }
     }
 
@@ -650,6 +740,18 @@ void ListBox::updateContent()
     hasDoneInitialUpdate = true;
     totalItems = (model != nullptr) ? model->getNumRows() : 0;
 
+    if (rowHeightIndex != nullptr)
+    {
+        std::vector<int> heights ((size_t) totalItems, rowHeight);
+
+        if (model != nullptr)
+            for (int i = 0; i < totalItems; ++i)
+                if (auto h = model->getHeightForRow (i); h > 0)
+                    heights[(size_t) i] = h;
+
+        rowHeightIndex->setHeights (std::move (heights));
+    }
+
     bool selectionChanged = false;
 
     if (selected.size() > 0 && selected [selected.size() - 1] >= totalItems)
@@ -701,8 +803,7 @@ void ListBox::selectRowInternal (const int row,
             if (getHeight() == 0 || getWidth() == 0)
                 dontScroll = true;
 
-            viewport->selectRow (row, getRowHeight(), dontScroll,
-                                 lastRowSelected, totalItems, isMouseClick);
+            viewport->selectRow (row, dontScroll, lastRowSelected, totalItems, isMouseClick);
 
             lastRowSelected = row;
             model->selectedRowsChanged (row);
@@ -850,7 +951,7 @@ int ListBox::getRowContainingPosition (const int x, const int y) const noexcept
 {
     if (isPositiveAndBelow (x, getWidth()))
     {
-        const int row = (viewport->getViewPositionY() + y - viewport->getY()) / rowHeight;
+        const int row = getRowAtPosition (viewport->getViewPositionY() + y - viewport->getY());
 
         if (isPositiveAndBelow (row, totalItems))
             return row;
@@ -862,7 +963,17 @@ int ListBox::getRowContainingPosition (const int x, const int y) const noexcept
 int ListBox::getInsertionIndexForPosition (const int x, const int y) const noexcept
 {
     if (isPositiveAndBelow (x, getWidth()))
-        return jlimit (0, totalItems, (viewport->getViewPositionY() + y + rowHeight / 2 - viewport->getY()) / rowHeight);
+    {
+        const auto contentY = viewport->getViewPositionY() + y - viewport->getY();
+
+        if (rowHeightIndex == nullptr)
+            return jlimit (0, totalItems, (contentY + rowHeight / 2) / rowHeight);
+
+        const auto row = getRowAtPosition (contentY);
+        const auto isInTopHalf = contentY < getPositionOfRow (row) + getHeightOfRow (row) / 2;
+
+        return jlimit (0, totalItems, isInTopHalf ? row : row + 1);
+    }
 
     return -1;
 }
@@ -882,13 +993,82 @@ int ListBox::getRowNumberOfComponent (const Component* const rowComponent) const
 
 Rectangle<int> ListBox::getRowPosition (int rowNumber, bool relativeToComponentTopLeft) const noexcept
 {
-    auto y = viewport->getY() + rowHeight * rowNumber;
+    auto y = viewport->getY() + getPositionOfRow (rowNumber);
 
     if (relativeToComponentTopLeft)
         y -= viewport->getViewPositionY();
 
     return { viewport->getX(), y,
-             viewport->getViewedComponent()->getWidth(), rowHeight };
+             viewport->getViewedComponent()->getWidth(), getHeightOfRow (rowNumber) };
+}
+
+int ListBox::getPositionOfRow (int rowNumber) const noexcept
+{
+    if (rowHeightIndex == nullptr || rowNumber <= 0)
+        return rowNumber * rowHeight;
+
+    const auto numRows = rowHeightIndex->getNumRows();
+
+    if (rowNumber > numRows)
+        return rowHeightIndex->getTotalHeight() + (rowNumber - numRows) * rowHeight;
+
+    return rowHeightIndex->getPosition (rowNumber);
+}
+
+int ListBox::getHeightOfRow (int rowNumber) const noexcept
+{
+    if (rowHeightIndex != nullptr && isPositiveAndBelow (rowNumber, rowHeightIndex->getNumRows()))
+        return rowHeightIndex->getHeight (rowNumber);
+
+    return rowHeight;
+}
+
+int ListBox::getRowAtPosition (int y) const noexcept
+{
+    if (rowHeightIndex == nullptr)
+        return y / rowHeight;
+
+    if (y < 0)
+        return -1;
+
+    const auto totalHeight = rowHeightIndex->getTotalHeight();
+
+    if (y >= totalHeight)
+        return rowHeightIndex->getNumRows() + (y - totalHeight) / rowHeight;
+
+    return rowHeightIndex->getRowContaining (y);
+}
+
+int ListBox::getRowOnePageAway (int row, bool downwards) const noexcept
+{
+    const auto pageHeight = viewport->getHeight();
+    const auto start = getPositionOfRow (row);
+    int result;
+
+    if (downwards)
+    {
+        // the row that the bottom of a page starting at this row falls in
+        result = jmax (row + 1, getRowAtPosition (start + pageHeight));
+    }
+    else
+    {
+        // the first row that lies completely within the page ending at this row
+        const auto y = start - pageHeight;
+        result = y > 0 ? getRowAtPosition (y) : 0;
+
+        if (getPositionOfRow (result) < y)
+            ++result;
+
+        result = jmin (row - 1, result);
+    }
+
+    return jlimit (0, jmax (0, totalItems - 1), result);
+}
+
+int ListBox::getTotalHeightOfRows() const noexcept
+{
+    return rowHeightIndex != nullptr ? rowHeightIndex->getTotalHeight()
+                                     : totalItems * rowHeight;
 }
 
 void ListBox::setVerticalPosition (const double proportion)
@@ -914,7 +1094,7 @@ int ListBox::getVisibleRowWidth() const noexcept
 
 void ListBox::scrollToEnsureRowIsOnscreen (const int row)
 {
-    viewport->scrollToEnsureRowIsOnscreen (row, getRowHeight());
+    viewport->scrollToEnsureRowIsOnscreen (row);
 }
 
 //==============================================================================
@@ -922,8 +1102,6 @@ bool ListBox::keyPressed (const KeyPress& key)
 {
     checkModelPtrIsValid();
 
-    const int numVisibleRows = viewport->getHeight() / getRowHeight();
-
     const bool multiple = multipleSelection
                             && lastRowSelected >= 0
                             && key.getModifiers().isShiftDown();
@@ -945,16 +1123,16 @@ bool ListBox::keyPressed (const KeyPress& key)
     else if (key.isKeyCode (KeyPress::pageUpKey))
     {
         if (multiple)
-            selectRangeOfRows (lastRowSelected, lastRowSelected - numVisibleRows);
+            selectRangeOfRows (lastRowSelected, getRowOnePageAway (lastRowSelected, false));
         else
-            selectRow (jmax (0, jmax (0, lastRowSelected) - numVisibleRows));
+            selectRow (getRowOnePageAway (jmax (0, lastRowSelected), false));
     }
     else if (key.isKeyCode (KeyPress::pageDownKey))
     {
         if (multiple)
-            selectRangeOfRows (lastRowSelected, lastRowSelected + numVisibleRows);
+            selectRangeOfRows (lastRowSelected, getRowOnePageAway (lastRowSelected, true));
         else
-            selectRow (jmin (totalItems - 1, jmax (0, lastRowSelected) + numVisibleRows));
+            selectRow (getRowOnePageAway (jmax (0, lastRowSelected), true));
     }
     else if (key.isKeyCode (KeyPress::homeKey))
     {
@@ -1043,9 +1221,37 @@ void ListBox::setRowHeight (const int newHeight)
 
 int ListBox::getNumRowsOnScreen() const noexcept
 {
+    if (rowHeightIndex != nullptr)
+    {
+        const auto y = viewport->getViewPositionY();
+        return getRowAtPosition (y + viewport->getMaximumVisibleHeight() - 1) - getRowAtPosition (y) + 1;
+    }
+
     return viewport->getMaximumVisibleHeight() / rowHeight;
 }
 
+void ListBox::setVariableRowHeightsEnabled (bool shouldBeEnabled)
+{
+    if (shouldBeEnabled != areVariableRowHeightsEnabled())
+    {
+        rowHeightIndex = shouldBeEnabled ? std::make_unique<RowHeightIndex>() : nullptr;
+        updateContent();
+    }
+}
+
+void ListBox::updateRowHeight (int rowNumber)
+{
+    checkModelPtrIsValid();
+
+    if (rowHeightIndex != nullptr && model != nullptr
+         && isPositiveAndBelow (rowNumber, rowHeightIndex->getNumRows()))
+    {
+        const auto h = model->getHeightForRow (rowNumber);
+        rowHeightIndex->setHeight (rowNumber, h > 0 ? h : rowHeight);
+        viewport->updateVisibleArea (true);
+    }
+}
+
 void ListBox::setMinimumContentWidth (const int newMinimumWidth)
 {
     minimumRowWidth = newMinimumWidth;
@@ -1259,5 +1465,166 @@ void ListBoxModel::listWasScrolled() {}
 var ListBoxModel::getDragSourceDescription (const SparseSet<int>&)      { return {}; }
 String ListBoxModel::getTooltipForRow (int)                             { return {}; }
 MouseCursor ListBoxModel::getMouseCursorForRow (int)                    { return MouseCursor::NormalCursor; }
+int ListBoxModel::getHeightForRow (int)                                 { return 0; }
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ListBoxTests final : public UnitTest
+{
+public:
+    ListBoxTests() : UnitTest ("ListBox", UnitTestCategories::gui) {}
+
+    void runTest() override
+    {
+        auto random = getRandom();
+
+        beginTest ("Rows with variable heights are positioned one after another");
+        {
+            TestModel model (random, 1000);
+            ListBox list ({}, &model);
+            list.setRowHeight (10);
+            list.setVariableRowHeightsEnabled (true);
+            list.setBounds (0, 0, 200, 300);
+
+            expect (rowPositionsMatchHeights (list, model));
+
+            for (int i = 0; i < 50; ++i)
+            {
+                const auto row = random.nextInt (model.numRows);
+                model.heights[(size_t) row] = random.nextInt (60) - 5;
+                list.updateRowHeight (row);
+            }
+
+            expect (rowPositionsMatchHeights (list, model));
+
+            model.numRows = 500;
+            list.updateContent();
+            expect (rowPositionsMatchHeights (list, model));
+        }
+
+        beginTest ("Page up and down move by the height of the viewport");
+        {
+            TestModel model (random, 300);
+            ListBox list ({}, &model);
+            list.setVariableRowHeightsEnabled (true);
+            list.setBounds (0, 0, 200, 300);
+            list.setWantsKeyboardFocus (true);
+
+            const auto pageHeight = list.getViewport()->getHeight();
+
+            for (int i = 0; i < 50; ++i)
+            {
+                const auto start = random.nextInt (model.numRows);
+
+                list.selectRow (start);
+                list.keyPressed (KeyPress (KeyPress::pageDownKey));
+                const auto down = list.getSelectedRow();
+                const auto startY = list.getRowPosition (start, false).getY();
+
+                expect (down > start || start == model.numRows - 1);
+
+                if (down > start + 1)
+                    expect (list.getRowPosition (down, false).getY() <= startY + pageHeight);
+
+                if (down < model.numRows - 1)
+                    expect (list.getRowPosition (down, false).getBottom() > startY + pageHeight);
+
+                list.selectRow (start);
+                list.keyPressed (KeyPress (KeyPress::pageUpKey));
+                const auto up = list.getSelectedRow();
+
+                expect (up < start || start == 0);
+
+                if (up < start - 1)
+                    expect (list.getRowPosition (up, false).getY() >= startY - pageHeight);
+
+                if (up > 0)
+                    expect (list.getRowPosition (up - 1, false).getY() < startY - pageHeight);
+            }
+
+            list.setVariableRowHeightsEnabled (false);
+            list.setRowHeight (10);
+            list.selectRow (100);
+            list.keyPressed (KeyPress (KeyPress::pageDownKey));
+            expectEquals (list.getSelectedRow(), 100 + pageHeight / 10);
+            list.keyPressed (KeyPress (KeyPress::pageUpKey));
+            expectEquals (list.getSelectedRow(), 100);
+        }
+
+        beginTest ("Positions map back to the rows that contain them");
+        {
+            TestModel model (random, 200);
+            ListBox list ({}, &model);
+            list.setVariableRowHeightsEnabled (true);
+            list.setBounds (0, 0, 200, 300);
+
+            for (int i = 0; i < 20; ++i)
+            {
+                list.getViewport()->setViewPosition (0, random.nextInt (list.getViewport()->getViewedComponent()->getHeight()));
+
+                for (int y = 0; y < list.getHeight(); ++y)
+                {
+                    const auto row = list.getRowContainingPosition (10, y);
+
+                    if (row >= 0)
+                        expect (list.getRowPosition (row, true).contains (10, y));
+                }
+
+                const auto row = list.getRowContainingPosition (10, list.getHeight() / 2);
+
+                if (auto* rowComponent = list.getComponentForRowNumber (row))
+                    expect (list.getLocalArea (rowComponent, rowComponent->getLocalBounds()) == list.getRowPosition (row, true));
+                else
+                    expectEquals (row, -1);
+            }
+        }
+    }
+
+private:
+    struct TestModel final : public ListBoxModel
+    {
+        TestModel (Random& random, int numRowsIn)
+            : numRows (numRowsIn)
+        {
+            for (int i = 0; i < numRows; ++i)
+                heights.push_back (random.nextInt (60) - 5);
+        }
+
+        int getNumRows() override                                   { return numRows; }
+        void paintListBoxItem (int, Graphics&, int, int, bool) override {}
+        int getHeightForRow (int row) override                      { return heights[(size_t) row]; }
+
+        Component* refreshComponentForRow (int, bool, Component* existing) override
+        {
+            return existing != nullptr ? existing : new Component();
+        }
+
+        std::vector<int> heights;
+        int numRows = 0;
+    };
+
+    static bool rowPositionsMatchHeights (const ListBox& list, const TestModel& model)
+    {
+        int y = 0;
+
+        for (int row = 0; row < model.numRows; ++row)
+        {
+            const auto h = model.heights[(size_t) row] > 0 ? model.heights[(size_t) row] : list.getRowHeight();
+            const auto pos = list.getRowPosition (row, false).withX (0);
+
+            if (pos.getY() != y || pos.getHeight() != h)
+                return false;
+
+            y += h;
+        }
+
+        return list.getViewport()->getViewedComponent()->getHeight() == y;
+    }
+};
+
+static ListBoxTests listBoxTests;
+
+#endif
 
 } // namespace juce
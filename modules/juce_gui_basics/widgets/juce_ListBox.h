@@ -178,6 +178,17 @@ public:
     /** You can override this to return a custom mouse cursor for each row. */
     virtual MouseCursor getMouseCursorForRow (int row);
 
+    /** You can override this to give each row its own height.
+
+        This is only called if the ListBox has had variable row heights enabled with
+        ListBox::setVariableRowHeightsEnabled(). Returning 0 or less will give the row
+        the list's default height (see ListBox::setRowHeight()).
+
+        The list reads these heights when ListBox::updateContent() is called. If the
+        height of a single row changes, call ListBox::updateRowHeight() for that row.
+    */
+    virtual int getHeightForRow (int rowNumber);
+
 private:
    #if ! JUCE_DISABLE_ASSERTIONS
     friend class ListBox;
@@ -497,9 +508,37 @@ public:
 
         This is the number of whole rows which will fit on-screen, so the value might
         be more than the actual number of rows in the list.
+
+        If variable row heights are enabled, this is instead the number of rows that
+        overlap the visible area at the list's current scroll position.
     */
     int getNumRowsOnScreen() const noexcept;
 
+    /** Lets the rows of the list have different heights.
+
+        When this is enabled, the list asks its model for the height of each row using
+        ListBoxModel::getHeightForRow(), and keeps an index of the heights so that finding
+        the position of a row, or the row at a position, stays fast for very long lists.
+
+        By default this is disabled, and every row has the height set by setRowHeight().
+        @see updateRowHeight
+    */
+    void setVariableRowHeightsEnabled (bool shouldBeEnabled);
+
+    /** Returns true if variable row heights have been enabled.
+        @see setVariableRowHeightsEnabled
+    */
+    bool areVariableRowHeightsEnabled() const noexcept  { return rowHeightIndex != nullptr; }
+
+    /** Re-reads the height of a single row from the model.
+
+        If variable row heights are enabled, call this when a row changes its height, e.g.
+        when it is expanded. This is much cheaper than calling updateContent(), which
+        needs to re-read the height of every row.
+        @see setVariableRowHeightsEnabled, ListBoxModel::getHeightForRow
+    */
+    void updateRowHeight (int rowNumber);
+
     //==============================================================================
     /** A set of colour IDs to use to change the colour of various aspects of the label.
 
@@ -628,12 +667,14 @@ private:
     //==============================================================================
     JUCE_PUBLIC_IN_DLL_BUILD (class ListViewport)
     JUCE_PUBLIC_IN_DLL_BUILD (class RowComponent)
+    JUCE_PUBLIC_IN_DLL_BUILD (class RowHeightIndex)
     friend class ListViewport;
     friend class TableListBox;
     ListBoxModel* model = nullptr;
     std::unique_ptr<ListViewport> viewport;
     std::unique_ptr<Component> headerComponent;
     std::unique_ptr<MouseListener> mouseMoveSelector;
+    std::unique_ptr<RowHeightIndex> rowHeightIndex;
     SparseSet<int> selected;
     int totalItems = 0, rowHeight = 22, minimumRowWidth = 0;
     int outlineThickness = 0;
@@ -647,6 +688,11 @@ private:
     void assignModelPtr (ListBoxModel*);
     void checkModelPtrIsValid() const;
     bool hasAccessibleHeaderComponent() const;
+    int getPositionOfRow (int rowNumber) const noexcept;
+    int getHeightOfRow (int rowNumber) const noexcept;
+    int getRowAtPosition (int y) const noexcept;
+    int getRowOnePageAway (int row, bool downwards) const noexcept;
+    int getTotalHeightOfRows() const noexcept;
     void selectRowInternal (int rowNumber, bool dontScrollToShowThisRow,
                             bool deselectOthersFirst, bool isMouseClick);
 
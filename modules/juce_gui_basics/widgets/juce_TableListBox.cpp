@@ -471,6 +471,11 @@ int TableListBox::getNumRows()
     return model != nullptr ? model->getNumRows() : 0;
 }
 
+int TableListBox::getHeightForRow (int rowNumber)
+{
+    return model != nullptr ? model->getHeightForRow (rowNumber) : 0;
+}
+
 void TableListBox::paintListBoxItem (int, Graphics&, int, int, bool)
 {
 }
@@ -675,6 +680,7 @@ void TableListBoxModel::selectedRowsChanged (int)                       {}
 void TableListBoxModel::deleteKeyPressed (int)                          {}
 void TableListBoxModel::returnKeyPressed (int)                          {}
 void TableListBoxModel::listWasScrolled()                               {}
+int TableListBoxModel::getHeightForRow (int)                            { return 0; }
 
 String TableListBoxModel::getCellTooltip (int /*rowNumber*/, int /*columnId*/)    { return {}; }
 var TableListBoxModel::getDragSourceDescription (const SparseSet<int>&)           { return {}; }
@@ -200,6 +200,16 @@ public:
         dragged to other windows. Returns true by default.
     */
     virtual bool mayDragToExternalWindows() const   { return true; }
+
+    /** You can override this to give each row its own height.
+
+        This is only called if the table has had variable row heights enabled with
+        ListBox::setVariableRowHeightsEnabled(). Returning 0 or less will give the row
+        the table's default height.
+
+        @see ListBoxModel::getHeightForRow, ListBox::updateRowHeight
+    */
+    virtual int getHeightForRow (int rowNumber);
 };
 
 
@@ -331,6 +341,8 @@ public:
     /** @internal */
     void listWasScrolled() override;
     /** @internal */
+    int getHeightForRow (int rowNumber) override;
+    /** @internal */
     void tableColumnsChanged (TableHeaderComponent*) override;
     /** @internal */
     void tableColumnsResized (TableHeaderComponent*) override;
@@ -642,10 +642,9 @@ struct TextEditor::Iterator
         return bottom * 0.5f;
     }
 
-    int getTotalTextHeight()
+    // Call this once next() has returned false
+    int getHeightOfLaidOutText()
     {
-        while (next()) {}
-
         auto height = lineY + lineHeight + getYOffset();
 
         if (atom != nullptr && atom->isNewLine())
@@ -654,24 +653,42 @@ struct TextEditor::Iterator
         return roundToInt (height);
     }
 
-    int getTextRight()
+    Rectangle<int> getTextBounds (Range<int> range) const
     {
-        float maxWidth = 0.0f;
+        auto startX = indexToX (range.getStart());
+        auto endX   = indexToX (range.getEnd());
 
-        while (next())
-            maxWidth = jmax (maxWidth, atomRight);
+        return Rectangle<float> (startX, lineY, endX - startX, lineHeight * lineSpacing).getSmallestIntegerContainer();
+    }
 
-        return roundToInt (maxWidth);
+    //==============================================================================
+    // Compares two freshly-created iterators
+    bool hasSameLayoutSettingsAs (const Iterator& other) const noexcept
+    {
+        return justification == other.justification
+            && exactlyEqual (bottomRight.x, other.bottomRight.x)
+            && exactlyEqual (wordWrapWidth, other.wordWrapWidth)
+            && passwordCharacter == other.passwordCharacter
+            && exactlyEqual (lineSpacing, other.lineSpacing)
+            && exactlyEqual (bottomRight.y, other.bottomRight.y)
+            && underlineWhitespace == other.underlineWhitespace
+            && exactlyEqual (lineHeight, other.lineHeight);
     }
 
-    Rectangle<int> getTextBounds (Range<int> range) const
+    // When a copy of an iterator is kept around, the sections in front of it may have been
+    // reallocated by an edit further on in the text, so this re-fetches the pointers.
+    void refreshPointers()
     {
-        auto startX = indexToX (range.getStart());
-        auto endX   = indexToX (range.getEnd());
+        jassert (isPositiveAndBelow (sectionIndex, sections.size()));
+        currentSection = sections.getUnchecked (sectionIndex);
+        jassert (atomIndex <= currentSection->atoms.size());
 
-        return Rectangle<float> (startX, lineY, endX - startX, lineHeight * lineSpacing).getSmallestIntegerContainer();
+        if (atom != nullptr)
+            atom = &currentSection->atoms.getReference (atomIndex - 1);
     }
 
+    int getSectionIndex() const noexcept    { return sectionIndex; }
+
     //==============================================================================
     int indexInText = 0;
     float lineY = 0, lineHeight = 0, maxDescent = 0;
@@ -748,6 +765,94 @@ private:
     JUCE_LEAK_DETECTOR (Iterator)
 };
 
+//==============================================================================
+/*  Keeps copies of the layout iterator taken at paragraph boundaries, so that re-laying out
+    the text after an edit, painting a scrolled region, or hit-testing a point can resume from
+    the nearest paragraph instead of walking through the whole document from its start.
+*/
+struct TextEditor::LayoutCheckpoints
+{
+    struct Checkpoint
+    {
+        Iterator iterator;
+        int endIndex;       // the index just after the newline atom the iterator is sitting on
+        float lineBottom;   // the bottom of the line containing that newline
+        float textRight;    // the widest atom right-hand edge up to this point
+    };
+
+    // Only returns checkpoints that are still valid for the editor's current layout settings
+    const Checkpoint* findLastBeforeIndex (const Iterator& fresh, int index) const
+    {
+        return findLast (fresh, [index] (const Checkpoint& c) { return c.endIndex < index; });
+    }
+
+    const Checkpoint* findLastAboveY (const Iterator& fresh, float y) const
+    {
+        return findLast (fresh, [y] (const Checkpoint& c) { return c.lineBottom < y; });
+    }
+
+    const Checkpoint* getLast (const Iterator& fresh) const
+    {
+        return findLast (fresh, [] (const Checkpoint&) { return true; });
+    }
+
+    void add (const Iterator& i, float lineSpacing, float textRight)
+    {
+        jassert (i.atom != nullptr && i.atom->isNewLine());
+
+        const auto endIndex = i.indexInText + i.atom->numChars;
+
+        if (checkpoints.empty() || endIndex - checkpoints.back().endIndex >= minCharsBetweenCheckpoints)
+            checkpoints.push_back ({ i, endIndex, i.lineY + i.lineHeight * jmax (1.0f, lineSpacing), textRight });
+    }
+
+    void startAgain (const Iterator& fresh)
+    {
+        checkpoints.clear();
+        settings.reset();
+        settings.emplace (fresh);
+    }
+
+    // Must be called before the text at or after this index is modified
+    void invalidateFrom (int index)
+    {
+        while (! checkpoints.empty() && checkpoints.back().endIndex >= index)
+            checkpoints.pop_back();
+    }
+
+    // Must be called before the sections from this one onwards are merged or renumbered
+    void invalidateFromSection (int sectionIndex)
+    {
+        while (! checkpoints.empty() && checkpoints.back().iterator.getSectionIndex() >= sectionIndex)
+            checkpoints.pop_back();
+    }
+
+    void invalidateAll()
+    {
+        checkpoints.clear();
+        settings.reset();
+    }
+
+private:
+    static constexpr int minCharsBetweenCheckpoints = 256;
+
+    std::vector<Checkpoint> checkpoints;
+    std::optional<Iterator> settings;
+
+    template <typename Predicate>
+    const Checkpoint* findLast (const Iterator& fresh, Predicate&& isBefore) const
+    {
+        if (! settings.has_value() || ! settings->hasSameLayoutSettingsAs (fresh))
+            return nullptr;
+
+        auto it = std::partition_point (checkpoints.begin(), checkpoints.end(), isBefore);
+
+        if (it == checkpoints.begin())
+            return nullptr;
+
+        return &*std::prev (it);
+    }
+};
 
 //==============================================================================
 struct TextEditor::InsertAction final : public UndoableAction
@@ -951,6 +1056,8 @@ TextEditor::TextEditor (const String& name, juce_wchar passwordChar)
     viewport->setWantsKeyboardFocus (false);
     viewport->setScrollBarsShown (false, false);
 
+    layoutCheckpoints = std::make_unique<LayoutCheckpoints>();
+
     setWantsKeyboardFocus (true);
     recreateCaret();
 }
@@ -1101,6 +1208,7 @@ void TextEditor::applyFontToAllText (const Font& newFont, bool changeCurrentFont
         currentFont = newFont;
 
     auto overallColour = findColour (textColourId);
+    layoutCheckpoints->invalidateAll();
 
     for (auto* uts : sections)
     {
@@ -1116,6 +1224,8 @@ void TextEditor::applyFontToAllText (const Font& newFont, bool changeCurrentFont
 
 void TextEditor::applyColourToAllText (const Colour& newColour, bool changeCurrentTextColour)
 {
+    layoutCheckpoints->invalidateAll();
+
     for (auto* uts : sections)
         uts->colour = newColour;
 
@@ -1362,7 +1472,7 @@ void TextEditor::repaintText (Range<int> range)
             return;
         }
 
-        Iterator i (*this);
+        auto i = getIteratorBefore (range.getStart());
 
         Point<float> anchor;
         auto lh = currentFont.getHeight();
@@ -1476,7 +1586,7 @@ Point<int> TextEditor::getTextOffset() const noexcept
 RectangleList<int> TextEditor::getTextBounds (Range<int> textRange) const
 {
     RectangleList<int> boundingBox;
-    Iterator i (*this);
+    auto i = getIteratorBefore (textRange.getStart());
 
     while (i.next())
     {
@@ -1511,13 +1621,66 @@ int TextEditor::getMaximumTextHeight() const
     return jmax (1, viewport->getMaximumVisibleHeight() - topIndent);
 }
 
+TextEditor::Iterator TextEditor::getIteratorBefore (int index) const
+{
+    Iterator fresh (*this);
+
+    if (auto* checkpoint = layoutCheckpoints->findLastBeforeIndex (fresh, index))
+    {
+        Iterator i (checkpoint->iterator);
+        i.refreshPointers();
+        return i;
+    }
+
+    return fresh;
+}
+
+TextEditor::Iterator TextEditor::getIteratorAbove (float y) const
+{
+    Iterator fresh (*this);
+
+    if (auto* checkpoint = layoutCheckpoints->findLastAboveY (fresh, y))
+    {
+        Iterator i (checkpoint->iterator);
+        i.refreshPointers();
+        return i;
+    }
+
+    return fresh;
+}
+
 void TextEditor::checkLayout()
 {
     if (getWordWrapWidth() > 0)
     {
-        const auto textBottom = Iterator (*this).getTotalTextHeight() + topIndent;
+        // Only the text after the last paragraph that's unaffected by any edits needs laying out again
+        const Iterator fresh (*this);
+        const auto* checkpoint = layoutCheckpoints->getLast (fresh);
+
+        Iterator i (checkpoint != nullptr ? checkpoint->iterator : fresh);
+        auto maxAtomRight = 0.0f;
+
+        if (checkpoint != nullptr)
+        {
+            i.refreshPointers();
+            maxAtomRight = checkpoint->textRight;
+        }
+        else
+        {
+            layoutCheckpoints->startAgain (fresh);
+        }
+
+        while (i.next())
+        {
+            maxAtomRight = jmax (maxAtomRight, i.atomRight);
+
+            if (i.atom->isNewLine())
+                layoutCheckpoints->add (i, lineSpacing, maxAtomRight);
+        }
+
+        const auto textBottom = i.getHeightOfLaidOutText() + topIndent;
         const auto textRight = jmax (viewport->getMaximumVisibleWidth(),
-                                     Iterator (*this).getTextRight() + leftIndent + rightEdgeSpace);
+                                     roundToInt (maxAtomRight) + leftIndent + rightEdgeSpace);
 
         textHolder->setSize (textRight, textBottom);
         viewport->setScrollBarsShown (scrollbarVisible && multiline && textBottom > viewport->getMaximumVisibleHeight(),
@@ -1734,7 +1897,7 @@ void TextEditor::drawContent (Graphics& g)
             clip.setY (roundToInt ((float) clip.getY() - yOffset));
         }
 
-        Iterator i (*this);
+        auto i = getIteratorAbove ((float) clip.getY());
         Colour selectedTextColour;
 
         if (! selection.isEmpty())
@@ -1769,7 +1932,7 @@ void TextEditor::drawContent (Graphics& g)
 
         for (auto& underlinedSection : underlinedSections)
         {
-            Iterator i2 (*this);
+            auto i2 = getIteratorAbove ((float) clip.getY());
 
             while (i2.next() && i2.lineY < (float) clip.getBottom())
             {
@@ -2347,6 +2510,7 @@ void TextEditor::insert (const String& text, int insertIndex, const Font& font,
         {
             repaintText ({ insertIndex, getTotalNumChars() }); // must do this before and after changing the data, in case
                                                                // a line gets moved due to word wrap
+            layoutCheckpoints->invalidateFrom (insertIndex);
 
             int index = 0;
             int nextIndex = 0;
@@ -2388,6 +2552,8 @@ void TextEditor::insert (const String& text, int insertIndex, const Font& font,
 
 void TextEditor::reinsert (int insertIndex, const OwnedArray<UniformTextSection>& sectionsToInsert)
 {
+    layoutCheckpoints->invalidateFrom (insertIndex);
+
     int index = 0;
     int nextIndex = 0;
 
@@ -2429,6 +2595,8 @@ void TextEditor::remove (Range<int> range, UndoManager* const um, const int care
 {
     if (! range.isEmpty())
     {
+        layoutCheckpoints->invalidateFrom (range.getStart());
+
         int index = 0;
 
         for (int i = 0; i < sections.size(); ++i)
@@ -2597,7 +2765,7 @@ void TextEditor::getCharPosition (int index, Point<float>& anchor, float& lineHe
         }
         else
         {
-            i.getCharPosition (index, anchor, lineHeight);
+            getIteratorBefore (index).getCharPosition (index, anchor, lineHeight);
         }
     }
 }
@@ -2606,7 +2774,7 @@ int TextEditor::indexAtPosition (const float x, const float y) const
 {
     if (getWordWrapWidth() > 0)
     {
-        for (Iterator i (*this); i.next();)
+        for (auto i = getIteratorAbove (y); i.next();)
         {
             if (y < i.lineY + (i.lineHeight * lineSpacing))
             {
@@ -2691,6 +2859,7 @@ void TextEditor::coalesceSimilarSections()
         if (s1->font == s2->font
              && s1->colour == s2->colour)
         {
+            layoutCheckpoints->invalidateFromSection (i);
             s1->append (*s2);
             sections.remove (i + 1);
             --i;
@@ -2783,4 +2952,77 @@ std::unique_ptr<AccessibilityHandler> TextEditor::createAccessibilityHandler()
     return std::make_unique<EditorAccessibilityHandler> (*this);
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct TextEditorTests final : public UnitTest
+{
+    TextEditorTests()
+        : UnitTest ("TextEditor", UnitTestCategories::gui)
+    {}
+
+    static std::unique_ptr<TextEditor> createEditor()
+    {
+        auto editor = std::make_unique<TextEditor>();
+        editor->setMultiLine (true, true);
+        editor->setSize (200, 300);
+        return editor;
+    }
+
+    // Compares the layout of an editor against a newly-created one containing the same text
+    void expectSameLayoutAsNewEditor (TextEditor& editor)
+    {
+        auto fresh = createEditor();
+        fresh->setText (editor.getText(), false);
+
+        expectEquals (editor.getTextHeight(), fresh->getTextHeight());
+
+        // (the bounds are relative to the scroll position, so this compares them relative to the first character)
+        const auto origin      = editor.getTextBounds ({ 0, 1 }).getBounds().getPosition();
+        const auto freshOrigin = fresh->getTextBounds ({ 0, 1 }).getBounds().getPosition();
+
+        for (int i = 0; i < editor.getTotalNumChars(); i += 37)
+            expect (editor.getTextBounds ({ i, i + 1 }).getBounds() - origin == fresh->getTextBounds ({ i, i + 1 }).getBounds() - freshOrigin);
+
+        for (int y = 0; y < fresh->getTextHeight(); y += 50)
+            expectEquals (editor.getTextIndexAt (origin.translated (50, y)), fresh->getTextIndexAt (freshOrigin.translated (50, y)));
+    }
+
+    void runTest() override
+    {
+        beginTest ("Editing after recolouring the text keeps the layout consistent");
+        {
+            auto editor = createEditor();
+            const Colour colours[] { Colours::red, Colours::green, Colours::blue };
+
+            // paragraphs in different colours, so that there are several sections
+            for (int i = 0; i < 30; ++i)
+            {
+                editor->setColour (TextEditor::textColourId, colours[i % 3]);
+                editor->insertTextAtCaret (String::repeatedString ("word ", 60 + i) + "\n");
+            }
+
+            expectSameLayoutAsNewEditor (*editor);
+
+            // the sections can now all be merged, the next time the text is edited
+            editor->applyColourToAllText (Colours::black);
+
+            editor->setCaretPosition (editor->getTotalNumChars() / 2);
+            editor->insertTextAtCaret ("some more words\n");
+            expectSameLayoutAsNewEditor (*editor);
+
+            editor->setColour (TextEditor::textColourId, Colours::orange);
+            editor->setCaretPosition (editor->getTotalNumChars() - 10);
+            editor->insertTextAtCaret ("a different colour\n");
+            editor->setHighlightedRegion ({ 100, 2000 });
+            editor->insertTextAtCaret ("x");
+            expectSameLayoutAsNewEditor (*editor);
+        }
+    }
+};
+
+static TextEditorTests textEditorUnitTests;
+
+#endif
+
 } // namespace juce
@@ -776,6 +776,7 @@ private:
     //==============================================================================
     JUCE_PUBLIC_IN_DLL_BUILD (class UniformTextSection)
     struct Iterator;
+    struct LayoutCheckpoints;
     struct TextHolderComponent;
     struct TextEditorViewport;
     struct InsertAction;
@@ -829,6 +830,7 @@ private:
     mutable int totalNumChars = 0;
     int caretPosition = 0;
     OwnedArray<UniformTextSection> sections;
+    std::unique_ptr<LayoutCheckpoints> layoutCheckpoints;
     String textToShowWhenEmpty;
     Colour colourForTextWhenEmpty;
     juce_wchar passwordCharacter;
@@ -868,6 +870,8 @@ private:
     int findWordBreakBefore (int position) const;
     bool moveCaretWithTransaction (int newPos, bool selecting);
     void drawContent (Graphics&);
+    Iterator getIteratorBefore (int index) const;
+    Iterator getIteratorAbove (float y) const;
     void checkLayout();
     int getWordWrapWidth() const;
     int getMaximumTextWidth() const;
@@ -641,27 +641,28 @@ private:
                                                                                            : nextItem;
     }
 
-    template <typename Fn>
-    static void forEachDepthFirst (TreeViewItem* item, bool includeItem, Fn&& callback)
+    /*  Finds the first row, in depth-first order, for which the predicate is true. The predicate
+        must be false for all the rows before that one and true for all the rows after it, which
+        lets us binary-search each level of the tree rather than visiting every open item.
+    */
+    template <typename Predicate>
+    static TreeViewItem* findFirstItemWhere (TreeViewItem* item, bool includeItem, Predicate&& predicate)
     {
-        if (includeItem)
-            callback (item);
+        if (includeItem && predicate (item))
+            return item;
 
-        if (item->isOpen())
-            for (auto i = 0; i < item->getNumSubItems(); ++i)
-                forEachDepthFirst (item->getSubItem (i), true, callback);
-    }
+        if (! item->isOpen())
+            return nullptr;
 
-    std::vector<TreeViewItem*> collectAllItems() const
-    {
-        size_t count{};
-        forEachDepthFirst (owner.rootItem, owner.rootItemVisible, [&] (auto*) { ++count; });
+        const auto& subItems = item->subItems;
+        const auto next = std::partition_point (subItems.begin(), subItems.end(), [&] (auto* subItem) { return ! predicate (subItem); });
 
-        std::vector<TreeViewItem*> allItems;
-        allItems.reserve (count);
-        forEachDepthFirst (owner.rootItem, owner.rootItemVisible, [&] (auto* item) { allItems.push_back (item); });
+        // The row we're looking for may be one of the children of the last sub-item that fails the test
+        if (next != subItems.begin())
+            if (auto* found = findFirstItemWhere (*std::prev (next), false, predicate))
+                return found;
 
-        return allItems;
+        return next != subItems.end() ? *next : nullptr;
     }
 
     std::vector<TreeViewItem*> getAllVisibleItems() const
@@ -671,27 +672,33 @@ private:
 
         const auto visibleTop = -getY();
         const auto visibleBottom = visibleTop + getParentHeight();
-        auto allItems = collectAllItems();
+        const auto numRows = owner.getNumRowsInTree();
 
-        const auto lower = std::lower_bound (allItems.begin(), allItems.end(), visibleTop, [] (TreeViewItem* item, const auto y)
+        const auto getRowOfFirstItemWhere = [&] (auto&& predicate)
         {
-            return item->y + item->getItemHeight() < y;
+            auto* item = findFirstItemWhere (owner.rootItem, owner.rootItemVisible, predicate);
+            return item != nullptr ? item->getRowNumberInTree() : numRows;
+        };
+
+        const auto lower = getRowOfFirstItemWhere ([visibleTop] (TreeViewItem* item)
+        {
+            return item->y + item->getItemHeight() >= visibleTop;
         });
 
-        const auto upper = std::upper_bound (allItems.begin(), allItems.end(), visibleBottom, [] (const auto y, TreeViewItem* item)
+        const auto upper = getRowOfFirstItemWhere ([visibleBottom] (TreeViewItem* item)
         {
-            return y < item->y;
+            return visibleBottom < item->y;
         });
 
-        const std::ptrdiff_t padding = 2;
+        const auto padding = 2;
 
-        const auto frontToErase = std::max (padding, std::distance (allItems.begin(), lower)) - padding;
-        const auto backToErase  = std::max (padding, std::distance (upper, allItems.end()))   - padding;
+        std::vector<TreeViewItem*> items;
 
-        allItems.erase (allItems.begin(), std::next (allItems.begin(), frontToErase));
-        allItems.erase (std::prev (allItems.end(), backToErase), allItems.end());
+        for (auto row = jmax (0, lower - padding), end = jmin (numRows, upper + padding); row < end; ++row)
+            if (auto* item = owner.getItemOnRow (row))
+                items.push_back (item);
 
-        return allItems;
+        return items;
     }
 
     //==============================================================================
@@ -1364,6 +1371,7 @@ bool TreeView::keyPressed (const KeyPress& key)
 
 void TreeView::updateVisibleItems (std::optional<Point<int>> viewportPosition)
 {
+    ++rowStructureVersion;
     viewport->recalculatePositions (TreeViewport::Async::yes, std::move (viewportPosition));
 }
 
@@ -1927,6 +1935,7 @@ const TreeViewItem* TreeViewItem::getDeepestOpenParentItem() const noexcept
 void TreeViewItem::setOwnerView (TreeView* const newOwner) noexcept
 {
     ownerView = newOwner;
+    numRowsCacheVersion = 0;
 
     for (auto* i : subItems)
     {
@@ -1987,11 +1996,26 @@ TreeViewItem* TreeViewItem::getTopLevelItem() noexcept
 
 int TreeViewItem::getNumRows() const noexcept
 {
+    // The row counts stay valid until the owner's structure changes, which bumps its version number
+    if (ownerView != nullptr && numRowsCacheVersion == ownerView->rowStructureVersion)
+        return numRows;
+
     int num = 1;
 
     if (isOpen())
+    {
         for (auto* i : subItems)
+        {
+            i->rowOffsetInParent = num;
             num += i->getNumRows();
+        }
+    }
+
+    if (ownerView != nullptr)
+    {
+        numRows = num;
+        numRowsCacheVersion = ownerView->rowStructureVersion;
+    }
 
     return num;
 }
@@ -2001,22 +2025,16 @@ TreeViewItem* TreeViewItem::getItemOnRow (int index) noexcept
     if (index == 0)
         return this;
 
-    if (index > 0 && isOpen())
+    if (index > 0 && isOpen() && index < getNumRows())
     {
-        --index;
-
-        for (auto* i : subItems)
+        // getNumRows() has updated the sub-items' row offsets, so we can binary-search them
+        const auto next = std::upper_bound (subItems.begin(), subItems.end(), index, [] (int row, const TreeViewItem* item)
         {
-            if (index == 0)
-                return i;
-
-            auto numRows = i->getNumRows();
-
-            if (numRows > index)
-                return i->getItemOnRow (index);
+            return row < item->rowOffsetInParent;
+        });
 
-            index -= numRows;
-        }
+        auto* item = *std::prev (next);
+        return item->getItemOnRow (index - item->rowOffsetInParent);
     }
 
     return nullptr;
@@ -2064,13 +2082,12 @@ int TreeViewItem::getRowNumberInTree() const noexcept
         if (! parentItem->isOpen())
             return parentItem->getRowNumberInTree();
 
-        auto n = 1 + parentItem->getRowNumberInTree();
+        jassert (parentItem->subItems.contains (this));
 
-        auto ourIndex = parentItem->subItems.indexOf (this);
-        jassert (ourIndex >= 0);
+        // This updates our rowOffsetInParent if the parent's row count is out of date
+        parentItem->getNumRows();
 
-        while (--ourIndex >= 0)
-            n += parentItem->subItems [ourIndex]->getNumRows();
+        auto n = parentItem->getRowNumberInTree() + rowOffsetInParent;
 
         if (parentItem->parentItem == nullptr
              && ! ownerView->rootItemVisible)
@@ -2283,4 +2300,100 @@ void TreeViewItem::draw (Graphics& g, int width, bool isMouseOverButton)
     }
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TreeViewTests final : public UnitTest
+{
+public:
+    TreeViewTests() : UnitTest ("TreeView", UnitTestCategories::gui) {}
+
+    void runTest() override
+    {
+        beginTest ("Row numbers match a depth-first walk of the open items");
+        {
+            TreeView tree;
+            auto* root = new TestItem (0);
+            tree.setRootItem (root);
+            root->setOpen (true);
+
+            Random random (getRandom().nextInt64());
+            std::vector<TreeViewItem*> items { root };
+
+            for (int i = 1; i < 500; ++i)
+            {
+                auto* parent = items[(size_t) random.nextInt ((int) items.size())];
+                auto* item = new TestItem (random.nextInt (100));
+                parent->addSubItem (item, random.nextInt (parent->getNumSubItems() + 1));
+                items.push_back (item);
+            }
+
+            for (int i = 0; i < 200; ++i)
+            {
+                auto* item = items[(size_t) random.nextInt ((int) items.size())];
+
+                switch (random.nextInt (5))
+                {
+                    case 0:  item->setOpen (! item->isOpen()); break;
+                    case 1:  item->setOpenness (TreeViewItem::Openness::opennessDefault); break;
+                    case 2:  tree.setDefaultOpenness (! tree.areItemsOpenByDefault()); break;
+                    case 3:  tree.setRootItemVisible (! tree.isRootItemVisible()); break;
+                    default: { TestItem::Comparator comparator; item->sortSubItems (comparator); break; }
+                }
+
+                expect (rowsMatchDepthFirstOrder (tree));
+            }
+
+            tree.deleteRootItem();
+        }
+    }
+
+private:
+    struct TestItem final : public TreeViewItem
+    {
+        explicit TestItem (int v) : value (v) {}
+
+        bool mightContainSubItems() override  { return getNumSubItems() > 0; }
+
+        struct Comparator
+        {
+            static int compareElements (TreeViewItem* a, TreeViewItem* b)
+            {
+                return static_cast<TestItem*> (a)->value - static_cast<TestItem*> (b)->value;
+            }
+        };
+
+        int value;
+    };
+
+    static void addOpenItems (TreeViewItem& item, bool includeItem, std::vector<TreeViewItem*>& result)
+    {
+        if (includeItem)
+            result.push_back (&item);
+
+        if (item.isOpen())
+            for (int i = 0; i < item.getNumSubItems(); ++i)
+                addOpenItems (*item.getSubItem (i), true, result);
+    }
+
+    static bool rowsMatchDepthFirstOrder (const TreeView& tree)
+    {
+        std::vector<TreeViewItem*> expected;
+        addOpenItems (*tree.getRootItem(), tree.isRootItemVisible(), expected);
+
+        if (tree.getNumRowsInTree() != (int) expected.size())
+            return false;
+
+        for (int row = 0; row < (int) expected.size(); ++row)
+            if (tree.getItemOnRow (row) != expected[(size_t) row] || expected[(size_t) row]->getRowNumberInTree() != row)
+                return false;
+
+        return tree.getItemOnRow ((int) expected.size()) == nullptr;
+    }
+};
+
+static TreeViewTests treeViewTests;
+
+#endif
+
 } // namespace juce
@@ -132,6 +132,7 @@ public:
     void sortSubItems (ElementComparator& comparator)
     {
         subItems.sort (comparator);
+        numRowsCacheVersion = 0;
     }
 
     //==============================================================================
@@ -644,6 +645,8 @@ private:
 
     Openness openness = Openness::opennessDefault;
     int y = 0, itemHeight = 0, totalHeight = 0, itemWidth = 0, totalWidth = 0, uid = 0;
+    mutable int numRows = 1, rowOffsetInParent = 0;
+    mutable uint64 numRowsCacheVersion = 0;
     bool selected = false, redrawNeeded = true, drawLinesInside = false, drawLinesSet = false,
          drawsInLeftMargin = false, drawsInRightMargin = false;
 
@@ -961,6 +964,7 @@ private:
     std::unique_ptr<InsertPointHighlight> dragInsertPointHighlight;
     std::unique_ptr<TargetGroupHighlight> dragTargetGroupHighlight;
     int indentSize = -1;
+    uint64 rowStructureVersion = 1;
     bool defaultOpenness = false, rootItemVisible = true, multiSelectEnabled = false, openCloseButtonsVisible = true;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TreeView)
@@ -114,6 +114,7 @@ void ComponentPeer::handleMagnifyGesture (MouseInputSource::InputSourceType type
 //==============================================================================
 void ComponentPeer::handlePaint (LowLevelGraphicsContext& contextToPaintTo)
 {
+    const auto startTime = Time::getMillisecondCounterHiRes();
     Graphics g (contextToPaintTo);
 
     if (component.isTransformed())
@@ -169,6 +170,8 @@ void ComponentPeer::handlePaint (LowLevelGraphicsContext& contextToPaintTo)
     */
     jassert (roundToInt (10.1f) == 10);
 
+    currentFrameStatistics.paintMs += Time::getMillisecondCounterHiRes() - startTime;
+    ++currentFrameStatistics.numPaints;
     ++peerFrameNumber;
 }
 
@@ -619,7 +622,11 @@ void ComponentPeer::forceDisplayUpdate()
 
 void ComponentPeer::callVBlankListeners (double timestampSec)
 {
+    lastFrameStatistics = std::exchange (currentFrameStatistics, {});
+
+    const auto startTime = Time::getMillisecondCounterHiRes();
     vBlankListeners.call ([timestampSec] (auto& l) { l.onVBlank (timestampSec); });
+    currentFrameStatistics.updateMs = Time::getMillisecondCounterHiRes() - startTime;
 }
 
 void ComponentPeer::globalFocusChanged ([[maybe_unused]] Component* comp)
@@ -578,11 +578,50 @@ public:
     */
     uint64_t getNumFramesPainted() const { return peerFrameNumber; }
 
+    //==============================================================================
+    /** Describes how long the work done for one frame of this peer took. */
+    struct FrameStatistics
+    {
+        /** Milliseconds spent in the VBlankListener callbacks, which is where animators and
+            VBlankAttachments update the interface.
+        */
+        double updateMs = 0.0;
+
+        /** Milliseconds spent painting the component hierarchy. */
+        double paintMs = 0.0;
+
+        /** Milliseconds spent handing the painted pixels over to the window system.
+
+            This is only measured on platforms where the peer does this itself, which is
+            currently just Linux. Elsewhere it's always zero.
+        */
+        double presentMs = 0.0;
+
+        /** The number of times the peer was painted during the frame. */
+        int numPaints = 0;
+    };
+
+    /** Returns the statistics for the most recently completed frame.
+
+        A frame starts with a vertical blank callback, and includes all the painting that happens
+        before the next one. There's no separate layout phase to measure, because components
+        are laid out as soon as their bounds change, so that time is counted as part of whatever
+        caused the change.
+
+        @see VBlankListener
+    */
+    FrameStatistics getLastFrameStatistics() const noexcept { return lastFrameStatistics; }
+
 protected:
     //==============================================================================
     static void forceDisplayUpdate();
     void callVBlankListeners (double timestampSec);
 
+    /** Peers that copy their painted pixels to the screen themselves should call this with
+        the time that took, so that it's included in the frame statistics.
+    */
+    void addFramePresentTime (double milliseconds) noexcept { currentFrameStatistics.presentMs += milliseconds; }
+
     Component& component;
     const int styleFlags;
     Rectangle<int> lastNonFullscreenBounds;
@@ -593,6 +632,8 @@ protected:
     Style style = Style::automatic;
 
 private:
+    FrameStatistics currentFrameStatistics, lastFrameStatistics;
+
     //==============================================================================
     virtual void appStyleChanged() {}
 
@@ -381,12 +381,12 @@ private:
 
     void codeDocumentTextInserted (const String& newText, int pos) override
     {
-        owner.codeDocumentChanged (pos, pos + newText.length());
+        owner.codeDocumentChanged (pos, pos + newText.length(), newText.length());
     }
 
     void codeDocumentTextDeleted (int start, int end) override
     {
-        owner.codeDocumentChanged (start, end);
+        owner.codeDocumentChanged (start, end, start - end);
     }
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Pimpl)
@@ -660,12 +660,17 @@ void CodeEditorComponent::rebuildLineTokens()
         gutter->documentChanged (document, firstLineOnScreen);
 }
 
-void CodeEditorComponent::codeDocumentChanged (const int startIndex, const int endIndex)
+void CodeEditorComponent::codeDocumentChanged (const int startIndex, const int endIndex, const int lengthDelta)
 {
     const CodeDocument::Position affectedTextStart (document, startIndex);
     const CodeDocument::Position affectedTextEnd (document, endIndex);
 
-    retokenise (startIndex, endIndex);
+    // The text that followed the edit hasn't changed, so the token boundaries that were
+    // found in it can be reused as soon as retokenising catches up with one of them
+    clearCachedIterators (affectedTextStart.getLineNumber(),
+                          lengthDelta > 0 ? startIndex : endIndex,
+                          lengthDelta);
+    rebuildLineTokensAsync();
 
     updateCaretPosition();
     columnToTryToMaintain = -1;
@@ -682,11 +687,11 @@ void CodeEditorComponent::codeDocumentChanged (const int startIndex, const int e
     updateScrollBars();
 }
 
-void CodeEditorComponent::retokenise (int startIndex, [[maybe_unused]] int endIndex)
+void CodeEditorComponent::retokenise (int startIndex, int endIndex)
 {
     const CodeDocument::Position affectedTextStart (document, startIndex);
 
-    clearCachedIterators (affectedTextStart.getLineNumber());
+    clearCachedIterators (affectedTextStart.getLineNumber(), endIndex, 0);
 
     rebuildLineTokensAsync();
 }
@@ -1743,6 +1748,77 @@ void CodeEditorComponent::clearCachedIterators (const int firstLineToBeInvalid)
             break;
 
     cachedIterators.removeRange (jmax (0, i - 1), cachedIterators.size());
+    unconfirmedCachedPositions.clear();
+}
+
+void CodeEditorComponent::clearCachedIterators (const int firstLineToBeInvalid,
+                                                const int firstUnchangedPosition,
+                                                const int lengthDelta)
+{
+    // Each edit produces a new group of positions, because landing on one of them only tells us
+    // that the rest of the same group will match up; older groups still need checking separately.
+    Array<Array<int>> groupsAfterEdit;
+
+    const auto addGroup = [&] (const Array<int>& positions)
+    {
+        Array<int> shifted;
+
+        for (auto pos : positions)
+            if (pos >= firstUnchangedPosition)
+                shifted.add (pos + lengthDelta);
+
+        if (! shifted.isEmpty())
+            groupsAfterEdit.add (std::move (shifted));
+    };
+
+    Array<int> cachedPositions;
+
+    for (auto& t : cachedIterators)
+        cachedPositions.add (t.getPosition());
+
+    addGroup (cachedPositions);
+
+    for (auto& group : unconfirmedCachedPositions)
+        addGroup (group);
+
+    clearCachedIterators (firstLineToBeInvalid);
+    unconfirmedCachedPositions.swapWith (groupsAfterEdit);
+}
+
+bool CodeEditorComponent::confirmCachedPositions (const CodeDocument::Iterator& tokenStart)
+{
+    const auto pos = tokenStart.getPosition();
+
+    while (! unconfirmedCachedPositions.isEmpty())
+    {
+        auto& group = unconfirmedCachedPositions.getReference (0);
+        auto numToSkip = 0;
+
+        while (numToSkip < group.size() && group.getUnchecked (numToSkip) < pos)
+            ++numToSkip;
+
+        group.removeRange (0, numToSkip);
+
+        if (group.isEmpty())
+        {
+            unconfirmedCachedPositions.remove (0);
+            continue;
+        }
+
+        if (group.getFirst() != pos)
+            return false;
+
+        // Tokenising has landed on a boundary that was also found before the edit, so from here on
+        // it would produce exactly the same tokens as it did last time. (The caller already has an
+        // iterator at this boundary, so only the ones after it are added.)
+        for (int i = 1; i < group.size(); ++i)
+            cachedIterators.add (CodeDocument::Iterator (CodeDocument::Position (document, group.getUnchecked (i))));
+
+        unconfirmedCachedPositions.remove (0);
+        return true;
+    }
+
+    return false;
 }
 
 void CodeEditorComponent::updateCachedIterators (int maxLineNum)
@@ -1770,7 +1846,7 @@ void CodeEditorComponent::updateCachedIterators (int maxLineNum)
             {
                 codeTokeniser->readNextToken (t);
 
-                if (t.getLine() >= targetLine)
+                if (confirmCachedPositions (t) || t.getLine() >= targetLine)
                     break;
 
                 if (t.isEOF())
@@ -1784,16 +1860,24 @@ void CodeEditorComponent::getIteratorForPosition (int position, CodeDocument::It
 {
     if (codeTokeniser != nullptr)
     {
-        for (int i = cachedIterators.size(); --i >= 0;)
+        // Moves the source on to the last cached iterator before the position, if that's further on
+        const auto skipToCachedIterator = [this, position, &source]
         {
-            auto& t = cachedIterators.getReference (i);
-
-            if (t.getPosition() <= position)
+            for (int i = cachedIterators.size(); --i >= 0;)
             {
-                source = t;
-                break;
+                auto& t = cachedIterators.getReference (i);
+
+                if (t.getPosition() <= position)
+                {
+                    if (t.getPosition() > source.getPosition())
+                        source = t;
+
+                    break;
+                }
             }
-        }
+        };
+
+        skipToCachedIterator();
 
         while (source.getPosition() < position)
         {
@@ -1805,6 +1889,9 @@ void CodeEditorComponent::getIteratorForPosition (int position, CodeDocument::It
                 source = original;
                 break;
             }
+
+            if (confirmCachedPositions (source))
+                skipToCachedIterator();
         }
     }
 }
@@ -1858,4 +1945,127 @@ std::unique_ptr<AccessibilityHandler> CodeEditorComponent::createAccessibilityHa
     return std::make_unique<CodeEditorAccessibilityHandler> (*this);
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct CodeEditorComponentTests final : public UnitTest
+{
+    CodeEditorComponentTests()
+        : UnitTest ("CodeEditorComponent", UnitTestCategories::gui)
+    {}
+
+    // Records every position that the editor starts reading a token from
+    struct RecordingTokeniser final : public CPlusPlusCodeTokeniser
+    {
+        int readNextToken (CodeDocument::Iterator& source) override
+        {
+            startPositions.push_back (source.getPosition());
+            return CPlusPlusCodeTokeniser::readNextToken (source);
+        }
+
+        std::vector<int> startPositions;
+    };
+
+    static std::set<int> getTokenBoundaries (const String& text)
+    {
+        CodeDocument document;
+        document.replaceAllContent (text);
+
+        CPlusPlusCodeTokeniser tokeniser;
+        CodeDocument::Iterator source (document);
+        std::set<int> boundaries;
+
+        while (source.getPosition() < document.getNumCharacters())
+        {
+            boundaries.insert (source.getPosition());
+            tokeniser.readNextToken (source);
+        }
+
+        boundaries.insert (document.getNumCharacters());
+        return boundaries;
+    }
+
+    // Scrolls through the document, and checks that all the tokenising started from proper token
+    // boundaries, which it won't have done if any of the cached positions were wrong
+    void expectCachedPositionsAreValid (CodeEditorComponent& editor, RecordingTokeniser& tokeniser)
+    {
+        tokeniser.startPositions.clear();
+        editor.scrollToLine (0);
+        editor.scrollToLine (editor.getDocument().getNumLines() - 10);
+
+        const auto boundaries = getTokenBoundaries (editor.getDocument().getAllContent());
+
+        for (auto pos : tokeniser.startPositions)
+            expect (boundaries.count (pos) != 0, "Tokenised from " + String (pos) + ", which isn't a token boundary");
+    }
+
+    void runTest() override
+    {
+        String text;
+
+        for (int i = 0; i < 500; ++i)
+            text << "int function" << i << " (int x)\n{\n    /* a comment */ return x + " << i << "; // \"string\"\n}\n\n";
+
+        CodeDocument document;
+        document.replaceAllContent (text);
+
+        RecordingTokeniser tokeniser;
+        CodeEditorComponent editor (document, &tokeniser);
+        editor.setSize (500, 300);
+
+        beginTest ("Cached positions are valid");
+        expectCachedPositionsAreValid (editor, tokeniser);
+
+        beginTest ("Cached positions are still valid after inserting text");
+        {
+            document.insertText (CodeDocument::Position (document, 100, 0), "int y = 1;\n");
+            expectCachedPositionsAreValid (editor, tokeniser);
+
+            // retokenising should have caught up with the old token boundaries straight after the edit
+            const auto numTokens = getTokenBoundaries (document.getAllContent()).size();
+            expect (tokeniser.startPositions.size() < numTokens / 4);
+        }
+
+        beginTest ("Cached positions are still valid after deleting text");
+        {
+            document.deleteSection (CodeDocument::Position (document, 200, 0), CodeDocument::Position (document, 230, 5));
+            expectCachedPositionsAreValid (editor, tokeniser);
+        }
+
+        beginTest ("Cached positions are still valid after an edit that changes the following tokens");
+        {
+            // this turns the next few functions into a comment
+            document.insertText (CodeDocument::Position (document, 300, 0), "/* ");
+            expectCachedPositionsAreValid (editor, tokeniser);
+
+            document.deleteSection (CodeDocument::Position (document, 300, 0), CodeDocument::Position (document, 300, 3));
+            expectCachedPositionsAreValid (editor, tokeniser);
+        }
+
+        beginTest ("Cached positions are still valid after several edits");
+        {
+            auto r = getRandom();
+
+            for (int i = 0; i < 20; ++i)
+            {
+                const CodeDocument::Position pos (document, r.nextInt (document.getNumCharacters()));
+
+                if (r.nextBool())
+                    document.insertText (pos, r.nextBool() ? "\"quote " : "x = 2; // ");
+                else
+                    document.deleteSection (pos, pos.movedBy (r.nextInt (50)));
+
+                if (r.nextInt (3) == 0)
+                    expectCachedPositionsAreValid (editor, tokeniser);
+            }
+
+            expectCachedPositionsAreValid (editor, tokeniser);
+        }
+    }
+};
+
+static CodeEditorComponentTests codeEditorComponentUnitTests;
+
+#endif
+
 } // namespace juce
@@ -454,10 +454,13 @@ private:
     OwnedArray<CodeEditorLine> lines;
     void rebuildLineTokens();
     void rebuildLineTokensAsync();
-    void codeDocumentChanged (int start, int end);
+    void codeDocumentChanged (int start, int end, int lengthDelta);
 
     Array<CodeDocument::Iterator> cachedIterators;
+    Array<Array<int>> unconfirmedCachedPositions;
     void clearCachedIterators (int firstLineToBeInvalid);
+    void clearCachedIterators (int firstLineToBeInvalid, int firstUnchangedPosition, int lengthDelta);
+    bool confirmCachedPositions (const CodeDocument::Iterator&);
     void updateCachedIterators (int maxLineNum);
     void getIteratorForPosition (int position, CodeDocument::Iterator&);
 
@@ -126,6 +126,7 @@ struct CachedImageList final : public ReferenceCountedObject,
             {
                 textureNeedsReloading = false;
                 texture.loadImage (Image (*pixelData));
+                ++owner.numTextureUploads;
             }
 
             t.textureID = texture.getTextureID();
@@ -150,6 +151,9 @@ struct CachedImageList final : public ReferenceCountedObject,
 
     using Ptr = ReferenceCountedObjectPtr<CachedImageList>;
 
+    // This keeps counting for as long as the list exists, across many graphics contexts
+    int numTextureUploads = 0;
+
 private:
     OpenGLContext& context;
     OwnedArray<CachedImage> images;
@@ -218,6 +222,28 @@ private:
 };
 
 
+//==============================================================================
+// Holds on to the statistics of the last graphics context to finish drawing with an
+// OpenGLContext, so that they can be read after the context has gone.
+struct LastContextStatistics final : public ReferenceCountedObject
+{
+    static LastContextStatistics& get (OpenGLContext& c)
+    {
+        const char valueID[] = "GraphicsContextStatistics";
+        auto stats = static_cast<LastContextStatistics*> (c.getAssociatedObject (valueID));
+
+        if (stats == nullptr)
+        {
+            stats = new LastContextStatistics();
+            c.setAssociatedObject (valueID, stats);
+        }
+
+        return *stats;
+    }
+
+    OpenGLGraphicsContextStatistics statistics;
+};
+
 //==============================================================================
 struct Target
 {
@@ -963,6 +989,7 @@ struct StateHelpers
                 quadQueue.flush();
                 blendingEnabled = true;
                 glEnable (GL_BLEND);
+                ++numChanges;
             }
 
             if (srcFunction != src || dstFunction != dst)
@@ -971,6 +998,7 @@ struct StateHelpers
                 srcFunction = src;
                 dstFunction = dst;
                 glBlendFunc (src, dst);
+                ++numChanges;
             }
         }
 
@@ -982,6 +1010,7 @@ struct StateHelpers
                 quadQueue.flush();
                 blendingEnabled = false;
                 glDisable (GL_BLEND);
+                ++numChanges;
             }
         }
 
@@ -994,6 +1023,8 @@ struct StateHelpers
                 setPremultipliedBlendingMode (quadQueue);
         }
 
+        int numChanges = 0;
+
     private:
         bool blendingEnabled = false;
         GLenum srcFunction = 0, dstFunction = 0;
@@ -1016,24 +1047,24 @@ struct StateHelpers
         {
             auto c = colour;
             c.multiplyAlpha (alphaLevel);
-            quadQueue.add (x, currentY, 1, 1, c);
+            quadQueue.addRowSpan (x, currentY, 1, c);
         }
 
         void handleEdgeTablePixelFull (int x) noexcept
         {
-            quadQueue.add (x, currentY, 1, 1, colour);
+            quadQueue.addRowSpan (x, currentY, 1, colour);
         }
 
         void handleEdgeTableLine (int x, int width, int alphaLevel) noexcept
         {
             auto c = colour;
             c.multiplyAlpha (alphaLevel);
-            quadQueue.add (x, currentY, width, 1, c);
+            quadQueue.addRowSpan (x, currentY, width, c);
         }
 
         void handleEdgeTableLineFull (int x, int width) noexcept
         {
-            quadQueue.add (x, currentY, width, 1, colour);
+            quadQueue.addRowSpan (x, currentY, width, colour);
         }
 
         void handleEdgeTableRectangle (int x, int y, int width, int height, int alphaLevel) noexcept
@@ -1127,6 +1158,7 @@ struct StateHelpers
                 }
 
                 texturesEnabled = textureIndexMask;
+                ++numChanges;
             }
         }
 
@@ -1189,6 +1221,7 @@ struct StateHelpers
                 currentTextureID[currentActiveTexture] = textureID;
                 glBindTexture (GL_TEXTURE_2D, textureID);
                 JUCE_CHECK_OPENGL_ERROR
+                ++numChanges;
             }
             else
             {
@@ -1200,6 +1233,8 @@ struct StateHelpers
             }
         }
 
+        int numChanges = 0;
+
     private:
         static constexpr auto numTextures = 3;
         GLuint currentTextureID[numTextures];
@@ -1260,6 +1295,7 @@ struct StateHelpers
                 PixelARGB lookup[gradientTextureSize];
                 gradient.createLookupTable (lookup);
                 gradientTextures.getUnchecked (activeGradientIndex)->loadARGB (lookup, gradientTextureSize, 1);
+                ++numUploads;
             }
 
             activeTextures.bindTexture (gradientTextures.getUnchecked (activeGradientIndex)->getTextureID());
@@ -1267,6 +1303,8 @@ struct StateHelpers
 
         enum { gradientTextureSize = 256 };
 
+        int numUploads = 0;
+
     private:
         enum { numTexturesToCache = 8, numGradientTexturesToCache = 10 };
         OwnedArray<OpenGLTexture> textures, gradientTextures;
@@ -1310,7 +1348,7 @@ struct StateHelpers
             context.extensions.glBufferData (GL_ELEMENT_ARRAY_BUFFER, sizeof (indexData), indexData, GL_STATIC_DRAW);
 
             savedArrayBuffer.bind();
-            context.extensions.glBufferData (GL_ARRAY_BUFFER, sizeof (vertexData), vertexData, GL_STREAM_DRAW);
+            context.extensions.glBufferData (GL_ARRAY_BUFFER, sizeof (vertexData), nullptr, GL_STREAM_DRAW);
             JUCE_CHECK_OPENGL_ERROR
         }
 
@@ -1324,13 +1362,7 @@ struct StateHelpers
             v[1].x = v[3].x = (GLshort) (x + w);
             v[2].y = v[3].y = (GLshort) (y + h);
 
-           #if JUCE_BIG_ENDIAN
-            auto rgba = (GLuint) ((colour.getRed() << 24) | (colour.getGreen() << 16)
-                                | (colour.getBlue() << 8) |  colour.getAlpha());
-           #else
-            auto rgba = (GLuint) ((colour.getAlpha() << 24) | (colour.getBlue() << 16)
-                                | (colour.getGreen() << 8) |  colour.getRed());
-           #endif
+            auto rgba = getVertexColour (colour);
 
             v[0].colour = rgba;
             v[1].colour = rgba;
@@ -1371,9 +1403,56 @@ struct StateHelpers
             }
         }
 
+        /*  Adds a one-pixel-high span belonging to the shape that's currently being added.
+
+            If the row above contained a span with the same extent and colour, its quad is
+            stretched down to cover this one instead. Spans within a shape never overlap, so it
+            doesn't matter that this changes the order in which they get drawn.
+        */
+        void addRowSpan (int x, int y, int w, PixelARGB colour) noexcept
+        {
+            if (y != currentRowY)
+            {
+                if (y == currentRowY + 1)
+                    std::swap (previousRowQuads, currentRowQuads);
+                else
+                    previousRowQuads.clearQuick();
+
+                currentRowQuads.clearQuick();
+                currentRowY = y;
+                nextPreviousRowQuad = 0;
+            }
+
+            auto rgba = getVertexColour (colour);
+
+            // Both rows are iterated from left to right, so the previous row's quads only
+            // need to be scanned once
+            while (nextPreviousRowQuad < previousRowQuads.size())
+            {
+                auto quadIndex = previousRowQuads.getUnchecked (nextPreviousRowQuad);
+                auto* v = vertexData + quadIndex * 4;
+
+                if (v[0].x > x)
+                    break;
+
+                ++nextPreviousRowQuad;
+
+                if (v[0].x == x && v[1].x == x + w && v[2].y == y && v[0].colour == rgba)
+                {
+                    v[2].y = v[3].y = (GLshort) (y + 1);
+                    currentRowQuads.add (quadIndex);
+                    return;
+                }
+            }
+
+            currentRowQuads.add (numVertices / 4);
+            add (x, y, w, 1, colour);
+        }
+
         template <typename IteratorType>
         void add (const IteratorType& et, PixelARGB colour)
         {
+            startNewShape();
             EdgeTableRenderer<ShaderQuadQueue> etr (*this, colour);
             et.iterate (etr);
         }
@@ -1384,6 +1463,8 @@ struct StateHelpers
                 draw();
         }
 
+        int numDrawCalls = 0;
+
     private:
         struct VertexInfo
         {
@@ -1391,7 +1472,8 @@ struct StateHelpers
             GLuint colour;
         };
 
-        enum { maxNumQuads = 256 };
+        // The vertex indices are 16-bit, so this can't be more than 16384
+        enum { maxNumQuads = 4096 };
 
         SavedBinding<TraitsArrayBuffer> savedArrayBuffer;
         SavedBinding<TraitsElementArrayBuffer> savedElementArrayBuffer;
@@ -1400,12 +1482,33 @@ struct StateHelpers
         const OpenGLContext& context;
         int numVertices = 0;
 
+        Array<int> previousRowQuads, currentRowQuads;
+        int currentRowY = 0, nextPreviousRowQuad = 0;
+
        #if JUCE_ANDROID || JUCE_IOS
         enum { maxVertices = maxNumQuads * 4 - 4 };
        #else
         int maxVertices = 0;
        #endif
 
+        static GLuint getVertexColour (PixelARGB colour) noexcept
+        {
+           #if JUCE_BIG_ENDIAN
+            return (GLuint) ((colour.getRed() << 24) | (colour.getGreen() << 16)
+                           | (colour.getBlue() << 8) |  colour.getAlpha());
+           #else
+            return (GLuint) ((colour.getAlpha() << 24) | (colour.getBlue() << 16)
+                           | (colour.getGreen() << 8) |  colour.getRed());
+           #endif
+        }
+
+        void startNewShape() noexcept
+        {
+            previousRowQuads.clearQuick();
+            currentRowQuads.clearQuick();
+            nextPreviousRowQuad = 0;
+        }
+
         void draw() noexcept
         {
             context.extensions.glBufferSubData (GL_ARRAY_BUFFER, 0, (GLsizeiptr) ((size_t) numVertices * sizeof (VertexInfo)), vertexData);
@@ -1413,7 +1516,9 @@ struct StateHelpers
             // their driver.. Can't find a workaround unfortunately.
             glDrawElements (GL_TRIANGLES, (numVertices * 3) / 2, GL_UNSIGNED_SHORT, nullptr);
             JUCE_CHECK_OPENGL_ERROR
+            ++numDrawCalls;
             numVertices = 0;
+            startNewShape();
         }
 
         JUCE_DECLARE_NON_COPYABLE (ShaderQuadQueue)
@@ -1448,6 +1553,7 @@ struct StateHelpers
                 activeShader = &shader;
                 shader.program.use();
                 shader.bindAttributes();
+                ++numChanges;
 
                 if (shader.onShaderActivated)
                     shader.onShaderActivated (shader.program);
@@ -1482,6 +1588,7 @@ struct StateHelpers
 
         OpenGLContext& context;
         ShaderPrograms::Ptr programs;
+        int numChanges = 0;
 
     private:
         ShaderPrograms::ShaderBase* activeShader = nullptr;
@@ -1511,15 +1618,26 @@ struct GLState
         activeTextures.clear();
         shaderQuadQueue.initialise();
         cachedImageList = CachedImageList::get (t.context);
+        numImageUploadsAtStart = cachedImageList->numTextureUploads;
         JUCE_CHECK_OPENGL_ERROR
     }
 
     ~GLState()
     {
         flush();
+        LastContextStatistics::get (target.context).statistics = getStatistics();
         target.context.extensions.glBindFramebuffer (GL_FRAMEBUFFER, previousFrameBufferTarget);
     }
 
+    OpenGLGraphicsContextStatistics getStatistics() const noexcept
+    {
+        OpenGLGraphicsContextStatistics s;
+        s.numDrawCalls = shaderQuadQueue.numDrawCalls;
+        s.numStateChanges = blendMode.numChanges + activeTextures.numChanges + currentShader.numChanges;
+        s.numTextureUploads = textureCache.numUploads + cachedImageList->numTextureUploads - numImageUploadsAtStart;
+        return s;
+    }
+
     void flush()
     {
         shaderQuadQueue.flush();
@@ -1697,6 +1815,7 @@ struct GLState
 private:
     GLuint previousFrameBufferTarget;
     SavedBinding<TraitsVAO> savedVAOBinding;
+    int numImageUploadsAtStart = 0;
 };
 
 //==============================================================================
@@ -1924,6 +2043,11 @@ std::unique_ptr<LowLevelGraphicsContext> createOpenGLGraphicsContext (OpenGLCont
     return OpenGLRendering::createOpenGLContext (OpenGLRendering::Target (context, frameBufferID, width, height));
 }
 
+OpenGLGraphicsContextStatistics getOpenGLGraphicsContextStatistics (OpenGLContext& context)
+{
+    return OpenGLRendering::LastContextStatistics::get (context).statistics;
+}
+
 //==============================================================================
 struct CustomProgram final : public ReferenceCountedObject,
                              public OpenGLRendering::ShaderPrograms::ShaderBase
@@ -48,6 +48,38 @@ std::unique_ptr<LowLevelGraphicsContext> createOpenGLGraphicsContext (OpenGLCont
                                                                       unsigned int frameBufferID,
                                                                       int width, int height);
 
+//==============================================================================
+/**
+    Counts the work that an OpenGL graphics context did while it was drawing.
+
+    @see getOpenGLGraphicsContextStatistics
+
+    @tags{OpenGL}
+*/
+struct JUCE_API  OpenGLGraphicsContextStatistics
+{
+    /** The number of batches of quads that were submitted with glDrawElements. */
+    int numDrawCalls = 0;
+
+    /** The number of times the shader program, the blending mode or a bound texture changed. */
+    int numStateChanges = 0;
+
+    /** The number of times an image or a gradient was copied into a texture. */
+    int numTextureUploads = 0;
+};
+
+/** Returns the statistics of the most recently deleted graphics context that was drawing
+    with this OpenGLContext.
+
+    An OpenGLContext that's attached to a component creates a new graphics context to paint
+    each frame, so calling this from OpenGLRenderer::renderOpenGL() tells you what it cost to
+    paint the previous frame. Contexts that fall back to software rendering aren't counted.
+
+    Like OpenGLContext::getAssociatedObject(), this must only be called from an OpenGL
+    rendering callback.
+*/
+OpenGLGraphicsContextStatistics getOpenGLGraphicsContextStatistics (OpenGLContext&);
+
 
 //==============================================================================
 /**
@@ -63,6 +63,10 @@ public:
 
     std::unique_ptr<ImageType> createType() const override     { return std::make_unique<OpenGLImageType>(); }
 
+    // We can't tell when an OpenGL context has finished drawing into us, so a cached
+    // copy could be made from a half-drawn image
+    Image getReducedImage (int) override                        { return {}; }
+
     ImagePixelData::Ptr clone() override
     {
         std::unique_ptr<OpenGLFrameBufferImage> im (new OpenGLFrameBufferImage (context, width, height));